@@ -17,6 +17,22 @@ struct Window;
  */
 typedef struct Canvas Canvas;
 
+/**
+ * @brief How drawn colors combine with the pixels already on a canvas
+ */
+typedef enum {
+    /** Straight alpha: result = src * a + dst * (1 - a) on the color channels,
+     *  as the renderer backends blend, and a + dst_a * (1 - a) on alpha, so
+     *  opaque pixels stay opaque. Exact over opaque pixels. The default. */
+    CANVAS_BLEND_SOURCE_OVER,
+    /** The canvas holds premultiplied pixels: result = src + dst * (1 - a).
+     *  Colors passed in stay straight and are premultiplied on the way in.
+     *  Correct over translucent pixels too, e.g. when drawing into a layer. */
+    CANVAS_BLEND_PREMULTIPLIED,
+    /** Drawn pixels overwrite the canvas, alpha included */
+    CANVAS_BLEND_REPLACE
+} CanvasBlendMode;
+
 /**
  * @brief Create a new canvas
  * 
@@ -36,6 +52,9 @@ void canvas_destroy(Canvas* canvas);
 /**
  * @brief Clear the canvas with a color
  * 
+ * Every pixel is overwritten regardless of the blend mode and the clip; in
+ * CANVAS_BLEND_PREMULTIPLIED mode the color is stored premultiplied.
+ * 
  * @param canvas Canvas to clear
  * @param color Color to clear with
  */
@@ -44,6 +63,8 @@ void canvas_clear(Canvas* canvas, Color color);
 /**
  * @brief Set a pixel on the canvas
  * 
+ * Pixels outside the active clip are left alone.
+ * 
  * @param canvas Canvas to set pixel on
  * @param x X coordinate
  * @param y Y coordinate
@@ -61,6 +82,52 @@ void canvas_set_pixel(Canvas* canvas, int x, int y, Color color);
  */
 Color canvas_get_pixel(const Canvas* canvas, int x, int y);
 
+/**
+ * @brief Fill a rectangle on the canvas
+ *
+ * The rectangle is clipped to the active clip once and then written a row at a
+ * time with vector stores, so this is much cheaper than setting its pixels
+ * one by one. The color is combined with the canvas using its blend mode;
+ * fully opaque colors are stored directly in every mode.
+ *
+ * @param canvas Canvas to fill on
+ * @param x X coordinate of top-left corner
+ * @param y Y coordinate of top-left corner
+ * @param width Width of the rectangle (nothing is drawn if <= 0)
+ * @param height Height of the rectangle (nothing is drawn if <= 0)
+ * @param color Color to fill with
+ */
+void canvas_fill_rect(Canvas* canvas, int x, int y, int width, int height, Color color);
+
+/**
+ * @brief Fill a horizontal run of pixels on the canvas
+ *
+ * Equivalent to canvas_fill_rect with a height of 1.
+ *
+ * @param canvas Canvas to fill on
+ * @param x X coordinate of the leftmost pixel
+ * @param y Y coordinate of the row
+ * @param width Number of pixels (nothing is drawn if <= 0)
+ * @param color Color to fill with
+ */
+void canvas_fill_span(Canvas* canvas, int x, int y, int width, Color color);
+
+/**
+ * @brief Fill a horizontal run of pixels with per-pixel coverage
+ *
+ * Pixel x + i is drawn with the color's alpha scaled by coverage[i] / 255,
+ * then combined with the canvas using its blend mode. Used for the
+ * anti-aliased edges of the primitives.
+ *
+ * @param canvas Canvas to fill on
+ * @param x X coordinate of the leftmost pixel
+ * @param y Y coordinate of the row
+ * @param width Number of pixels (nothing is drawn if <= 0)
+ * @param coverage width coverage values, 255 for full coverage
+ * @param color Color to fill with
+ */
+void canvas_fill_span_coverage(Canvas* canvas, int x, int y, int width, const uint8_t* coverage, Color color);
+
 /**
  * @brief Get canvas width
  * 
@@ -85,6 +152,123 @@ int canvas_get_height(const Canvas* canvas);
  */
 const uint32_t* canvas_get_data(const Canvas* canvas);
 
+/**
+ * @brief Get writable canvas pixel data
+ * 
+ * Pixels are stored row by row (width pixels per row) in the
+ * color_to_uint32 packing.
+ * 
+ * @param canvas Canvas to get data from
+ * @return uint32_t* Canvas pixel data, NULL if canvas is NULL
+ */
+uint32_t* canvas_get_mutable_data(Canvas* canvas);
+
+/**
+ * @brief Set how drawing combines colors with the canvas
+ * 
+ * Applies to canvas_fill_rect, canvas_fill_span, canvas_draw_canvas and
+ * every primitives.h function. canvas_set_pixel always overwrites.
+ * 
+ * @param canvas Canvas to set the blend mode of
+ * @param mode Blend mode, CANVAS_BLEND_SOURCE_OVER initially
+ */
+void canvas_set_blend_mode(Canvas* canvas, CanvasBlendMode mode);
+
+/**
+ * @brief Get the blend mode of a canvas
+ * 
+ * @param canvas Canvas to get the blend mode of
+ * @return CanvasBlendMode Current blend mode
+ */
+CanvasBlendMode canvas_get_blend_mode(const Canvas* canvas);
+
+/**
+ * @brief Set the drawing origin of a canvas
+ * 
+ * Drawing coordinates are offset by the origin: drawing at (x, y) touches
+ * pixel (x - origin_x, y - origin_y). Setting the origin to a widget's
+ * position lets a canvas the size of the widget hold its drawing. Does not
+ * affect canvas_clear or the raw pixel data. The origin starts at (0, 0).
+ * 
+ * @param canvas Canvas to set the origin of
+ * @param origin_x Drawing X coordinate that maps to pixel column 0
+ * @param origin_y Drawing Y coordinate that maps to pixel row 0
+ */
+void canvas_set_origin(Canvas* canvas, int origin_x, int origin_y);
+
+/**
+ * @brief Push a clip rectangle
+ * 
+ * Until it is popped, drawing (canvas_set_pixel, the fill functions,
+ * canvas_draw_canvas and every primitives.h function) only touches pixels
+ * inside it. The new clip is intersected with the active one, so nested
+ * clips only narrow, and with the canvas. It is given in drawing
+ * coordinates and fixed in pixels with the origin in effect when pushed.
+ * 
+ * @param canvas Canvas to clip
+ * @param x X coordinate of top-left corner
+ * @param y Y coordinate of top-left corner
+ * @param width Width of the clip rectangle
+ * @param height Height of the clip rectangle
+ * @return int Nonzero on success; on failure (out of memory) nothing was
+ *         pushed and canvas_pop_clip must not be called for it
+ */
+int canvas_push_clip(Canvas* canvas, int x, int y, int width, int height);
+
+/**
+ * @brief Pop the clip rectangle pushed last, restoring the one before it
+ * 
+ * @param canvas Canvas to pop the clip of (nothing happens if none is pushed)
+ */
+void canvas_pop_clip(Canvas* canvas);
+
+/**
+ * @brief Get the active clip rectangle in drawing coordinates
+ * 
+ * This is the whole canvas when no clip is pushed. Any output pointer may
+ * be NULL.
+ * 
+ * @param canvas Canvas to get the clip of
+ * @param x Receives the X coordinate of the top-left corner
+ * @param y Receives the Y coordinate of the top-left corner
+ * @param width Receives the width
+ * @param height Receives the height
+ * @return int Nonzero if the clip contains any pixel
+ */
+int canvas_get_clip(const Canvas* canvas, int* x, int* y, int* width, int* height);
+
+/**
+ * @brief Draw one canvas onto another
+ * 
+ * Source pixels are combined with the destination by the destination's
+ * blend mode, so in CANVAS_BLEND_PREMULTIPLIED mode the source must hold
+ * premultiplied pixels too. Fully transparent pixels leave it untouched
+ * except in CANVAS_BLEND_REPLACE mode, which copies the source.
+ * 
+ * @param canvas Canvas to draw on
+ * @param source Canvas to draw (its origin is ignored)
+ * @param x X coordinate of the source's top-left corner
+ * @param y Y coordinate of the source's top-left corner
+ */
+void canvas_draw_canvas(Canvas* canvas, const Canvas* source, int x, int y);
+
+/**
+ * @brief Draw a canvas holding premultiplied pixels onto another
+ * 
+ * For sources drawn in CANVAS_BLEND_PREMULTIPLIED mode, such as container
+ * layers. The result is src + dst * (1 - a) on all four channels in the
+ * CANVAS_BLEND_SOURCE_OVER and CANVAS_BLEND_PREMULTIPLIED modes, which over
+ * opaque pixels matches drawing the source's content directly. In
+ * CANVAS_BLEND_REPLACE mode the source is copied with its colors converted
+ * back to straight alpha.
+ * 
+ * @param canvas Canvas to draw on
+ * @param source Premultiplied canvas to draw (its origin is ignored)
+ * @param x X coordinate of the source's top-left corner
+ * @param y Y coordinate of the source's top-left corner
+ */
+void canvas_draw_canvas_premultiplied(Canvas* canvas, const Canvas* source, int x, int y);
+
 /**
  * @brief Render the canvas to a window
  * 
@@ -9,6 +9,15 @@
 #include "canvas.h"
 #include "color.h"
 
+/**
+ * @brief How draw_thick_line_aa finishes the ends of a line
+ */
+typedef enum {
+    LINE_CAP_BUTT,   /**< Square, exactly at the end points */
+    LINE_CAP_SQUARE, /**< Square, half the line width past the end points */
+    LINE_CAP_ROUND   /**< Semicircles centered on the end points */
+} LineCap;
+
 /**
  * @brief Draw a pixel on a canvas
  * 
@@ -22,6 +31,9 @@ void draw_pixel(Canvas* canvas, int x, int y, Color color);
 /**
  * @brief Draw a line on a canvas
  * 
+ * The line is clipped to the canvas's active clip before it is walked, so
+ * its cost depends on the part that is visible, not on its full length.
+ * 
  * @param canvas Canvas to draw on
  * @param x1 X coordinate of start point
  * @param y1 Y coordinate of start point
@@ -101,6 +113,91 @@ void draw_ellipse(Canvas* canvas, int x, int y, int radiusX, int radiusY, Color
  */
 void draw_filled_ellipse(Canvas* canvas, int x, int y, int radiusX, int radiusY, Color color);
 
+/*
+ * Anti-aliased primitives. Coordinates are floats naming pixel centers, as in
+ * the integer functions: (x, y) is the middle of pixel (x, y). Edge pixels
+ * are blended by the fraction of them the shape covers.
+ */
+
+/**
+ * @brief Draw an anti-aliased one-pixel line on a canvas
+ * 
+ * Xiaolin Wu's method: each step along the line shares its ink between the
+ * two nearest pixels across it, and the end pixels are weighted by how much
+ * of them the line spans.
+ * 
+ * @param canvas Canvas to draw on
+ * @param x1 X coordinate of start point
+ * @param y1 Y coordinate of start point
+ * @param x2 X coordinate of end point
+ * @param y2 Y coordinate of end point
+ * @param color Color to draw with
+ */
+void draw_line_aa(Canvas* canvas, float x1, float y1, float x2, float y2, Color color);
+
+/**
+ * @brief Draw an anti-aliased line of any width on a canvas
+ * 
+ * @param canvas Canvas to draw on
+ * @param x1 X coordinate of start point
+ * @param y1 Y coordinate of start point
+ * @param x2 X coordinate of end point
+ * @param y2 Y coordinate of end point
+ * @param width Line width (nothing is drawn if <= 0)
+ * @param cap How the ends are finished
+ * @param color Color to draw with
+ */
+void draw_thick_line_aa(Canvas* canvas, float x1, float y1, float x2, float y2, float width, LineCap cap,
+                        Color color);
+
+/**
+ * @brief Draw an anti-aliased circle outline on a canvas
+ * 
+ * @param canvas Canvas to draw on
+ * @param x X coordinate of center
+ * @param y Y coordinate of center
+ * @param radius Radius of the circle, to the middle of the outline
+ * @param width Outline width (nothing is drawn if <= 0)
+ * @param color Color to draw with
+ */
+void draw_circle_aa(Canvas* canvas, float x, float y, float radius, float width, Color color);
+
+/**
+ * @brief Draw an anti-aliased ellipse outline on a canvas
+ * 
+ * @param canvas Canvas to draw on
+ * @param x X coordinate of center
+ * @param y Y coordinate of center
+ * @param radiusX X radius of the ellipse, to the middle of the outline
+ * @param radiusY Y radius of the ellipse, to the middle of the outline
+ * @param width Outline width (nothing is drawn if <= 0)
+ * @param color Color to draw with
+ */
+void draw_ellipse_aa(Canvas* canvas, float x, float y, float radiusX, float radiusY, float width, Color color);
+
+/**
+ * @brief Draw an anti-aliased filled circle on a canvas
+ * 
+ * @param canvas Canvas to draw on
+ * @param x X coordinate of center
+ * @param y Y coordinate of center
+ * @param radius Radius of the circle (nothing is drawn if <= 0)
+ * @param color Color to draw with
+ */
+void draw_filled_circle_aa(Canvas* canvas, float x, float y, float radius, Color color);
+
+/**
+ * @brief Draw an anti-aliased filled ellipse on a canvas
+ * 
+ * @param canvas Canvas to draw on
+ * @param x X coordinate of center
+ * @param y Y coordinate of center
+ * @param radiusX X radius of the ellipse (nothing is drawn if <= 0)
+ * @param radiusY Y radius of the ellipse (nothing is drawn if <= 0)
+ * @param color Color to draw with
+ */
+void draw_filled_ellipse_aa(Canvas* canvas, float x, float y, float radiusX, float radiusY, Color color);
+
 /**
  * @brief Draw text on a canvas
  * 
@@ -0,0 +1,100 @@
+#ifndef PAL_ATLAS_H
+#define PAL_ATLAS_H
+
+#include "pal_renderer.h"
+#include <stdbool.h>
+#include <stddef.h> // For size_t
+#include <stdint.h> // For uint32_t
+
+// --- Texture Atlas --- //
+// Packs many small images (icons, glyphs, thumbnails) into a few large
+// renderer textures ("pages") so they can share a texture and be drawn in a
+// single batch. Images are placed with a skyline packer and uploaded
+// incrementally as sub-rectangles. When every page is full, the atlas first
+// defragments the page with the most freed space, and failing that evicts the
+// least recently used page (invalidating its handles).
+//
+// Built purely on the public pal_renderer API, so it works with any backend.
+
+typedef struct PAL_Atlas PAL_Atlas;
+
+// Handle to an image stored in the atlas. Stays valid until the image is
+// removed or its page is evicted; pal_atlas_get_region reports which.
+typedef uint32_t PAL_AtlasHandle;
+#define PAL_ATLAS_INVALID_HANDLE 0u
+
+typedef struct {
+    int page_width;  // Default 1024
+    int page_height; // Default 1024
+    int max_pages;   // Default 4
+    int padding;     // Empty pixels around each image to avoid filtering bleed. Default 1
+} PAL_AtlasConfig;
+
+// Where an image currently lives. Pass texture and UVs straight to
+// pal_renderer_render_textured_quad / PAL_Vertex.
+typedef struct {
+    PAL_TextureHandle texture;
+    float u0, v0, u1, v1;
+    int x, y, width, height; // Pixel rect within the page
+} PAL_AtlasRegion;
+
+typedef struct {
+    int page_count;
+    int entry_count;
+    size_t used_pixels;  // Pixels covered by live images (excluding padding)
+    size_t total_pixels; // Pixels across all allocated pages
+    uint32_t defragmentations;
+    uint32_t evictions;  // Pages evicted since creation
+} PAL_AtlasStats;
+
+/**
+ * @brief Creates an atlas that allocates its pages from the given renderer.
+ * @param renderer The renderer that owns the page textures.
+ * @param config Atlas configuration, or NULL for defaults.
+ * @return The atlas, or NULL on failure.
+ */
+PAL_Atlas* pal_atlas_create(PAL_Renderer* renderer, const PAL_AtlasConfig* config);
+
+/**
+ * @brief Destroys the atlas and all of its page textures.
+ * @param atlas The atlas.
+ */
+void pal_atlas_destroy(PAL_Atlas* atlas);
+
+/**
+ * @brief Copies an image into the atlas.
+ * @param atlas The atlas.
+ * @param width Image width (must fit in a page including padding).
+ * @param height Image height.
+ * @param pixels 32-bit pixels in the same format as pal_renderer_create_texture.
+ * @param stride_bytes Bytes per source row, or 0 for tightly packed rows.
+ * @return A handle to the image, or PAL_ATLAS_INVALID_HANDLE on failure.
+ */
+PAL_AtlasHandle pal_atlas_add(PAL_Atlas* atlas, int width, int height, const void* pixels, int stride_bytes);
+
+/**
+ * @brief Looks up where an image currently lives and marks its page as used.
+ *        Regions can move when a page is defragmented, so look them up each
+ *        frame rather than caching them.
+ * @param atlas The atlas.
+ * @param handle The image handle.
+ * @param region Receives the texture and UV rect.
+ * @return false if the handle was removed or evicted (re-add the image).
+ */
+bool pal_atlas_get_region(PAL_Atlas* atlas, PAL_AtlasHandle handle, PAL_AtlasRegion* region);
+
+/**
+ * @brief Removes an image. Its space is reclaimed on the next defragmentation.
+ * @param atlas The atlas.
+ * @param handle The image handle.
+ */
+void pal_atlas_remove(PAL_Atlas* atlas, PAL_AtlasHandle handle);
+
+/**
+ * @brief Gets occupancy and maintenance counters.
+ * @param atlas The atlas.
+ * @param stats Receives the statistics.
+ */
+void pal_atlas_get_stats(const PAL_Atlas* atlas, PAL_AtlasStats* stats);
+
+#endif // PAL_ATLAS_H
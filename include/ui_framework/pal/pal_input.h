@@ -42,13 +42,41 @@ typedef enum {
  *        This should be called once per frame, typically at the beginning.
  *        It updates the internal input state queried by other functions
  *        and importantly, signals the window if a quit event occurs.
- * @param window The window context (needed to signal should_close).
+ *        Events of every open window are handled in one call and routed to
+ *        the window they belong to (close requests, exposure, mouse and
+ *        text input), so multi-window applications call it once per frame.
+ * @param window Any open window; kept for compatibility and may be NULL.
  */
 void pal_input_poll_events(PAL_Window* window);
 
+/**
+ * @brief Sleeps until a platform event arrives, then processes events like
+ *        pal_input_poll_events. Use instead of polling when the UI is idle
+ *        (e.g. the renderer had no damage) so a static screen costs no CPU.
+ * @param window Any open window; may be NULL.
+ * @param timeout_ms Maximum time to wait in milliseconds, or -1 to wait indefinitely.
+ * @return true if an event arrived, false on timeout.
+ */
+bool pal_input_wait_events(PAL_Window* window, int timeout_ms);
+
 // --- Input State Queries --- //
+// Mouse queries report on the window under the pointer (or the last one it
+// was over), text input on the window with keyboard focus. Applications with
+// several windows compare these with their window before acting on input.
+
+/**
+ * @brief Gets the window under the mouse pointer.
+ * @return The window, or NULL if the pointer is outside every window.
+ */
+PAL_Window* pal_input_get_mouse_window(void);
+
+/**
+ * @brief Gets the window with keyboard focus, which key and text input is aimed at.
+ * @return The window, or NULL if none of the application's windows has focus.
+ */
+PAL_Window* pal_input_get_keyboard_window(void);
 
-// Mouse
+// Mouse (position in the coordinates of the window being reported on)
 void pal_input_get_mouse_pos(int* x, int* y);
 bool pal_input_is_mouse_button_down(PAL_MouseButton button);
 bool pal_input_is_mouse_button_pressed(PAL_MouseButton button); // Pressed this frame
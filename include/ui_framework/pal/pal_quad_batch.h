@@ -0,0 +1,40 @@
+#ifndef PAL_QUAD_BATCH_H
+#define PAL_QUAD_BATCH_H
+
+#include "pal_renderer.h"
+#include <stddef.h> // For size_t
+#include <stdint.h> // For uint32_t
+
+// --- Quad Batch Vertex Writers --- //
+// Turn arrays of PAL_QuadRect / PAL_QuadUV / packed colors into vertices for
+// the renderer's submission functions. Each quad is assembled in a few vector
+// registers and written with whole-register stores (SSE2 on x86, NEON on ARM,
+// plain C elsewhere), instead of field by field.
+//
+// uvs may be NULL for the whole texture (0,0)-(1,1) and colors NULL for white.
+// out must have room for the written vertices; it needs no particular alignment.
+
+/**
+ * @brief Writes 4 vertices per quad in pal_renderer_render_quads order
+ *        (top-left, top-right, bottom-right, bottom-left).
+ */
+void pal_quad_batch_write_quads(PAL_Vertex* out, const PAL_QuadRect* rects, const PAL_QuadUV* uvs,
+                                const uint32_t* colors, size_t quad_count);
+
+/**
+ * @brief Writes 6 vertices per quad, two triangles (top-left, top-right,
+ *        bottom-right) and (top-left, bottom-right, bottom-left), for
+ *        pal_renderer_render_triangles.
+ */
+void pal_quad_batch_write_triangles(PAL_Vertex* out, const PAL_QuadRect* rects, const PAL_QuadUV* uvs,
+                                    const uint32_t* colors, size_t quad_count);
+
+/**
+ * @brief Compact-vertex variant of pal_quad_batch_write_quads. Positions
+ *        and texture coordinates are rounded and clamped to the compact
+ *        ranges exactly as the renderer converts PAL_Vertex input.
+ */
+void pal_quad_batch_write_quads_compact(PAL_VertexCompact* out, const PAL_QuadRect* rects, const PAL_QuadUV* uvs,
+                                        const uint32_t* colors, size_t quad_count);
+
+#endif // PAL_QUAD_BATCH_H
@@ -16,6 +16,162 @@ typedef struct {
     uint32_t color; // Color (e.g., 0xAABBGGRR or 0xAARRGGBB depending on backend needs)
 } PAL_Vertex;
 
+// --- Compact Vertex Structure --- //
+// 12-byte alternative to PAL_Vertex for pixel-aligned UI geometry.
+// Positions are signed fixed point with PAL_COMPACT_VERTEX_SUBPIXEL_BITS
+// fractional bits (quarter-pixel precision, range +/-8191 pixels).
+// Texture coordinates are normalized: 0 maps to 0.0, 65535 maps to 1.0.
+#define PAL_COMPACT_VERTEX_SUBPIXEL_BITS 2
+
+typedef struct {
+    int16_t x, y;    // Position (fixed point)
+    uint16_t u, v;   // Texture Coordinates (normalized)
+    uint32_t color;  // Color (same packing as PAL_Vertex)
+} PAL_VertexCompact;
+
+// Vertex layout used by the renderer's draw list and GPU vertex buffer.
+// Submissions in the other layout are converted when recorded.
+typedef enum {
+    PAL_VERTEX_FORMAT_STANDARD, // PAL_Vertex, 20 bytes
+    PAL_VERTEX_FORMAT_COMPACT   // PAL_VertexCompact, 12 bytes
+} PAL_VertexFormat;
+
+// --- Rectangle Instance --- //
+// One styled rectangle for the SDF rectangle pipeline (48 bytes). The GPU
+// evaluates rounded corners, border, drop shadow and anti-aliased edges per
+// pixel, so no tessellated geometry is needed. Colors use the same packing as
+// PAL_Vertex.color (see color_to_uint32). A shadow is drawn if shadow_color
+// has non-zero alpha.
+typedef struct {
+    float x, y, width, height; // Rectangle (top-left origin, pixels)
+    float corner_radius;       // Clamped to half the smaller side
+    float border_width;        // 0 for no border
+    float shadow_blur;         // Shadow edge softness in pixels (0 = hard edge)
+    uint32_t fill_color;
+    uint32_t border_color;
+    uint32_t shadow_color;
+    float shadow_offset_x, shadow_offset_y;
+} PAL_RectInstance;
+
+// --- Quad Batch Input --- //
+// Per-quad input for pal_renderer_render_quad_batch and the vertex writers in
+// pal_quad_batch.h: a screen rectangle, the texture area it shows and a color.
+typedef struct {
+    float x, y, width, height; // Top-left origin, pixels
+} PAL_QuadRect;
+
+typedef struct {
+    float u0, v0; // Texture coordinates at the top-left corner
+    float u1, v1; // And at the bottom-right corner
+} PAL_QuadUV;
+
+// --- Configuration --- //
+
+typedef struct {
+    PAL_VertexFormat vertex_format;
+    size_t texture_budget_bytes; // Resident texture memory target; 0 for unlimited (see pal_renderer_set_texture_budget)
+    bool damage_tracking;        // Redraw only damaged areas and skip unchanged frames (see pal_renderer_add_damage)
+    bool render_thread;          // Issue GL calls on a dedicated thread (see pal_renderer_end_frame); window renderers only
+    const char* program_cache_dir; // Existing directory where linked shader programs are kept between launches; NULL to always compile
+} PAL_RendererConfig;
+
+// --- Statistics --- //
+
+typedef struct {
+    uint32_t draw_calls;            // GL draw calls issued
+    uint32_t vertices;              // Vertices submitted to the GPU
+    uint32_t indices;               // Indices consumed by indexed draws
+    uint32_t rect_instances;        // SDF rectangles drawn
+    uint32_t state_changes;         // GL state calls (binds, scissor, uniforms) issued
+    uint32_t state_changes_skipped; // Redundant GL state calls avoided by the state cache
+    uint32_t upload_bytes;          // Texel bytes staged for texture updates
+} PAL_RendererStats;
+
+// Measured presentation timing over the last PAL_FRAME_TIMING_HISTORY frames.
+// Intervals are between consecutive presents; frames skipped by damage
+// tracking start a new measurement rather than counting as long intervals.
+#define PAL_FRAME_TIMING_HISTORY 120
+
+typedef struct {
+    PAL_PresentMode present_mode;
+    float refresh_interval_ms; // Display refresh period the pacer targets
+    float last_interval_ms;
+    float average_interval_ms;
+    float min_interval_ms;
+    float max_interval_ms;
+    float average_work_ms;     // begin_frame to present, excluding waits for vblank where measurable
+    uint32_t samples;          // Intervals in the history (0 until two frames were presented)
+} PAL_FrameTiming;
+
+// Texture memory, as tracked by the renderer's texture registry
+typedef struct {
+    uint32_t texture_count;  // Live texture handles
+    uint32_t resident_count; // Handles currently holding GPU storage
+    size_t resident_bytes;   // GPU memory held by resident textures
+    size_t purgeable_bytes;  // Part of resident_bytes that may be evicted
+    size_t budget_bytes;     // 0 when unlimited
+    uint32_t evictions;      // Textures evicted since the renderer was created
+} PAL_TextureStats;
+
+// GPU time from timer queries. Results are read without stalling, so they
+// describe a frame a few frames back (frame_index says which). Comparing
+// gpu_frame_ms with cpu_frame_ms tells the bottleneck apart: a GPU time close
+// to the CPU time means the GPU was waiting for commands (CPU-bound), a
+// longer one means the GPU itself is the limit (e.g. fill-bound).
+#define PAL_GPU_TIMING_MAX_PASSES 16
+#define PAL_GPU_PASS_LABEL_SIZE 32
+
+typedef struct {
+    char label[PAL_GPU_PASS_LABEL_SIZE]; // Truncated copy of the label given to pal_renderer_begin_gpu_pass
+    uint32_t depth;                      // Nesting level, 0 for top-level passes
+    float gpu_ms;                        // GPU time between the pass's begin and end
+} PAL_GpuPassTiming;
+
+typedef struct {
+    bool available;          // false if unsupported or until the first result arrives
+    uint64_t frame_index;    // Frame the results belong to (counts begun, non-skipped frames)
+    float gpu_frame_ms;      // GPU time from begin_frame to the end of the frame's commands
+    float cpu_frame_ms;      // CPU time from begin_frame to end_frame for the same frame
+    uint32_t pass_count;
+    PAL_GpuPassTiming passes[PAL_GPU_TIMING_MAX_PASSES]; // In the order they began
+    uint32_t dropped_frames; // Frames discarded because results took too long to arrive
+} PAL_GpuTiming;
+
+// --- Frame Capture --- //
+// Captured frames are delivered a frame or two after they were drawn, once the
+// GPU has copied them out, so capturing never stalls the frame.
+//
+// A capture stream file is a sequence of records, one per captured frame. Each
+// record is a PAL_CAPTURE_RECORD_HEADER_SIZE-byte little-endian header
+//     char magic[4] = "PALF"; uint32 format; uint32 width; uint32 height;
+//     uint64 frame_index; uint64 timestamp_us; uint32 payload_bytes
+// followed by payload_bytes of pixels in the record's format. timestamp_us is
+// when the frame was captured, relative to the start of the stream.
+#define PAL_CAPTURE_RECORD_HEADER_SIZE 36
+
+typedef enum {
+    PAL_CAPTURE_FORMAT_RAW, // Payload is width * height BGRA pixels, top row first
+    PAL_CAPTURE_FORMAT_QOI  // Payload is a complete QOI image (lossless RGBA)
+} PAL_CaptureFormat;
+
+/**
+ * @brief Receives a captured frame. pixels are 32-bit BGRA with row 0 at the
+ *        top and no padding (width * 4 bytes per row), valid only for the
+ *        duration of the call. Called from inside pal_renderer_begin_frame,
+ *        pal_renderer_end_frame or pal_renderer_destroy, so it must not
+ *        call back into the renderer except to request another capture.
+ *        With PAL_RendererConfig.render_thread it runs on the render thread.
+ */
+typedef void (*PAL_CaptureCallback)(const void* pixels, int width, int height,
+                                    uint64_t frame_index, void* user_data);
+
+typedef struct {
+    bool streaming;           // A capture stream file is open
+    uint32_t captured_frames; // Frames delivered to callbacks or the stream since creation
+    uint32_t dropped_frames;  // Stream frames skipped because the readback buffers or the file writer were busy
+    uint64_t stream_bytes;    // Bytes written to the current stream file
+} PAL_CaptureStats;
+
 // --- Texture Handle --- //
 // Opaque handle to a texture managed by the renderer
 typedef void* PAL_TextureHandle;
@@ -29,8 +185,57 @@ typedef void* PAL_TextureHandle;
  */
 PAL_Renderer* pal_renderer_create(PAL_Window* window);
 
+/**
+ * @brief Creates and initializes the rendering backend with explicit settings.
+ * @param window The PAL window to associate the renderer with.
+ * @param config Renderer configuration, or NULL for defaults (standard vertex format).
+ * @return An opaque handle to the renderer, or NULL on failure.
+ */
+PAL_Renderer* pal_renderer_create_with_config(PAL_Window* window, const PAL_RendererConfig* config);
+
+/**
+ * @brief Creates a renderer for another window that shares GPU resources with
+ *        an existing one. Shader programs, static buffers and textures
+ *        (including glyph atlas pages and layers) are created once and are
+ *        valid with every renderer of the group; textures may be destroyed
+ *        through any of them. The group keeps the texture budget of the first
+ *        renderer, so config->texture_budget_bytes is ignored.
+ *        Begin and end one renderer's frame before starting another's; with
+ *        several windows, usually only one should use a vsync present mode so
+ *        the swaps do not each wait for a vertical blank.
+ *        Renderers sharing resources draw on the calling thread;
+ *        config->render_thread is ignored.
+ * @param share_with Any renderer of the group; must not be headless or use a render thread.
+ * @param window The PAL window to associate the renderer with.
+ * @param config Renderer configuration, or NULL for defaults.
+ * @return An opaque handle to the renderer, or NULL on failure.
+ */
+PAL_Renderer* pal_renderer_create_shared(PAL_Renderer* share_with, PAL_Window* window, const PAL_RendererConfig* config);
+
+/**
+ * @brief Creates a renderer that draws into an offscreen target without a window.
+ *        Uses an EGL context (surfaceless where supported), so it runs on
+ *        machines without a display, e.g. CI. Frames are never presented;
+ *        fetch results with pal_renderer_read_pixels. Only available when
+ *        built with UI_FRAMEWORK_HEADLESS.
+ * @param width Render target width in pixels.
+ * @param height Render target height in pixels.
+ * @param config Renderer configuration, or NULL for defaults.
+ * @return An opaque handle to the renderer, or NULL on failure or if unsupported.
+ */
+PAL_Renderer* pal_renderer_create_headless(int width, int height, const PAL_RendererConfig* config);
+
+/**
+ * @brief Gets the vertex layout the renderer was created with.
+ * @param renderer The renderer handle.
+ * @return The vertex format used for the draw list and GPU vertex buffer.
+ */
+PAL_VertexFormat pal_renderer_get_vertex_format(const PAL_Renderer* renderer);
+
 /**
  * @brief Destroys the renderer and releases graphics resources.
+ *        Resources shared with other renderers (pal_renderer_create_shared)
+ *        are released with the last renderer of the group.
  * @param renderer The renderer handle.
  */
 void pal_renderer_destroy(PAL_Renderer* renderer);
@@ -39,17 +244,199 @@ void pal_renderer_destroy(PAL_Renderer* renderer);
 
 /**
  * @brief Prepares the renderer for a new frame.
+ *        With damage tracking, only the damaged area is cleared and all
+ *        drawing is clipped to it; if nothing was damaged the frame is skipped.
  * @param renderer The renderer handle.
  * @param clear_color The color to clear the background with.
+ * @return true if the frame should be drawn, false if it was skipped (draws
+ *         are then discarded; pal_renderer_end_frame must still be called).
  */
-void pal_renderer_begin_frame(PAL_Renderer* renderer, Color clear_color);
+bool pal_renderer_begin_frame(PAL_Renderer* renderer, Color clear_color);
 
 /**
  * @brief Presents the completed frame to the window.
+ *        Flushes all draw calls batched during the frame before presenting.
+ *        Skipped frames are not presented, so nothing is swapped.
+ *        With PAL_RendererConfig.render_thread the frame's draw list is
+ *        handed to the render thread, which issues the GL calls and swaps,
+ *        and this returns once the previous frame is done there; the next
+ *        frame is recorded into a second list meanwhile. Calls that need the
+ *        GL context before end_frame (flushes, layers, texture uploads, GPU
+ *        passes, pixel reads) wait for the render thread and run on the
+ *        calling thread. The frame paced present mode is not available and
+ *        falls back to vsync.
  * @param renderer The renderer handle.
  */
 void pal_renderer_end_frame(PAL_Renderer* renderer);
 
+// --- Presentation --- //
+// The present mode starts out as PAL_WindowConfig.present_mode.
+
+/**
+ * @brief Waits for the best moment to start the next frame.
+ *        In PAL_PRESENT_MODE_FRAME_PACED this sleeps until just before the
+ *        next vertical blank, minus the measured frame cost, so that input
+ *        polled afterwards reaches the display with minimal delay. Call it at
+ *        the top of the main loop, before polling input. Returns immediately
+ *        in the other modes.
+ * @param renderer The renderer handle.
+ */
+void pal_renderer_wait_for_frame(PAL_Renderer* renderer);
+
+/**
+ * @brief Changes the present mode (swap interval and pacing) and resets frame timing.
+ *        Adaptive vsync falls back to vsync where the driver lacks support.
+ * @param renderer The renderer handle.
+ * @param mode The new present mode.
+ */
+void pal_renderer_set_present_mode(PAL_Renderer* renderer, PAL_PresentMode mode);
+
+/**
+ * @brief Gets the present mode in effect (after any fallback).
+ * @param renderer The renderer handle.
+ * @return The present mode.
+ */
+PAL_PresentMode pal_renderer_get_present_mode(const PAL_Renderer* renderer);
+
+/**
+ * @brief Gets measured frame intervals and frame cost for recent frames.
+ * @param renderer The renderer handle.
+ * @param timing Receives the timing (zeroed if renderer is NULL).
+ */
+void pal_renderer_get_frame_timing(const PAL_Renderer* renderer, PAL_FrameTiming* timing);
+
+// --- GPU Profiling --- //
+
+/**
+ * @brief Starts a labelled GPU pass for timing. Passes may nest and must be
+ *        closed with pal_renderer_end_gpu_pass within the same frame (passes
+ *        still open at pal_renderer_end_frame are closed there). Pending
+ *        draws are flushed at both ends so the pass times exactly its own
+ *        commands, which splits batching at pass boundaries.
+ *        At most PAL_GPU_TIMING_MAX_PASSES passes per frame are timed.
+ * @param renderer The renderer handle.
+ * @param label Name reported in PAL_GpuPassTiming (copied).
+ */
+void pal_renderer_begin_gpu_pass(PAL_Renderer* renderer, const char* label);
+
+/**
+ * @brief Ends the innermost open GPU pass.
+ * @param renderer The renderer handle.
+ */
+void pal_renderer_end_gpu_pass(PAL_Renderer* renderer);
+
+/**
+ * @brief Gets the most recent GPU timing results.
+ * @param renderer The renderer handle.
+ * @param timing Receives the timing (zeroed if renderer is NULL or timing is unsupported).
+ */
+void pal_renderer_get_gpu_timing(const PAL_Renderer* renderer, PAL_GpuTiming* timing);
+
+// --- Damage Tracking --- //
+// Only used when PAL_RendererConfig.damage_tracking is enabled. Report every
+// area whose contents change; the next frame redraws the bounding box of all
+// reported areas. Resizes damage the whole window automatically.
+
+/**
+ * @brief Marks an area of the window as needing a redraw.
+ * @param renderer The renderer handle.
+ * @param x Left edge in window coordinates.
+ * @param y Top edge in window coordinates.
+ * @param width Area width.
+ * @param height Area height.
+ */
+void pal_renderer_add_damage(PAL_Renderer* renderer, int x, int y, int width, int height);
+
+/**
+ * @brief Marks the whole window as needing a redraw.
+ * @param renderer The renderer handle.
+ */
+void pal_renderer_damage_all(PAL_Renderer* renderer);
+
+/**
+ * @brief Checks whether the next frame has anything to draw or present.
+ *        When false the application can block in pal_input_wait_events.
+ * @param renderer The renderer handle.
+ * @return true if a frame is needed (always true without damage tracking).
+ */
+bool pal_renderer_has_damage(const PAL_Renderer* renderer);
+
+/**
+ * @brief Submits all batched draw calls to the GPU immediately.
+ *        Draw calls are normally recorded into a per-frame draw list and only
+ *        issued at pal_renderer_end_frame. Call this when GPU work must happen
+ *        at a specific point mid-frame. Texture updates and destruction flush
+ *        automatically.
+ * @param renderer The renderer handle.
+ */
+void pal_renderer_flush(PAL_Renderer* renderer);
+
+/**
+ * @brief Copies pixels from the current render target into client memory.
+ *        Pending draw calls are flushed first. Pixels use the same 32-bit
+ *        BGRA layout as pal_renderer_create_texture with row 0 at the top.
+ *        Headless and damage-tracking renderers keep the last frame readable
+ *        after pal_renderer_end_frame; otherwise read before ending the frame.
+ *        This stalls until the GPU has finished drawing.
+ * @param renderer The renderer handle.
+ * @param x Left edge in window coordinates.
+ * @param y Top edge in window coordinates.
+ * @param width Area width.
+ * @param height Area height.
+ * @param pixels Destination buffer (at least height rows of stride_bytes).
+ * @param stride_bytes Bytes between destination rows; a multiple of 4, or 0 for width * 4.
+ * @return true on success, false if the area or stride is invalid.
+ */
+bool pal_renderer_read_pixels(PAL_Renderer* renderer, int x, int y, int width, int height,
+                              void* pixels, int stride_bytes);
+
+/**
+ * @brief Captures the next completed frame without stalling: the frame is
+ *        copied into a buffer on the GPU and handed to callback once the copy
+ *        has finished, normally one or two frames later. Frames skipped by
+ *        damage tracking are not captured; the request waits for the next
+ *        frame that is drawn.
+ * @param renderer The renderer handle.
+ * @param callback Receives the pixels (see PAL_CaptureCallback).
+ * @param user_data Passed through to callback.
+ * @return true if the request was queued, false if another request is still
+ *         waiting for its frame.
+ */
+bool pal_renderer_request_capture(PAL_Renderer* renderer, PAL_CaptureCallback callback, void* user_data);
+
+/**
+ * @brief Starts writing every completed frame to a capture stream file (see
+ *        PAL_CAPTURE_RECORD_HEADER_SIZE for the layout), replacing any stream
+ *        already open. Frames are encoded and written on a separate thread.
+ *        If the GPU or the writer falls behind, frames are dropped rather
+ *        than waited for; PAL_CaptureStats counts them.
+ * @param renderer The renderer handle.
+ * @param path File to create (truncated if it exists).
+ * @param format Pixel format of each record.
+ * @return true if the file was opened.
+ */
+bool pal_renderer_start_capture_stream(PAL_Renderer* renderer, const char* path, PAL_CaptureFormat format);
+
+/**
+ * @brief Writes out frames still in flight and closes the capture stream file.
+ * @param renderer The renderer handle.
+ */
+void pal_renderer_stop_capture_stream(PAL_Renderer* renderer);
+
+/**
+ * @brief Gets frame capture counters.
+ * @param renderer The renderer handle.
+ * @param stats Receives the counters (zeroed if renderer is NULL).
+ */
+void pal_renderer_get_capture_stats(const PAL_Renderer* renderer, PAL_CaptureStats* stats);
+
+/**
+ * @brief Gets counters for the most recently completed frame.
+ * @param renderer The renderer handle.
+ * @param stats Receives the statistics (zeroed if renderer is NULL).
+ */
+void pal_renderer_get_stats(const PAL_Renderer* renderer, PAL_RendererStats* stats);
+
 // --- Texture Management --- //
 
 /**
@@ -72,18 +459,119 @@ PAL_TextureHandle pal_renderer_create_texture(PAL_Renderer* renderer, int width,
  */
 void pal_renderer_update_texture(PAL_Renderer* renderer, PAL_TextureHandle texture, int width, int height, const void* data);
 
+/**
+ * @brief Updates a sub-rectangle of an existing texture.
+ *        The pixels are copied into a streaming staging buffer before this
+ *        returns and transferred to the texture by the GPU asynchronously, so
+ *        the CPU never waits for the upload and data may be reused at once.
+ *        Unlike pal_renderer_update_texture this does not flush pending draws:
+ *        commands recorded earlier in the frame that sample the updated region
+ *        will see the new contents. Callers replacing texels that are already
+ *        in use this frame should call pal_renderer_flush first.
+ * @param renderer The renderer handle.
+ * @param texture The texture handle to update.
+ * @param x Left edge of the region in texels.
+ * @param y Top edge of the region in texels.
+ * @param width Region width.
+ * @param height Region height.
+ * @param data Pointer to the first pixel of the region (same format as create).
+ * @param stride_bytes Bytes between source rows (multiple of 4), or 0 for tightly packed rows.
+ */
+void pal_renderer_update_texture_region(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                                        int x, int y, int width, int height,
+                                        const void* data, int stride_bytes);
+
 /**
  * @brief Destroys a texture and releases its resources.
+ *        Textures still alive when the renderer is destroyed are released with it.
  * @param renderer The renderer handle.
  * @param texture The texture handle to destroy.
  */
 void pal_renderer_destroy_texture(PAL_Renderer* renderer, PAL_TextureHandle texture);
 
+/**
+ * @brief Marks a texture whose contents the application can regenerate.
+ *        When resident texture memory exceeds the budget, purgeable textures
+ *        not used in the current frame are evicted, least recently drawn
+ *        first. An evicted handle stays valid: it draws as plain white until
+ *        its contents are uploaded again with pal_renderer_update_texture.
+ * @param renderer The renderer handle.
+ * @param texture The texture handle.
+ * @param purgeable true to allow eviction (textures are not purgeable by default).
+ */
+void pal_renderer_set_texture_purgeable(PAL_Renderer* renderer, PAL_TextureHandle texture, bool purgeable);
+
+/**
+ * @brief Checks whether a texture still holds its contents.
+ * @param renderer The renderer handle.
+ * @param texture The texture handle.
+ * @return false if the texture was evicted (or the arguments are NULL).
+ */
+bool pal_renderer_texture_is_resident(const PAL_Renderer* renderer, PAL_TextureHandle texture);
+
+/**
+ * @brief Sets the resident texture memory budget and evicts down to it.
+ *        Non-purgeable textures are never evicted, so usage can exceed the budget.
+ * @param renderer The renderer handle.
+ * @param budget_bytes Budget in bytes, or 0 for unlimited.
+ */
+void pal_renderer_set_texture_budget(PAL_Renderer* renderer, size_t budget_bytes);
+
+/**
+ * @brief Gets texture memory accounting.
+ * @param renderer The renderer handle.
+ * @param stats Receives the statistics (zeroed if renderer is NULL).
+ */
+void pal_renderer_get_texture_stats(const PAL_Renderer* renderer, PAL_TextureStats* stats);
+
+// --- Layers --- //
+// A layer is a texture the renderer can draw into. Render something that
+// rarely changes (e.g. a static panel) into a layer once, then draw the layer
+// every frame as a single textured quad until its contents need redrawing.
+// Layers are regular texture handles: draw them with any textured
+// submission, release them with pal_renderer_destroy_texture. Like other
+// textures they are only evicted if marked purgeable; an evicted layer
+// reports pal_renderer_texture_is_resident false and must be redrawn.
+
+/**
+ * @brief Creates a layer (render target texture). Contents start transparent.
+ * @param renderer The renderer handle.
+ * @param width Layer width in pixels.
+ * @param height Layer height in pixels.
+ * @return A texture handle usable with pal_renderer_begin_layer, or NULL on failure.
+ */
+PAL_TextureHandle pal_renderer_create_layer(PAL_Renderer* renderer, int width, int height);
+
+/**
+ * @brief Redirects subsequent submissions into a layer, after clearing it.
+ *        Coordinates are layer pixels with the origin at its top-left corner,
+ *        the scissor is reset, and damage tracking does not clip. Layers do
+ *        not nest: beginning a layer ends the current one. Call between
+ *        pal_renderer_begin_frame and pal_renderer_end_frame; layers are
+ *        drawn even in frames skipped by damage tracking. A layer must not be
+ *        sampled while it is being drawn into.
+ *        Blending treats the layer like the window, so translucent content
+ *        over a transparent clear color composites slightly darker than
+ *        drawing it directly; clear to an opaque color where that matters.
+ * @param renderer The renderer handle.
+ * @param layer Layer created with pal_renderer_create_layer.
+ * @param clear_color Color the layer is cleared to.
+ * @return true if drawing now goes to the layer.
+ */
+bool pal_renderer_begin_layer(PAL_Renderer* renderer, PAL_TextureHandle layer, Color clear_color);
+
+/**
+ * @brief Finishes drawing into the current layer and returns to the frame.
+ *        Called automatically by pal_renderer_end_frame if a layer is still open.
+ * @param renderer The renderer handle.
+ */
+void pal_renderer_end_layer(PAL_Renderer* renderer);
+
 // --- Drawing Operations --- //
 
 /**
  * @brief Sets the active scissor rectangle for clipping.
- *        Draw calls will be clipped to this rectangle.
+ *        Draw calls submitted after this will be clipped to this rectangle.
  * @param renderer The renderer handle.
  * @param x Scissor rectangle X coordinate.
  * @param y Scissor rectangle Y coordinate.
@@ -101,7 +589,9 @@ void pal_renderer_reset_scissor(PAL_Renderer* renderer);
 /**
  * @brief Submits a list of vertices to be rendered as triangles.
  *        Assumes vertices are grouped into triangles (3 vertices per triangle).
- *        Uses the specified texture.
+ *        Uses the specified texture. The vertices are copied into the frame's
+ *        draw list; consecutive submissions with the same texture and scissor
+ *        state are merged into a single draw call.
  * @param renderer The renderer handle.
  * @param texture The texture handle to use (can be NULL for untextured colored triangles).
  * @param vertices Pointer to the vertex data.
@@ -110,7 +600,71 @@ void pal_renderer_reset_scissor(PAL_Renderer* renderer);
 void pal_renderer_render_triangles(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_Vertex* vertices, size_t vertex_count);
 
 /**
- * @brief Helper to render a simple textured quad (composed of two triangles).
+ * @brief Submits a list of quads, 4 vertices per quad.
+ *        Vertices of each quad are ordered top-left, top-right, bottom-right,
+ *        bottom-left. Quads are drawn through a shared static index buffer,
+ *        so no duplicate vertices need to be sent.
+ * @param renderer The renderer handle.
+ * @param texture The texture handle to use (can be NULL for untextured colored quads).
+ * @param vertices Pointer to quad_count * 4 vertices.
+ * @param quad_count The number of quads.
+ */
+void pal_renderer_render_quads(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_Vertex* vertices, size_t quad_count);
+
+/**
+ * @brief Submits an indexed triangle mesh.
+ *        Every 3 indices form a triangle; indices refer to the given vertex array.
+ * @param renderer The renderer handle.
+ * @param texture The texture handle to use (can be NULL for untextured colored triangles).
+ * @param vertices Pointer to the vertex data.
+ * @param vertex_count The number of vertices.
+ * @param indices Pointer to the index data (0-based into vertices).
+ * @param index_count The number of indices.
+ */
+void pal_renderer_render_indexed(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                                 const PAL_Vertex* vertices, size_t vertex_count,
+                                 const uint32_t* indices, size_t index_count);
+
+/**
+ * @brief Compact-vertex variant of pal_renderer_render_triangles.
+ *        Cheapest when the renderer uses PAL_VERTEX_FORMAT_COMPACT, since the
+ *        vertices are then copied without conversion.
+ */
+void pal_renderer_render_triangles_compact(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_VertexCompact* vertices, size_t vertex_count);
+
+/**
+ * @brief Compact-vertex variant of pal_renderer_render_quads.
+ */
+void pal_renderer_render_quads_compact(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_VertexCompact* vertices, size_t quad_count);
+
+/**
+ * @brief Submits quads given as rectangles, texture areas and colors.
+ *        The vertices are written straight into the draw list in the
+ *        renderer's vertex format, with SIMD where available (see
+ *        pal_quad_batch.h), which makes this the cheapest way to draw many
+ *        quads, e.g. glyphs or grid cells.
+ * @param renderer The renderer handle.
+ * @param texture The texture handle to use (can be NULL for untextured colored quads).
+ * @param rects quad_count rectangles.
+ * @param uvs quad_count texture areas, or NULL to show the whole texture on every quad.
+ * @param colors quad_count colors packed like PAL_Vertex.color, or NULL for white.
+ * @param quad_count The number of quads.
+ */
+void pal_renderer_render_quad_batch(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_QuadRect* rects,
+                                    const PAL_QuadUV* uvs, const uint32_t* colors, size_t quad_count);
+
+/**
+ * @brief Submits styled rectangles to the instanced SDF rectangle pipeline.
+ *        All consecutive rects sharing scissor state are drawn with a single
+ *        instanced draw call.
+ * @param renderer The renderer handle.
+ * @param rects Pointer to the rectangle instances.
+ * @param rect_count The number of rectangles.
+ */
+void pal_renderer_render_rects(PAL_Renderer* renderer, const PAL_RectInstance* rects, size_t rect_count);
+
+/**
+ * @brief Helper to render a simple textured quad (4 indexed vertices).
  * @param renderer The renderer handle.
  * @param texture The texture handle.
  * @param x Top-left X.
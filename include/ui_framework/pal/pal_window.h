@@ -5,12 +5,22 @@
 
 // --- Configuration ---
 
+// How finished frames are handed to the display
+typedef enum {
+    PAL_PRESENT_MODE_VSYNC = 0,      // Wait for vertical blank; no tearing, up to a frame or two of queueing (default)
+    PAL_PRESENT_MODE_ADAPTIVE_VSYNC, // Vsync when on time, tear rather than stall when late (falls back to vsync)
+    PAL_PRESENT_MODE_IMMEDIATE,      // Present as soon as rendered; lowest latency, may tear
+    PAL_PRESENT_MODE_FRAME_PACED     // Vsync without queueing: pal_renderer_wait_for_frame sleeps until just
+                                     // before the deadline so input is sampled as late as possible
+} PAL_PresentMode;
+
 typedef struct {
     const char* title;
     int width;
     int height;
     bool resizable;
-    // Add other options as needed (e.g., fullscreen, vsync)
+    PAL_PresentMode present_mode; // Applied by the renderer created for this window
+    // Add other options as needed (e.g., fullscreen)
 } PAL_WindowConfig;
 
 // --- Opaque Window Handle ---
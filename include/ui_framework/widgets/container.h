@@ -19,9 +19,22 @@
  */
 Widget* container_create(int x, int y, int width, int height);
 
+/**
+ * @brief Destroy a container
+ * 
+ * Releases the container and its cached layer. Children are detached, not
+ * destroyed. Same as widget_destroy, which releases containers too.
+ * 
+ * @param container Container to destroy
+ */
+void container_destroy(Widget* container);
+
 /**
  * @brief Add a child widget to a container
  * 
+ * Children use window coordinates, are drawn in the order they were added
+ * and receive events topmost first. A widget can only have one parent.
+ * 
  * @param container Container to add child to
  * @param child Child widget to add
  * @return int 0 on success, -1 on failure
@@ -62,4 +75,41 @@ Widget* container_get_child(const Widget* container, int index);
  */
 void container_set_background_color(Widget* container, Color color);
 
+/**
+ * @brief Cache the container's subtree in a layer
+ * 
+ * While enabled, the background and children are drawn once into an
+ * offscreen canvas the size of the container, and drawing the container
+ * just copies that canvas until the container or anything below it is
+ * invalidated (see widget_get_revision). Children must stay inside the
+ * container's bounds; anything outside is clipped. Disabling frees the layer.
+ * 
+ * @param container Container to enable the layer for
+ * @param enabled Whether the subtree should be cached
+ */
+void container_set_layer_enabled(Widget* container, bool enabled);
+
+/**
+ * @brief Check if a container caches its subtree in a layer
+ * 
+ * @param container Container to check
+ * @return true if the layer is enabled, false otherwise
+ */
+bool container_is_layer_enabled(const Widget* container);
+
+/**
+ * @brief Get the up-to-date layer of a container
+ * 
+ * Redraws the layer first if the subtree changed. To composite the subtree
+ * as a single textured quad, upload the layer to a renderer texture whenever
+ * the version changes and draw that texture every frame. Layer pixels use
+ * the color_to_uint32 packing (see canvas_get_data) and are premultiplied
+ * (CANVAS_BLEND_PREMULTIPLIED); opaque pixels are the same either way.
+ * 
+ * @param container Container to get the layer of
+ * @param version Receives a counter that changes every time the layer is redrawn (may be NULL)
+ * @return const Canvas* The layer, NULL if the layer is disabled or could not be created
+ */
+const Canvas* container_get_layer(Widget* container, uint32_t* version);
+
 #endif /* UI_FRAMEWORK_CONTAINER_H */
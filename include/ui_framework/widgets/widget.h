@@ -32,6 +32,15 @@ typedef bool (*WidgetEventHandler)(Widget* widget, const Event* event);
  */
 typedef void (*WidgetDrawFunction)(Widget* widget, Canvas* canvas);
 
+/**
+ * @brief Widget destroy function
+ * 
+ * Releases what the widget's user data owns before the widget is freed.
+ * 
+ * @param widget Widget being destroyed
+ */
+typedef void (*WidgetDestroyFunction)(Widget* widget);
+
 /**
  * @brief Create a new widget
  * 
@@ -52,10 +61,24 @@ Widget* widget_create(int x, int y, int width, int height,
 /**
  * @brief Destroy a widget
  * 
+ * Calls the widget's destroy function, if set, then removes the widget from
+ * its parent container, which damages the area it covered, and frees it.
+ * 
  * @param widget Widget to destroy
  */
 void widget_destroy(Widget* widget);
 
+/**
+ * @brief Set the function widget_destroy calls to release the widget's user data
+ * 
+ * Widget types that allocate user data (e.g. containers) set this, so
+ * destroying them through widget_destroy does not leak it.
+ * 
+ * @param widget Widget to set the destroy function for
+ * @param destroy_fn Destroy function, or NULL for none
+ */
+void widget_set_destroy_function(Widget* widget, WidgetDestroyFunction destroy_fn);
+
 /**
  * @brief Draw a widget
  * 
@@ -181,4 +204,74 @@ void widget_set_user_data(Widget* widget, void* user_data);
  */
 bool widget_contains_point(const Widget* widget, int x, int y);
 
+/**
+ * @brief Mark a widget as needing a redraw
+ * 
+ * Call this whenever something affecting the widget's appearance changes.
+ * Position, size, visibility and enabled-state setters invalidate automatically.
+ * 
+ * @param widget Widget to invalidate
+ */
+void widget_invalidate(Widget* widget);
+
+/**
+ * @brief Check if a widget has damage that has not been taken yet
+ * 
+ * @param widget Widget to check
+ * @return true if the widget needs redrawing, false otherwise
+ */
+bool widget_is_dirty(const Widget* widget);
+
+/**
+ * @brief Take the area that needs redrawing because of this widget
+ * 
+ * The area covers the widget's bounds and, after a move or resize, its
+ * previous bounds as well. Damage to a child is added to its ancestors too,
+ * so the root of a widget tree reports everything below it. Taking the damage clears the dirty state of
+ * the widget and of every descendant, whose damage it included; pass the area to the renderer (e.g.
+ * pal_renderer_add_damage).
+ * 
+ * @param widget Widget to take damage from
+ * @param x Receives the left edge
+ * @param y Receives the top edge
+ * @param width Receives the width
+ * @param height Receives the height
+ * @return true if the widget was dirty, false otherwise (outputs untouched)
+ */
+bool widget_take_damage(Widget* widget, int* x, int* y, int* width, int* height);
+
+/**
+ * @brief Set the parent of a widget
+ * 
+ * Containers call this when children are added or removed, and a parent
+ * must be a container: widget_destroy removes the widget from it with
+ * container_remove_child. A widget with a parent passes its damage and
+ * revision changes up to it.
+ * 
+ * @param widget Widget to set the parent for
+ * @param parent New parent, or NULL to detach
+ */
+void widget_set_parent(Widget* widget, Widget* parent);
+
+/**
+ * @brief Get the parent of a widget
+ * 
+ * @param widget Widget to get the parent for
+ * @return Widget* Parent widget, NULL if the widget has none
+ */
+Widget* widget_get_parent(const Widget* widget);
+
+/**
+ * @brief Get the revision of a widget
+ * 
+ * The revision changes whenever the widget or any widget below it is
+ * invalidated, so a cached rendering of the subtree is stale once the
+ * revision differs from the one it was drawn at. Unlike the dirty state it
+ * is not cleared by widget_take_damage.
+ * 
+ * @param widget Widget to get the revision for
+ * @return uint32_t Current revision
+ */
+uint32_t widget_get_revision(const Widget* widget);
+
 #endif /* UI_FRAMEWORK_WIDGET_H */
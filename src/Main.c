@@ -28,7 +28,8 @@ int main(int argc, char *argv[]) {
         .title = "UI Framework Demo (PAL/SDL)",
         .width = 800,
         .height = 600,
-        .resizable = true
+        .resizable = true,
+        .present_mode = PAL_PRESENT_MODE_VSYNC
     };
     
     PAL_Window* window = pal_window_create(&config);
@@ -41,8 +42,12 @@ int main(int argc, char *argv[]) {
     int window_width, window_height;
     pal_window_get_size(window, &window_width, &window_height);
 
-    /* Create a PAL Renderer */
-    PAL_Renderer* renderer = pal_renderer_create(window);
+    /* Create a PAL Renderer that only redraws what changed */
+    PAL_RendererConfig renderer_config = {
+        .vertex_format = PAL_VERTEX_FORMAT_STANDARD,
+        .damage_tracking = true
+    };
+    PAL_Renderer* renderer = pal_renderer_create_with_config(window, &renderer_config);
     if (!renderer) {
         fprintf(stderr, "Failed to create PAL renderer\n");
         pal_window_destroy(window);
@@ -59,14 +64,23 @@ int main(int argc, char *argv[]) {
     }
     
     /* Set button colors and callback */
-    button_set_background_color(button, COLOR_BLUE);
+    Color button_color = COLOR_BLUE;
+    button_set_background_color(button, button_color);
     button_set_text_color(button, COLOR_WHITE);
     button_set_click_callback(button, on_button_click, NULL);
     
     /* Main loop */
     while (!pal_window_should_close(window)) {
-        /* Process Input (Using PAL Input) */
-        pal_input_poll_events(window); 
+        /* Frame-paced present mode: start the frame as late as possible (no-op otherwise) */
+        pal_renderer_wait_for_frame(renderer);
+
+        /* Process Input (Using PAL Input), sleeping until something happens
+           when there is nothing left to redraw */
+        if (pal_renderer_has_damage(renderer)) {
+            pal_input_poll_events(window);
+        } else {
+            pal_input_wait_events(window, -1);
+        }
 
         // --- Example: Check for Escape key to close window --- //
         if (pal_input_is_key_pressed(PAL_KEY_ESCAPE)) {
@@ -85,25 +99,49 @@ int main(int argc, char *argv[]) {
             printf("Mouse Left Button Pressed at: (%d, %d)\n", mouse_x, mouse_y);
             // TODO: Check if click is inside button and trigger callback
             // This requires widget_handle_event logic integrated with PAL input
+            // Until then, toggle the button color so the redraw is visible
+            if (widget_contains_point(button, mouse_x, mouse_y)) {
+                bool is_blue = color_to_uint32(button_color) == color_to_uint32(COLOR_BLUE);
+                button_color = is_blue ? COLOR_RED : COLOR_BLUE;
+                button_set_background_color(button, button_color);
+            }
         }
 
-        /* Begin Renderer Frame */
-        pal_renderer_begin_frame(renderer, color_rgb(50, 50, 50));
+        /* Forward widget damage to the renderer. The shadow reaches past the
+           widget bounds (blur + offset), so grow the area to cover it */
+        int damage_x, damage_y, damage_w, damage_h;
+        if (widget_take_damage(button, &damage_x, &damage_y, &damage_w, &damage_h)) {
+            pal_renderer_add_damage(renderer, damage_x - 8, damage_y - 8, damage_w + 16, damage_h + 16);
+        }
 
-        /* Clear canvas with a dark gray color - Handled by begin_frame */
-        // canvas_clear(canvas, color_rgb(50, 50, 50));
+        /* Begin Renderer Frame (skipped when nothing was damaged) */
+        if (pal_renderer_begin_frame(renderer, color_rgb(50, 50, 50))) {
+            /* Clear canvas with a dark gray color - Handled by begin_frame */
+            // canvas_clear(canvas, color_rgb(50, 50, 50));
         
-        /* Draw widgets - NEEDS REFACTORING */
-        // widget_draw(button, canvas); // Old drawing function
-        // TODO: Need a new drawing approach using pal_renderer functions
-        // e.g., button->draw(button, renderer); which calls pal_renderer_render_textured_quad etc.
-        // For now, draw a placeholder quad:
-        pal_renderer_render_textured_quad(renderer, NULL, 350, 250, 100, 50, 0, 0, 1, 1, COLOR_BLUE);
+            /* Draw widgets - NEEDS REFACTORING */
+            // widget_draw(button, canvas); // Old drawing function
+            // TODO: Need a new drawing approach using pal_renderer functions
+            // e.g., button->draw(button, renderer); which calls pal_renderer_render_textured_quad etc.
+            // For now, draw the button as a single styled rect (fill + border + shadow in one instance):
+            PAL_RectInstance button_rect = {
+                .x = (float)widget_get_x(button), .y = (float)widget_get_y(button),
+                .width = (float)widget_get_width(button), .height = (float)widget_get_height(button),
+                .corner_radius = 6.0f,
+                .border_width = 1.0f,
+                .shadow_blur = 4.0f,
+                .fill_color = color_to_uint32(button_color),
+                .border_color = color_to_uint32(COLOR_BLACK),
+                .shadow_color = color_to_uint32(color_rgba(0, 0, 0, 96)),
+                .shadow_offset_x = 0.0f, .shadow_offset_y = 2.0f
+            };
+            pal_renderer_render_rects(renderer, &button_rect, 1);
 
-        /* Render canvas to window - Handled by end_frame */
-        // ...
-        
-        /* End Renderer Frame (swaps buffers) */
+            /* Render canvas to window - Handled by end_frame */
+            // ...
+        }
+
+        /* End Renderer Frame (swaps buffers unless the frame was skipped) */
         pal_renderer_end_frame(renderer);
         
         /* Temporary replacement - NO LONGER NEEDED */
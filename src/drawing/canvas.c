@@ -5,10 +5,21 @@
 
 #include "../../include/ui_framework/drawing/canvas.h"
 #include "../../include/ui_framework/core/window.h" /* Include window.h explicitly */
+#include "canvas_span.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+/**
+ * @brief Clip rectangle in pixel bounds [x0, x1) x [y0, y1)
+ */
+typedef struct {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+} CanvasClip;
+
 /**
  * @brief Canvas structure implementation
  */
@@ -16,6 +27,12 @@ struct Canvas {
     int width;
     int height;
     uint32_t* pixels;
+    int origin_x; /* Drawing coordinates of pixel (0, 0) */
+    int origin_y;
+    CanvasBlendMode blend_mode;
+    CanvasClip* clips; /* Clip stack, each entry inside the previous; the last is active */
+    int clip_count;
+    int clip_capacity;
 };
 
 Canvas* canvas_create(int width, int height) {
@@ -30,6 +47,12 @@ Canvas* canvas_create(int width, int height) {
 
     canvas->width = width;
     canvas->height = height;
+    canvas->origin_x = 0;
+    canvas->origin_y = 0;
+    canvas->blend_mode = CANVAS_BLEND_SOURCE_OVER;
+    canvas->clips = NULL;
+    canvas->clip_count = 0;
+    canvas->clip_capacity = 0;
     canvas->pixels = (uint32_t*)malloc(width * height * sizeof(uint32_t));
     
     if (!canvas->pixels) {
@@ -48,6 +71,7 @@ void canvas_destroy(Canvas* canvas) {
         return;
     }
     
+    free(canvas->clips);
     free(canvas->pixels);
     free(canvas);
 }
@@ -57,15 +81,34 @@ void canvas_clear(Canvas* canvas, Color color) {
         return;
     }
     
-    uint32_t color_value = color_to_uint32(color);
-    
-    for (int i = 0; i < canvas->width * canvas->height; i++) {
-        canvas->pixels[i] = color_value;
+    uint32_t value = color_to_uint32(color);
+    if (canvas->blend_mode == CANVAS_BLEND_PREMULTIPLIED) {
+        value = span_premultiply(value);
+    }
+    span_fill(canvas->pixels, (size_t)canvas->width * (size_t)canvas->height, value);
+}
+
+/**
+ * @brief Get the active clip: the top of the clip stack, or the whole canvas
+ */
+static CanvasClip canvas_active_clip(const Canvas* canvas) {
+    if (canvas->clip_count > 0) {
+        return canvas->clips[canvas->clip_count - 1];
     }
+
+    CanvasClip clip = { 0, 0, canvas->width, canvas->height };
+    return clip;
 }
 
 void canvas_set_pixel(Canvas* canvas, int x, int y, Color color) {
-    if (!canvas || x < 0 || x >= canvas->width || y < 0 || y >= canvas->height) {
+    if (!canvas) {
+        return;
+    }
+
+    CanvasClip clip = canvas_active_clip(canvas);
+    x -= canvas->origin_x;
+    y -= canvas->origin_y;
+    if (x < clip.x0 || x >= clip.x1 || y < clip.y0 || y >= clip.y1) {
         return;
     }
     
@@ -73,13 +116,109 @@ void canvas_set_pixel(Canvas* canvas, int x, int y, Color color) {
 }
 
 Color canvas_get_pixel(const Canvas* canvas, int x, int y) {
-    if (!canvas || x < 0 || x >= canvas->width || y < 0 || y >= canvas->height) {
+    if (!canvas) {
+        return COLOR_TRANSPARENT;
+    }
+
+    x -= canvas->origin_x;
+    y -= canvas->origin_y;
+    if (x < 0 || x >= canvas->width || y < 0 || y >= canvas->height) {
         return COLOR_TRANSPARENT;
     }
     
     return color_from_uint32(canvas->pixels[y * canvas->width + x]);
 }
 
+/**
+ * @brief Convert a drawing-space rectangle to pixel bounds [x0, x1) x [y0, y1)
+ *        clipped to the active clip
+ * 
+ * @return int Nonzero if any pixel is left
+ */
+static int canvas_clip_rect(const Canvas* canvas, int x, int y, int width, int height,
+                            int* x0, int* y0, int* x1, int* y1) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    /* 64-bit so rectangles reaching past INT_MAX are clipped, not wrapped */
+    long long left = (long long)x - canvas->origin_x;
+    long long top = (long long)y - canvas->origin_y;
+    long long right = left + width;
+    long long bottom = top + height;
+    CanvasClip clip = canvas_active_clip(canvas);
+    if (left < clip.x0) left = clip.x0;
+    if (top < clip.y0) top = clip.y0;
+    if (right > clip.x1) right = clip.x1;
+    if (bottom > clip.y1) bottom = clip.y1;
+    if (left >= right || top >= bottom) {
+        return 0;
+    }
+
+    *x0 = (int)left;
+    *y0 = (int)top;
+    *x1 = (int)right;
+    *y1 = (int)bottom;
+    return 1;
+}
+
+void canvas_fill_rect(Canvas* canvas, int x, int y, int width, int height, Color color) {
+    int x0, y0, x1, y1;
+    if (!canvas || !canvas_clip_rect(canvas, x, y, width, height, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+
+    /* Pick the row kernel once for the whole rectangle */
+    void (*kernel)(uint32_t*, size_t, uint32_t) = span_fill;
+    uint32_t value = color_to_uint32(color);
+    if (canvas->blend_mode != CANVAS_BLEND_REPLACE && color.a < 255) {
+        if (color.a == 0) {
+            return;
+        }
+        if (canvas->blend_mode == CANVAS_BLEND_PREMULTIPLIED) {
+            value = span_premultiply(value);
+            kernel = span_blend_premultiplied;
+        } else {
+            kernel = span_blend;
+        }
+    }
+
+    uint32_t* row = canvas->pixels + (size_t)y0 * canvas->width + x0;
+    if (x0 == 0 && x1 == canvas->width) {
+        /* Full-width rows are contiguous: one span */
+        kernel(row, (size_t)(y1 - y0) * canvas->width, value);
+        return;
+    }
+    for (int py = y0; py < y1; py++, row += canvas->width) {
+        kernel(row, (size_t)(x1 - x0), value);
+    }
+}
+
+void canvas_fill_span(Canvas* canvas, int x, int y, int width, Color color) {
+    canvas_fill_rect(canvas, x, y, width, 1, color);
+}
+
+void canvas_fill_span_coverage(Canvas* canvas, int x, int y, int width, const uint8_t* coverage, Color color) {
+    int x0, y0, x1, y1;
+    if (!canvas || !coverage || !canvas_clip_rect(canvas, x, y, width, 1, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+    if (color.a == 0 && canvas->blend_mode != CANVAS_BLEND_REPLACE) {
+        return;
+    }
+
+    /* Skip the coverage of pixels clipped off the left */
+    coverage += (long long)x0 + canvas->origin_x - x;
+
+    int premultiplied = canvas->blend_mode == CANVAS_BLEND_PREMULTIPLIED;
+    uint32_t value = color_to_uint32(color);
+    if (premultiplied) {
+        value = span_premultiply(value);
+    }
+    span_blend_coverage(canvas->pixels + (size_t)y0 * canvas->width + x0, (size_t)(x1 - x0), value, coverage,
+                        premultiplied, canvas->blend_mode == CANVAS_BLEND_REPLACE);
+}
+
 int canvas_get_width(const Canvas* canvas) {
     if (!canvas) {
         return 0;
@@ -104,6 +243,134 @@ const uint32_t* canvas_get_data(const Canvas* canvas) {
     return canvas->pixels;
 }
 
+uint32_t* canvas_get_mutable_data(Canvas* canvas) {
+    if (!canvas) {
+        return NULL;
+    }
+    
+    return canvas->pixels;
+}
+
+void canvas_set_blend_mode(Canvas* canvas, CanvasBlendMode mode) {
+    if (!canvas) {
+        return;
+    }
+
+    canvas->blend_mode = mode;
+}
+
+CanvasBlendMode canvas_get_blend_mode(const Canvas* canvas) {
+    if (!canvas) {
+        return CANVAS_BLEND_SOURCE_OVER;
+    }
+
+    return canvas->blend_mode;
+}
+
+void canvas_set_origin(Canvas* canvas, int origin_x, int origin_y) {
+    if (!canvas) {
+        return;
+    }
+
+    canvas->origin_x = origin_x;
+    canvas->origin_y = origin_y;
+}
+
+int canvas_push_clip(Canvas* canvas, int x, int y, int width, int height) {
+    if (!canvas) {
+        return 0;
+    }
+
+    if (canvas->clip_count == canvas->clip_capacity) {
+        int capacity = canvas->clip_capacity > 0 ? canvas->clip_capacity * 2 : 8;
+        CanvasClip* clips = (CanvasClip*)realloc(canvas->clips, (size_t)capacity * sizeof(CanvasClip));
+        if (!clips) {
+            return 0;
+        }
+        canvas->clips = clips;
+        canvas->clip_capacity = capacity;
+    }
+
+    /* Intersect with the active clip; an empty result clips everything */
+    CanvasClip clip;
+    if (!canvas_clip_rect(canvas, x, y, width, height, &clip.x0, &clip.y0, &clip.x1, &clip.y1)) {
+        clip.x0 = clip.y0 = clip.x1 = clip.y1 = 0;
+    }
+    canvas->clips[canvas->clip_count++] = clip;
+    return 1;
+}
+
+void canvas_pop_clip(Canvas* canvas) {
+    if (!canvas || canvas->clip_count == 0) {
+        return;
+    }
+
+    canvas->clip_count--;
+}
+
+int canvas_get_clip(const Canvas* canvas, int* x, int* y, int* width, int* height) {
+    if (!canvas) {
+        return 0;
+    }
+
+    CanvasClip clip = canvas_active_clip(canvas);
+    if (x) *x = clip.x0 + canvas->origin_x;
+    if (y) *y = clip.y0 + canvas->origin_y;
+    if (width) *width = clip.x1 - clip.x0;
+    if (height) *height = clip.y1 - clip.y0;
+    return clip.x1 > clip.x0 && clip.y1 > clip.y0;
+}
+
+/* Shared by canvas_draw_canvas and canvas_draw_canvas_premultiplied */
+static void draw_canvas(Canvas* canvas, const Canvas* source, int x, int y, int premultiplied) {
+    if (!canvas || !source) {
+        return;
+    }
+
+    /* Destination pixels the source covers, clipped; then the matching source pixels */
+    int x0, y0, x1, y1;
+    if (!canvas_clip_rect(canvas, x, y, source->width, source->height, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+    int src_x0 = (int)(x0 - ((long long)x - canvas->origin_x));
+    int src_y0 = (int)(y0 - ((long long)y - canvas->origin_y));
+
+    size_t count = (size_t)(x1 - x0);
+    for (int row = 0; row < y1 - y0; row++) {
+        const uint32_t* src = source->pixels + (size_t)(src_y0 + row) * source->width + src_x0;
+        uint32_t* dst = canvas->pixels + (size_t)(y0 + row) * canvas->width + x0;
+        switch (canvas->blend_mode) {
+        case CANVAS_BLEND_REPLACE:
+            if (premultiplied) {
+                for (size_t i = 0; i < count; i++) {
+                    dst[i] = span_unpremultiply(src[i]);
+                }
+            } else {
+                memcpy(dst, src, count * sizeof(uint32_t));
+            }
+            break;
+        case CANVAS_BLEND_PREMULTIPLIED:
+            span_composite_premultiplied(dst, src, count);
+            break;
+        default:
+            if (premultiplied) {
+                span_composite_premultiplied(dst, src, count);
+            } else {
+                span_composite(dst, src, count);
+            }
+            break;
+        }
+    }
+}
+
+void canvas_draw_canvas(Canvas* canvas, const Canvas* source, int x, int y) {
+    draw_canvas(canvas, source, x, y, 0);
+}
+
+void canvas_draw_canvas_premultiplied(Canvas* canvas, const Canvas* source, int x, int y) {
+    draw_canvas(canvas, source, x, y, 1);
+}
+
 void canvas_render(const Canvas* canvas, struct Window* window) {
     if (!canvas || !window) {
         return;
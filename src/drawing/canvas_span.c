@@ -0,0 +1,320 @@
+/**
+ * @file canvas_span.c
+ * @brief Row-span pixel kernels implementation
+ */
+
+#include "canvas_span.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CANVAS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define CANVAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* Spans of at least this many pixels (1 MiB) bypass the cache when filled,
+ * so clearing a large canvas does not first read every line it overwrites */
+#define SPAN_STREAM_THRESHOLD (256u * 1024u)
+
+void span_fill(uint32_t* dst, size_t count, uint32_t value) {
+#if defined(CANVAS_SSE2) || defined(CANVAS_NEON)
+    /* Scalar head up to a 16-byte boundary so the vector loop uses aligned stores */
+    while (count > 0 && ((uintptr_t)dst & 15) != 0) {
+        *dst++ = value;
+        count--;
+    }
+#endif
+
+#ifdef CANVAS_SSE2
+    __m128i v = _mm_set1_epi32((int)value);
+    if (count >= SPAN_STREAM_THRESHOLD) {
+        for (; count >= 16; count -= 16, dst += 16) {
+            _mm_stream_si128((__m128i*)dst, v);
+            _mm_stream_si128((__m128i*)(dst + 4), v);
+            _mm_stream_si128((__m128i*)(dst + 8), v);
+            _mm_stream_si128((__m128i*)(dst + 12), v);
+        }
+        _mm_sfence(); /* Order the streaming stores before any later normal ones */
+    }
+    for (; count >= 16; count -= 16, dst += 16) {
+        _mm_store_si128((__m128i*)dst, v);
+        _mm_store_si128((__m128i*)(dst + 4), v);
+        _mm_store_si128((__m128i*)(dst + 8), v);
+        _mm_store_si128((__m128i*)(dst + 12), v);
+    }
+    for (; count >= 4; count -= 4, dst += 4) {
+        _mm_store_si128((__m128i*)dst, v);
+    }
+#elif defined(CANVAS_NEON)
+    uint32x4_t v = vdupq_n_u32(value);
+    for (; count >= 16; count -= 16, dst += 16) {
+        vst1q_u32(dst, v);
+        vst1q_u32(dst + 4, v);
+        vst1q_u32(dst + 8, v);
+        vst1q_u32(dst + 12, v);
+    }
+    for (; count >= 4; count -= 4, dst += 4) {
+        vst1q_u32(dst, v);
+    }
+#endif
+
+    while (count > 0) {
+        *dst++ = value;
+        count--;
+    }
+}
+
+/* --- Blending --- */
+
+/* round(t / 255) for t in [0, 255 * 255] */
+static inline uint32_t div255(uint32_t t) {
+    t += 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+#ifdef CANVAS_SSE2
+/* The same division on eight 16-bit lanes */
+static inline __m128i div255_epu16(__m128i t) {
+    t = _mm_add_epi16(t, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/* Copies each pixel's alpha lane to its other three lanes (two pixels per register) */
+static inline __m128i broadcast_alpha_epu16(__m128i pixels) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+#endif
+
+/* dst = (dst * inv + term) / 255 per channel, with term[c] + 255 * inv <= 255 * 255 */
+static void blend_terms(uint32_t* dst, size_t count, const uint32_t term[4], uint32_t inv) {
+    size_t i = 0;
+#ifdef CANVAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vinv = _mm_set1_epi16((short)inv);
+    const __m128i vterm = _mm_set_epi16((short)term[3], (short)term[2], (short)term[1], (short)term[0],
+                                        (short)term[3], (short)term[2], (short)term[1], (short)term[0]);
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), vinv), vterm);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), vinv), vterm);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(div255_epu16(lo), div255_epu16(hi)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t d = dst[i];
+        uint32_t result = 0;
+        for (int c = 0; c < 4; c++) {
+            result |= div255(((d >> (c * 8)) & 0xFF) * inv + term[c]) << (c * 8);
+        }
+        dst[i] = result;
+    }
+}
+
+void span_blend(uint32_t* dst, size_t count, uint32_t value) {
+    uint32_t alpha = value >> 24;
+    uint32_t term[4];
+    for (int c = 0; c < 3; c++) {
+        term[c] = ((value >> (c * 8)) & 0xFF) * alpha;
+    }
+    term[3] = 255 * alpha; /* Alpha covers: a + dst_a * (255 - a) / 255 */
+    blend_terms(dst, count, term, 255 - alpha);
+}
+
+void span_blend_premultiplied(uint32_t* dst, size_t count, uint32_t value) {
+    /* value + dst * inv / 255 == (value * 255 + dst * inv) / 255 exactly, since
+     * the added term is a whole multiple of 255 */
+    uint32_t alpha = value >> 24;
+    uint32_t term[4];
+    for (int c = 0; c < 4; c++) {
+        uint32_t channel = (value >> (c * 8)) & 0xFF;
+        term[c] = (channel < alpha ? channel : alpha) * 255; /* Clamp keeps the sum in 16 bits */
+    }
+    blend_terms(dst, count, term, 255 - alpha);
+}
+
+void span_composite(uint32_t* dst, const uint32_t* src, size_t count) {
+    size_t i = 0;
+#ifdef CANVAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i lane_max = _mm_set1_epi16(255);
+    const __m128i alpha_lanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i alpha = _mm_and_si128(s, alpha_mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF) {
+            continue; /* All four transparent: common in layer margins */
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alpha_mask)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        __m128i a_lo = broadcast_alpha_epu16(s_lo);
+        __m128i a_hi = broadcast_alpha_epu16(s_hi);
+        /* Color lanes are weighted by a, the alpha lane by 255 (a <= 255, so OR sets it) */
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(s_lo, _mm_or_si128(a_lo, alpha_lanes)),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(lane_max, a_lo)));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(s_hi, _mm_or_si128(a_hi, alpha_lanes)),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(lane_max, a_hi)));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(div255_epu16(lo), div255_epu16(hi)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t s = src[i];
+        uint32_t alpha = s >> 24;
+        if (alpha == 0) {
+            continue;
+        }
+        if (alpha == 255) {
+            dst[i] = s;
+            continue;
+        }
+        uint32_t d = dst[i];
+        uint32_t result = 0;
+        for (int c = 0; c < 4; c++) {
+            uint32_t shift = (uint32_t)c * 8;
+            uint32_t weight = c == 3 ? 255 : alpha;
+            result |= div255(((s >> shift) & 0xFF) * weight + ((d >> shift) & 0xFF) * (255 - alpha)) << shift;
+        }
+        dst[i] = result;
+    }
+}
+
+void span_composite_premultiplied(uint32_t* dst, const uint32_t* src, size_t count) {
+    size_t i = 0;
+#ifdef CANVAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i lane_max = _mm_set1_epi16(255);
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF) {
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alpha_mask), alpha_mask)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i inv_lo = _mm_sub_epi16(lane_max, broadcast_alpha_epu16(_mm_unpacklo_epi8(s, zero)));
+        __m128i inv_hi = _mm_sub_epi16(lane_max, broadcast_alpha_epu16(_mm_unpackhi_epi8(s, zero)));
+        __m128i lo = div255_epu16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv_lo));
+        __m128i hi = div255_epu16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv_hi));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t s = src[i];
+        uint32_t inv = 255 - (s >> 24);
+        if (s == 0) {
+            continue;
+        }
+        if (inv == 0) {
+            dst[i] = s;
+            continue;
+        }
+        uint32_t d = dst[i];
+        uint32_t result = 0;
+        for (int c = 0; c < 4; c++) {
+            uint32_t shift = (uint32_t)c * 8;
+            uint32_t channel = ((s >> shift) & 0xFF) + div255(((d >> shift) & 0xFF) * inv);
+            result |= (channel > 255 ? 255 : channel) << shift; /* Saturate like _mm_adds_epu8 */
+        }
+        dst[i] = result;
+    }
+}
+
+/* Source pixels built per chunk by span_blend_coverage */
+#define SPAN_COVERAGE_CHUNK 64
+
+/* out[i] = value with alpha (straight) or every channel (premultiplied) scaled by coverage[i] */
+static void scale_by_coverage(uint32_t* out, const uint8_t* coverage, size_t count, uint32_t value, int premultiplied) {
+    size_t i = 0;
+#ifdef CANVAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    if (premultiplied) {
+        const __m128i channels = _mm_unpacklo_epi8(_mm_set1_epi32((int)value), zero);
+        for (; i + 4 <= count; i += 4) {
+            int bytes;
+            memcpy(&bytes, coverage + i, sizeof(bytes));
+            __m128i cov = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+            cov = _mm_unpacklo_epi16(cov, cov); /* c0 c0 c1 c1 c2 c2 c3 c3 */
+            __m128i lo = div255_epu16(_mm_mullo_epi16(channels, _mm_unpacklo_epi32(cov, cov)));
+            __m128i hi = div255_epu16(_mm_mullo_epi16(channels, _mm_unpackhi_epi32(cov, cov)));
+            _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(lo, hi));
+        }
+    } else {
+        const __m128i alpha = _mm_set1_epi16((short)(value >> 24));
+        const __m128i rgb = _mm_set1_epi32((int)(value & 0x00FFFFFFu));
+        for (; i + 4 <= count; i += 4) {
+            int bytes;
+            memcpy(&bytes, coverage + i, sizeof(bytes));
+            __m128i cov = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+            __m128i scaled = div255_epu16(_mm_mullo_epi16(cov, alpha));
+            scaled = _mm_slli_epi32(_mm_unpacklo_epi16(scaled, zero), 24);
+            _mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(rgb, scaled));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t cov = coverage[i];
+        if (premultiplied) {
+            uint32_t result = 0;
+            for (int c = 0; c < 4; c++) {
+                result |= div255(((value >> (c * 8)) & 0xFF) * cov) << (c * 8);
+            }
+            out[i] = result;
+        } else {
+            out[i] = (value & 0x00FFFFFFu) | (div255((value >> 24) * cov) << 24);
+        }
+    }
+}
+
+void span_blend_coverage(uint32_t* dst, size_t count, uint32_t value, const uint8_t* coverage,
+                         int premultiplied, int replace) {
+    uint32_t src[SPAN_COVERAGE_CHUNK];
+    while (count > 0) {
+        size_t n = count < SPAN_COVERAGE_CHUNK ? count : SPAN_COVERAGE_CHUNK;
+        scale_by_coverage(src, coverage, n, value, premultiplied);
+        if (replace) {
+            memcpy(dst, src, n * sizeof(uint32_t));
+        } else if (premultiplied) {
+            span_composite_premultiplied(dst, src, n);
+        } else {
+            span_composite(dst, src, n);
+        }
+        dst += n;
+        coverage += n;
+        count -= n;
+    }
+}
+
+uint32_t span_premultiply(uint32_t value) {
+    uint32_t alpha = value >> 24;
+    uint32_t result = alpha << 24;
+    for (int c = 0; c < 3; c++) {
+        result |= div255(((value >> (c * 8)) & 0xFF) * alpha) << (c * 8);
+    }
+    return result;
+}
+
+uint32_t span_unpremultiply(uint32_t value) {
+    uint32_t alpha = value >> 24;
+    if (alpha == 0) {
+        return 0;
+    }
+    uint32_t result = alpha << 24;
+    for (int c = 0; c < 3; c++) {
+        uint32_t channel = (((value >> (c * 8)) & 0xFF) * 255 + alpha / 2) / alpha;
+        result |= (channel > 255 ? 255 : channel) << (c * 8);
+    }
+    return result;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file canvas_span.h
+ * @brief Row-span pixel kernels behind the Canvas drawing functions
+ *
+ * Internal to the drawing module - not part of the public API. Callers clip
+ * first; the kernels write exactly the pixels they are given.
+ */
+
+#ifndef UI_FRAMEWORK_CANVAS_SPAN_H
+#define UI_FRAMEWORK_CANVAS_SPAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Set count consecutive pixels to value
+ *
+ * Uses 16-byte vector stores (SSE2 on x86, NEON on ARM) once dst is aligned.
+ * Spans too large to stay in cache are written with streaming stores.
+ *
+ * @param dst First pixel to write
+ * @param count Number of pixels
+ * @param value Packed pixel (color_to_uint32)
+ */
+void span_fill(uint32_t* dst, size_t count, uint32_t value);
+
+/*
+ * Blend kernels. Every channel, alpha included, is computed in 16-bit integer
+ * lanes (four pixels per SSE2 register pair) and divided by 255 with the
+ * exact rounding (t + 128 + ((t + 128) >> 8)) >> 8, so results match
+ * (t + 127) / 255 bit for bit.
+ */
+
+/**
+ * @brief Blend a straight-alpha color over count pixels
+ *
+ * dst = (value * a + dst * (255 - a)) / 255 on the color channels and
+ * (255 * a + dst * (255 - a)) / 255 on alpha, the same "over" as
+ * canvas_draw_canvas. Opaque pixels stay opaque.
+ */
+void span_blend(uint32_t* dst, size_t count, uint32_t value);
+
+/**
+ * @brief Blend a premultiplied color over count premultiplied pixels
+ *
+ * dst = value + dst * (255 - a) / 255 on all four channels.
+ */
+void span_blend_premultiplied(uint32_t* dst, size_t count, uint32_t value);
+
+/**
+ * @brief Blend count straight-alpha source pixels over dst, pixel by pixel
+ *
+ * Each pixel combines like span_blend.
+ */
+void span_composite(uint32_t* dst, const uint32_t* src, size_t count);
+
+/**
+ * @brief Blend count premultiplied source pixels over premultiplied dst
+ */
+void span_composite_premultiplied(uint32_t* dst, const uint32_t* src, size_t count);
+
+/**
+ * @brief Blend a color over count pixels, scaled per pixel by coverage
+ *
+ * Pixel i is drawn as value with its alpha multiplied by coverage[i] / 255
+ * (all four channels when premultiplied), then combined like
+ * span_composite or span_composite_premultiplied, or stored when replace
+ * is nonzero.
+ *
+ * @param value Straight color, or premultiplied if premultiplied is nonzero
+ */
+void span_blend_coverage(uint32_t* dst, size_t count, uint32_t value, const uint8_t* coverage,
+                         int premultiplied, int replace);
+
+/**
+ * @brief Premultiply the color channels of a straight-alpha pixel by its alpha
+ */
+uint32_t span_premultiply(uint32_t value);
+
+/**
+ * @brief Convert a premultiplied pixel back to straight alpha
+ *
+ * Fully transparent pixels become 0.
+ */
+uint32_t span_unpremultiply(uint32_t value);
+
+#endif /* UI_FRAMEWORK_CANVAS_SPAN_H */
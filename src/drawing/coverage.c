@@ -0,0 +1,182 @@
+/**
+ * @file coverage.c
+ * @brief Anti-aliasing coverage kernels implementation
+ */
+
+#include "coverage.h"
+
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COVERAGE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* Keeps the distance finite at the exact center of a tiny ellipse */
+#define COVERAGE_MIN_GRADIENT 1e-6f
+
+/* Coverage in [0, 1] (clamped here) to a byte */
+static inline uint8_t coverage_byte(float c) {
+    c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+    return (uint8_t)(c * 255.0f + 0.5f);
+}
+
+/* Signed distance estimate to the ellipse edge from squared offsets
+ * pre-scaled by 1/rx^2 and 1/ry^2: k0 = |(x/a, y/b)|, k1 = |(x/a^2, y/b^2)| */
+static inline float ellipse_distance(float x0, float y0, float inv_rx2, float y1) {
+    float k0 = sqrtf(x0 + y0);
+    float k1 = sqrtf(x0 * inv_rx2 + y1);
+    return k0 * (k0 - 1.0f) / (k1 > COVERAGE_MIN_GRADIENT ? k1 : COVERAGE_MIN_GRADIENT);
+}
+
+/* Distance from (u, v), in stroke axes, to the edge of the stroke */
+static inline float stroke_distance(float u, float v, const CoverageStroke* stroke) {
+    float au = fabsf(u) - stroke->half_length;
+    float av = fabsf(v);
+    if (stroke->round) {
+        /* Capsule: distance to the center segment */
+        au = au > 0.0f ? au : 0.0f;
+        return sqrtf(au * au + av * av) - stroke->half_width;
+    }
+    /* Box */
+    av -= stroke->half_width;
+    float ou = au > 0.0f ? au : 0.0f;
+    float ov = av > 0.0f ? av : 0.0f;
+    float inside = au > av ? au : av;
+    return sqrtf(ou * ou + ov * ov) + (inside < 0.0f ? inside : 0.0f);
+}
+
+#ifdef COVERAGE_SSE2
+/* Four coverage values in [0, 1] (clamped here) to bytes in the low 32 bits */
+static inline int coverage_bytes4(__m128 c) {
+    c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    __m128i v = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+    v = _mm_packs_epi32(v, v);
+    return _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+}
+
+static inline void store_bytes4(uint8_t* out, int bytes) {
+    out[0] = (uint8_t)bytes;
+    out[1] = (uint8_t)(bytes >> 8);
+    out[2] = (uint8_t)(bytes >> 16);
+    out[3] = (uint8_t)(bytes >> 24);
+}
+
+/* x + i .. x + i + 3 from an integer index, rather than a running sum,
+ * which would drift from the scalar path */
+static inline __m128 lane_positions(float x, int i) {
+    return _mm_add_ps(_mm_set1_ps(x), _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(i), _mm_set_epi32(3, 2, 1, 0))));
+}
+
+static inline __m128 abs_ps(__m128 v) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+static inline __m128 ellipse_distance4(__m128 x0, __m128 y0, __m128 inv_rx2, __m128 y1) {
+    __m128 k0 = _mm_sqrt_ps(_mm_add_ps(x0, y0));
+    __m128 k1 = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x0, inv_rx2), y1));
+    k1 = _mm_max_ps(k1, _mm_set1_ps(COVERAGE_MIN_GRADIENT));
+    return _mm_div_ps(_mm_mul_ps(k0, _mm_sub_ps(k0, _mm_set1_ps(1.0f))), k1);
+}
+#endif
+
+void coverage_ellipse_row(uint8_t* out, int count, float x, float y, float inv_rx2, float inv_ry2) {
+    /* The row's y terms are shared */
+    float y0 = y * y * inv_ry2;
+    float y1 = y0 * inv_ry2;
+    int i = 0;
+#ifdef COVERAGE_SSE2
+    const __m128 vinv_rx2 = _mm_set1_ps(inv_rx2);
+    const __m128 vy0 = _mm_set1_ps(y0);
+    const __m128 vy1 = _mm_set1_ps(y1);
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = lane_positions(x, i);
+        __m128 x0 = _mm_mul_ps(_mm_mul_ps(vx, vx), vinv_rx2);
+        __m128 distance = ellipse_distance4(x0, vy0, vinv_rx2, vy1);
+        store_bytes4(out + i, coverage_bytes4(_mm_sub_ps(_mm_set1_ps(0.5f), distance)));
+    }
+#endif
+    for (; i < count; i++) {
+        float px = x + (float)i;
+        out[i] = coverage_byte(0.5f - ellipse_distance(px * px * inv_rx2, y0, inv_rx2, y1));
+    }
+}
+
+void coverage_ring_row(uint8_t* out, int count, float x, float y, float inv_rx2, float inv_ry2, float half_width) {
+    float y0 = y * y * inv_ry2;
+    float y1 = y0 * inv_ry2;
+    float reach = half_width + 0.5f;
+    int i = 0;
+#ifdef COVERAGE_SSE2
+    const __m128 vinv_rx2 = _mm_set1_ps(inv_rx2);
+    const __m128 vy0 = _mm_set1_ps(y0);
+    const __m128 vy1 = _mm_set1_ps(y1);
+    const __m128 vreach = _mm_set1_ps(reach);
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = lane_positions(x, i);
+        __m128 x0 = _mm_mul_ps(_mm_mul_ps(vx, vx), vinv_rx2);
+        __m128 distance = abs_ps(ellipse_distance4(x0, vy0, vinv_rx2, vy1));
+        store_bytes4(out + i, coverage_bytes4(_mm_sub_ps(vreach, distance)));
+    }
+#endif
+    for (; i < count; i++) {
+        float px = x + (float)i;
+        out[i] = coverage_byte(reach - fabsf(ellipse_distance(px * px * inv_rx2, y0, inv_rx2, y1)));
+    }
+}
+
+void coverage_stroke_row(uint8_t* out, int count, float x, float y, const CoverageStroke* stroke) {
+    /* u along the stroke, v across it: u = x ax + y ay, v = y ax - x ay */
+    float u_row = y * stroke->ay;
+    float v_row = y * stroke->ax;
+    int i = 0;
+#ifdef COVERAGE_SSE2
+    const __m128 ax = _mm_set1_ps(stroke->ax);
+    const __m128 ay = _mm_set1_ps(stroke->ay);
+    const __m128 vu_row = _mm_set1_ps(u_row);
+    const __m128 vv_row = _mm_set1_ps(v_row);
+    const __m128 half_length = _mm_set1_ps(stroke->half_length);
+    const __m128 half_width = _mm_set1_ps(stroke->half_width);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = lane_positions(x, i);
+        __m128 au = _mm_sub_ps(abs_ps(_mm_add_ps(_mm_mul_ps(vx, ax), vu_row)), half_length);
+        __m128 av = abs_ps(_mm_sub_ps(vv_row, _mm_mul_ps(vx, ay)));
+        __m128 distance;
+        if (stroke->round) {
+            au = _mm_max_ps(au, zero);
+            distance = _mm_sub_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(au, au), _mm_mul_ps(av, av))), half_width);
+        } else {
+            av = _mm_sub_ps(av, half_width);
+            __m128 ou = _mm_max_ps(au, zero);
+            __m128 ov = _mm_max_ps(av, zero);
+            __m128 inside = _mm_min_ps(_mm_max_ps(au, av), zero);
+            distance = _mm_add_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ou, ou), _mm_mul_ps(ov, ov))), inside);
+        }
+        store_bytes4(out + i, coverage_bytes4(_mm_sub_ps(_mm_set1_ps(0.5f), distance)));
+    }
+#endif
+    for (; i < count; i++) {
+        float px = x + (float)i;
+        float u = px * stroke->ax + u_row;
+        float v = v_row - px * stroke->ay;
+        out[i] = coverage_byte(0.5f - stroke_distance(u, v, stroke));
+    }
+}
+
+void coverage_tent_row(uint8_t* out, int count, float t, float dt) {
+    int i = 0;
+#ifdef COVERAGE_SSE2
+    const __m128 vt = _mm_set1_ps(t);
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 index = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(i), _mm_set_epi32(3, 2, 1, 0)));
+        __m128 offset = _mm_add_ps(vt, _mm_mul_ps(vdt, index));
+        store_bytes4(out + i, coverage_bytes4(_mm_sub_ps(one, abs_ps(offset))));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = coverage_byte(1.0f - fabsf(t + dt * (float)i));
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file coverage.h
+ * @brief Anti-aliasing coverage kernels for the drawing primitives
+ *
+ * Internal to the drawing module - not part of the public API. Each kernel
+ * writes one coverage byte per pixel (0 = untouched, 255 = fully covered)
+ * for canvas_fill_span_coverage, four pixels per step where SSE2 is
+ * available; the scalar path evaluates the same expressions.
+ */
+
+#ifndef UI_FRAMEWORK_COVERAGE_H
+#define UI_FRAMEWORK_COVERAGE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Coverage of a run of pixels on one row of a filled ellipse
+ *
+ * Coverage is 0.5 minus the signed distance from the pixel center to the
+ * edge (negative inside), clamped to [0, 1]. The distance is the usual
+ * first-order estimate k0 (k0 - 1) / k1, exact for circles.
+ *
+ * @param out count coverage bytes
+ * @param count Number of pixels
+ * @param x Horizontal offset of the first pixel center from the ellipse center
+ * @param y Vertical offset of the row from the ellipse center
+ * @param inv_rx2 1 / radiusX^2
+ * @param inv_ry2 1 / radiusY^2
+ */
+void coverage_ellipse_row(uint8_t* out, int count, float x, float y, float inv_rx2, float inv_ry2);
+
+/**
+ * @brief Coverage of a run of pixels on one row of an ellipse outline
+ *
+ * As coverage_ellipse_row, for a stroke half_width either side of the
+ * edge: half_width + 0.5 minus the unsigned distance.
+ */
+void coverage_ring_row(uint8_t* out, int count, float x, float y, float inv_rx2, float inv_ry2, float half_width);
+
+/**
+ * @brief A straight stroke centered on the origin
+ */
+typedef struct {
+    float ax;          /**< Unit direction of the stroke */
+    float ay;
+    float half_length; /**< Extent either side of the center along (ax, ay) */
+    float half_width;  /**< Extent either side of the center line */
+    int round;         /**< Nonzero for a capsule (round ends) instead of a box */
+} CoverageStroke;
+
+/**
+ * @brief Coverage of a run of pixels on one row of a stroke
+ *
+ * 0.5 minus the exact signed distance to the box or capsule.
+ *
+ * @param x Horizontal offset of the first pixel center from the stroke center
+ * @param y Vertical offset of the row from the stroke center
+ */
+void coverage_stroke_row(uint8_t* out, int count, float x, float y, const CoverageStroke* stroke);
+
+/**
+ * @brief Tent-filter coverage 1 - |t + dt * i| for pixels i = 0 .. count - 1
+ *
+ * The Wu line weight: t is the distance across the line from the first
+ * pixel center to the line, dt how it changes per pixel.
+ */
+void coverage_tent_row(uint8_t* out, int count, float t, float dt);
+
+#endif /* UI_FRAMEWORK_COVERAGE_H */
@@ -4,61 +4,251 @@
  */
 
 #include "../../include/ui_framework/drawing/primitives.h"
+#include "coverage.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
 
+/**
+ * @brief The active clip as inclusive drawing-coordinate bounds
+ */
+typedef struct {
+    int left;
+    int top;
+    int right;
+    int bottom;
+} ClipBounds;
+
+/* Returns nonzero if the active clip contains any pixel */
+static int clip_bounds(const Canvas* canvas, ClipBounds* clip) {
+    int width, height;
+    if (!canvas_get_clip(canvas, &clip->left, &clip->top, &width, &height)) {
+        return 0;
+    }
+    clip->right = clip->left + width - 1;
+    clip->bottom = clip->top + height - 1;
+    return 1;
+}
+
+/**
+ * @brief The integers in [lo, hi] that lie within [min, max]
+ *
+ * Works in doubles, so coordinates far outside the int range (or NaN)
+ * never reach an int conversion.
+ *
+ * @return int Nonzero if there are any
+ */
+static int clip_range(double lo, double hi, int min, int max, int* first, int* last) {
+    lo = ceil(lo);
+    hi = floor(hi);
+    if (lo < min) lo = min;
+    if (hi > max) hi = max;
+    if (!(lo <= hi)) {
+        return 0;
+    }
+    *first = (int)lo;
+    *last = (int)hi;
+    return 1;
+}
+
 void draw_pixel(Canvas* canvas, int x, int y, Color color) {
-    canvas_set_pixel(canvas, x, y, color);
+    canvas_fill_span(canvas, x, y, 1, color);
+}
+
+/**
+ * @brief Fill the pixels between xa and xb (inclusive, either order) on row y
+ */
+static void draw_run(Canvas* canvas, int xa, int xb, int y, Color color) {
+    if (xa > xb) {
+        int t = xa;
+        xa = xb;
+        xb = t;
+    }
+    canvas_fill_span(canvas, xa, y, xb - xa + 1, color);
+}
+
+/* Cohen-Sutherland outcode bits */
+#define OUT_LEFT 1
+#define OUT_RIGHT 2
+#define OUT_TOP 4
+#define OUT_BOTTOM 8
+
+static int outcode(double x, double y, double left, double top, double right, double bottom) {
+    int code = 0;
+    if (x < left) {
+        code |= OUT_LEFT;
+    } else if (x > right) {
+        code |= OUT_RIGHT;
+    }
+    if (y < top) {
+        code |= OUT_TOP;
+    } else if (y > bottom) {
+        code |= OUT_BOTTOM;
+    }
+    return code;
+}
+
+/**
+ * @brief Clip a segment to a rectangle (Cohen-Sutherland), in place
+ *
+ * @return int Nonzero if any part of the segment is inside
+ */
+static int clip_segment(double* x1, double* y1, double* x2, double* y2,
+                        double left, double top, double right, double bottom) {
+    int code1 = outcode(*x1, *y1, left, top, right, bottom);
+    int code2 = outcode(*x2, *y2, left, top, right, bottom);
+    while (code1 | code2) {
+        if (code1 & code2) {
+            return 0; /* Both ends beyond the same edge */
+        }
+
+        /* Move an outside end onto the edge it is beyond */
+        int code = code1 ? code1 : code2;
+        double x, y;
+        if (code & OUT_TOP) {
+            x = *x1 + (*x2 - *x1) * (top - *y1) / (*y2 - *y1);
+            y = top;
+        } else if (code & OUT_BOTTOM) {
+            x = *x1 + (*x2 - *x1) * (bottom - *y1) / (*y2 - *y1);
+            y = bottom;
+        } else if (code & OUT_LEFT) {
+            y = *y1 + (*y2 - *y1) * (left - *x1) / (*x2 - *x1);
+            x = left;
+        } else {
+            y = *y1 + (*y2 - *y1) * (right - *x1) / (*x2 - *x1);
+            x = right;
+        }
+        if (code == code1) {
+            *x1 = x;
+            *y1 = y;
+            code1 = outcode(x, y, left, top, right, bottom);
+        } else {
+            *x2 = x;
+            *y2 = y;
+            code2 = outcode(x, y, left, top, right, bottom);
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief q = k * m / d and r = k * m % d for operands below 2^33
+ *
+ * k * m itself can need 66 bits, so it is divided in two 16-bit halves of m.
+ */
+static void mul_div(unsigned long long k, unsigned long long m, unsigned long long d,
+                    unsigned long long* q, unsigned long long* r) {
+    unsigned long long high = k * (m >> 16);
+    unsigned long long low = (high % d << 16) + k * (m & 0xFFFF);
+    *q = (high / d << 16) + low / d;
+    *r = low % d;
 }
 
 void draw_line(Canvas* canvas, int x1, int y1, int x2, int y2, Color color) {
-    // Bresenham's line algorithm
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
+    ClipBounds clip;
+    if (!clip_bounds(canvas, &clip)) {
+        return;
+    }
+
+    if (x1 == x2) {
+        /* Vertical: a one-pixel-wide rectangle */
+        int top, bottom;
+        if (x1 < clip.left || x1 > clip.right ||
+            !clip_range(y1 < y2 ? y1 : y2, y1 < y2 ? y2 : y1, clip.top, clip.bottom, &top, &bottom)) {
+            return;
+        }
+        canvas_fill_rect(canvas, x1, top, 1, bottom - top + 1, color);
+        return;
+    }
+
+    /* Clip the segment to the clip grown by a pixel, which holds every
+     * pixel Bresenham plots for the part inside the clip; only the major
+     * steps k_first..k_last of the clipped part are walked */
+    double cx1 = x1, cy1 = y1, cx2 = x2, cy2 = y2;
+    if (!clip_segment(&cx1, &cy1, &cx2, &cy2, clip.left - 1.0, clip.top - 1.0,
+                      clip.right + 1.0, clip.bottom + 1.0)) {
+        return;
+    }
+
+    // Bresenham's line algorithm, in 64 bits so any int endpoints work
+    long long dx = llabs((long long)x2 - x1);
+    long long dy = llabs((long long)y2 - y1);
     int sx = (x1 < x2) ? 1 : -1;
     int sy = (y1 < y2) ? 1 : -1;
-    int err = dx - dy;
+    int x_major = dx >= dy;
+    long long major = x_major ? dx : dy;
+    double k1 = x_major ? fabs(cx1 - x1) : fabs(cy1 - y1);
+    double k2 = x_major ? fabs(cx2 - x1) : fabs(cy2 - y1);
+    double k_first = floor(fmin(k1, k2)) - 1.0;
+    double k_last = ceil(fmax(k1, k2)) + 1.0;
+    long long k = k_first > 0.0 ? (long long)k_first : 0;
+    long long k_end = k_last < (double)major ? (long long)k_last : major;
+
+    /* Jump to major step k: the minor offset there is
+     * floor((2 k minor + major - 1) / (2 major)), and err = dx - dy - |x - x1| dy + |y - y1| dx */
+    unsigned long long q, r;
+    mul_div((unsigned long long)k, (unsigned long long)(x_major ? dy : dx), (unsigned long long)major, &q, &r);
+    long long c = (2 * (long long)r + major - 1) / (2 * major);
+    long long b = (long long)q + c;
+    long long x = x1 + (long long)sx * (x_major ? k : b);
+    long long y = y1 + (long long)sy * (x_major ? b : k);
+    long long err = x_major ? dx - dy + c * dx - (long long)r : dx - dy - c * dy + (long long)r;
+    long long end = x_major ? x1 + (long long)sx * k_end : y1 + (long long)sy * k_end;
+    long long run_x = x; /* First pixel of the run on the current row */
     
     while (1) {
-        canvas_set_pixel(canvas, x1, y1, color);
-        
-        if (x1 == x2 && y1 == y2) {
+        if ((x_major ? x : y) == end) {
+            draw_run(canvas, (int)run_x, (int)x, (int)y, color);
             break;
         }
         
-        int e2 = 2 * err;
+        /* Pixels are emitted as one span per row instead of one at a time */
+        long long e2 = 2 * err;
+        int step_y = e2 < dx;
+        if (step_y) {
+            draw_run(canvas, (int)run_x, (int)x, (int)y, color);
+        }
         if (e2 > -dy) {
             err -= dy;
-            x1 += sx;
+            x += sx;
         }
-        if (e2 < dx) {
+        if (step_y) {
             err += dx;
-            y1 += sy;
+            y += sy;
+            run_x = x;
         }
     }
 }
 
 void draw_rectangle(Canvas* canvas, int x, int y, int width, int height, Color color) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
     // Draw horizontal lines
-    for (int i = x; i < x + width; i++) {
-        canvas_set_pixel(canvas, i, y, color);
-        canvas_set_pixel(canvas, i, y + height - 1, color);
+    canvas_fill_rect(canvas, x, y, width, 1, color);
+    if (height > 1) {
+        canvas_fill_rect(canvas, x, y + height - 1, width, 1, color);
     }
     
-    // Draw vertical lines
-    for (int i = y; i < y + height; i++) {
-        canvas_set_pixel(canvas, x, i, color);
-        canvas_set_pixel(canvas, x + width - 1, i, color);
+    // Draw vertical lines between them, so no pixel is drawn twice
+    if (height > 2) {
+        canvas_fill_rect(canvas, x, y + 1, 1, height - 2, color);
+        if (width > 1) {
+            canvas_fill_rect(canvas, x + width - 1, y + 1, 1, height - 2, color);
+        }
     }
 }
 
 void draw_filled_rectangle(Canvas* canvas, int x, int y, int width, int height, Color color) {
-    for (int j = y; j < y + height; j++) {
-        for (int i = x; i < x + width; i++) {
-            canvas_set_pixel(canvas, i, j, color);
-        }
+    canvas_fill_rect(canvas, x, y, width, height, color);
+}
+
+/* Plots a pixel of the midpoint circle, skipping the call when it is clipped */
+static inline void plot_clipped(Canvas* canvas, const ClipBounds* clip, int x, int y, Color color) {
+    if (x >= clip->left && x <= clip->right && y >= clip->top && y <= clip->bottom) {
+        canvas_fill_span(canvas, x, y, 1, color);
     }
 }
 
@@ -70,10 +260,32 @@ void draw_circle(Canvas* canvas, int x, int y, int radius, Color color) {
     int x_pos = 0;
     int y_pos = radius;
     
-    canvas_set_pixel(canvas, x, y + radius, color);
-    canvas_set_pixel(canvas, x, y - radius, color);
-    canvas_set_pixel(canvas, x + radius, y, color);
-    canvas_set_pixel(canvas, x - radius, y, color);
+    ClipBounds clip;
+    if (radius < 0 || !clip_bounds(canvas, &clip)) {
+        return;
+    }
+
+    /* Nothing to plot if the clip misses the bounding box, or lies inside
+     * the circle of radius - 1, which the plotted pixels all stay outside */
+    if ((long long)x + radius < clip.left || (long long)x - radius > clip.right ||
+        (long long)y + radius < clip.top || (long long)y - radius > clip.bottom) {
+        return;
+    }
+    double far_x = fmax(fabs((double)clip.left - x), fabs((double)clip.right - x));
+    double far_y = fmax(fabs((double)clip.top - y), fabs((double)clip.bottom - y));
+    if (radius > 0 && far_x * far_x + far_y * far_y <= ((double)radius - 1.0) * ((double)radius - 1.0)) {
+        return;
+    }
+
+    if (radius == 0) {
+        plot_clipped(canvas, &clip, x, y, color);
+        return;
+    }
+
+    plot_clipped(canvas, &clip, x, y + radius, color);
+    plot_clipped(canvas, &clip, x, y - radius, color);
+    plot_clipped(canvas, &clip, x + radius, y, color);
+    plot_clipped(canvas, &clip, x - radius, y, color);
     
     while (x_pos < y_pos) {
         if (f >= 0) {
@@ -85,51 +297,673 @@ void draw_circle(Canvas* canvas, int x, int y, int radius, Color color) {
         ddF_x += 2;
         f += ddF_x + 1;
         
-        canvas_set_pixel(canvas, x + x_pos, y + y_pos, color);
-        canvas_set_pixel(canvas, x - x_pos, y + y_pos, color);
-        canvas_set_pixel(canvas, x + x_pos, y - y_pos, color);
-        canvas_set_pixel(canvas, x - x_pos, y - y_pos, color);
-        canvas_set_pixel(canvas, x + y_pos, y + x_pos, color);
-        canvas_set_pixel(canvas, x - y_pos, y + x_pos, color);
-        canvas_set_pixel(canvas, x + y_pos, y - x_pos, color);
-        canvas_set_pixel(canvas, x - y_pos, y - x_pos, color);
+        /* Each pixel is plotted once, so translucent colors blend evenly:
+         * past the diagonal the octants repeat earlier points, and on it
+         * the two point sets coincide */
+        if (x_pos > y_pos) {
+            break;
+        }
+        plot_clipped(canvas, &clip, x + x_pos, y + y_pos, color);
+        plot_clipped(canvas, &clip, x - x_pos, y + y_pos, color);
+        plot_clipped(canvas, &clip, x + x_pos, y - y_pos, color);
+        plot_clipped(canvas, &clip, x - x_pos, y - y_pos, color);
+        if (x_pos == y_pos) {
+            break;
+        }
+        plot_clipped(canvas, &clip, x + y_pos, y + x_pos, color);
+        plot_clipped(canvas, &clip, x - y_pos, y + x_pos, color);
+        plot_clipped(canvas, &clip, x + y_pos, y - x_pos, color);
+        plot_clipped(canvas, &clip, x - y_pos, y - x_pos, color);
     }
 }
 
-void draw_filled_circle(Canvas* canvas, int x, int y, int radius, Color color) {
-    for (int j = -radius; j <= radius; j++) {
-        for (int i = -radius; i <= radius; i++) {
-            if (i*i + j*j <= radius*radius) {
-                canvas_set_pixel(canvas, x + i, y + j, color);
-            }
+/**
+ * @brief Walks the rows of the region i^2 wx + j^2 wy <= limit outward from
+ *        its center row, tracking each row's half-width (the largest such i)
+ * 
+ * Stepping to the next row and narrowing the half-width each adjust the
+ * running value of i^2 wx + j^2 wy - limit by an addition, so a shape costs
+ * a few additions per row and no per-pixel tests; a row that narrows by more
+ * than a pixel starts from a square-root estimate instead of stepping.
+ * Ellipses whose terms would not fit 64 bits are solved row by row with an
+ * exact wide comparison.
+ */
+typedef struct {
+    long long f; /* half^2 wx + j^2 wy - limit, <= 0 (unused when wide) */
+    long long wx;
+    long long wy;
+    int half;
+    int j;
+    int wide;    /* Solve each row of the ellipse rx, ry directly */
+    int rx;
+    int ry;
+} ShapeRows;
+
+static void shape_rows_init(ShapeRows* rows, int half, long long wx, long long wy, long long limit) {
+    rows->wx = wx;
+    rows->wy = wy;
+    rows->half = half;
+    rows->j = 0;
+    rows->wide = 0;
+    rows->f = (long long)half * half * wx - limit;
+}
+
+/* a * b in full, as high and low 64-bit halves */
+static void mul_wide(unsigned long long a, unsigned long long b, unsigned long long* high, unsigned long long* low) {
+    unsigned long long a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+    unsigned long long b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+    unsigned long long lo_lo = a_lo * b_lo;
+    unsigned long long lo_hi = a_lo * b_hi;
+    unsigned long long hi_lo = a_hi * b_lo;
+    unsigned long long mid = (lo_lo >> 32) + (lo_hi & 0xFFFFFFFFULL) + (hi_lo & 0xFFFFFFFFULL);
+    *low = (mid << 32) | (lo_lo & 0xFFFFFFFFULL);
+    *high = a_hi * b_hi + (lo_hi >> 32) + (hi_lo >> 32) + (mid >> 32);
+}
+
+/* Whether column i of row j is inside the ellipse: (i ry)^2 <= rx^2 (ry^2 - j^2) */
+static int ellipse_row_contains(long long rx, long long ry, long long i, long long j) {
+    unsigned long long inside_high, inside_low, limit_high, limit_low;
+    mul_wide((unsigned long long)(i * ry), (unsigned long long)(i * ry), &inside_high, &inside_low);
+    mul_wide((unsigned long long)(rx * rx), (unsigned long long)((ry - j) * (ry + j)), &limit_high, &limit_low);
+    return inside_high < limit_high || (inside_high == limit_high && inside_low <= limit_low);
+}
+
+/* Settles the half-width of the current row, no wider than the last one */
+static void shape_rows_settle(ShapeRows* rows) {
+    long long half = rows->half;
+    long long estimate;
+    if (rows->wide) {
+        double t = (double)rows->j / rows->ry;
+        estimate = (long long)((double)rows->rx * sqrt(fmax(1.0 - t * t, 0.0)));
+        if (estimate > half) {
+            estimate = half;
+        }
+        while (estimate > 0 && !ellipse_row_contains(rows->rx, rows->ry, estimate, rows->j)) {
+            estimate--;
         }
+        while (estimate < half && ellipse_row_contains(rows->rx, rows->ry, estimate + 1, rows->j)) {
+            estimate++;
+        }
+        rows->half = (int)estimate;
+        return;
+    }
+
+    if (rows->f <= 0) {
+        return;
+    }
+    if (rows->f <= (2 * half - 1) * rows->wx) {
+        /* One column narrower */
+        rows->f -= (2 * half - 1) * rows->wx;
+        rows->half--;
+        return;
+    }
+
+    /* Estimate from the row's limit - j^2 wy, then settle it exactly */
+    double room = ((double)half * half * rows->wx - (double)rows->f) / (double)rows->wx;
+    estimate = room > 0.0 ? (long long)sqrt(room) : 0;
+    if (estimate > half) {
+        estimate = half;
+    }
+    rows->f += (estimate * estimate - half * half) * rows->wx;
+    while (rows->f > 0 && estimate > 0) {
+        rows->f -= (2 * estimate - 1) * rows->wx;
+        estimate--;
+    }
+    while (estimate < half && rows->f + (2 * estimate + 1) * rows->wx <= 0) {
+        rows->f += (2 * estimate + 1) * rows->wx;
+        estimate++;
+    }
+    rows->half = (int)estimate;
+}
+
+/* Advances to the next row and returns its half-width; only valid while
+ * that row is inside the shape */
+static int shape_rows_next(ShapeRows* rows) {
+    if (!rows->wide) {
+        rows->f += (2LL * rows->j + 1) * rows->wy;
     }
+    rows->j++;
+    shape_rows_settle(rows);
+    return rows->half;
+}
+
+/* Jumps from the current row to row j, further out and still inside the
+ * shape, without walking the rows in between */
+static int shape_rows_seek(ShapeRows* rows, int j) {
+    if (!rows->wide) {
+        long long j0 = rows->j;
+        rows->f += ((long long)j * j - j0 * j0) * rows->wy;
+    }
+    rows->j = j;
+    shape_rows_settle(rows);
+    return rows->half;
+}
+
+/**
+ * @brief Offsets j in 0..radius for which row y + j or y - j is inside the clip
+ *
+ * @return int Nonzero if there are any
+ */
+static int clip_row_offsets(const ClipBounds* clip, int y, int radius, int* first, int* last) {
+    double top = (double)clip->top - y;
+    double bottom = (double)clip->bottom - y;
+    if (top > 0.0) {
+        return clip_range(top, bottom, 0, radius, first, last);
+    }
+    if (bottom < 0.0) {
+        return clip_range(-bottom, -top, 0, radius, first, last);
+    }
+    return clip_range(0.0, fmax(-top, bottom), 0, radius, first, last);
+}
+
+/* Rows of the filled ellipse i^2 ry^2 + j^2 rx^2 <= rx^2 ry^2 (a circle when the radii match) */
+static void shape_rows_ellipse(ShapeRows* rows, int radiusX, int radiusY) {
+    if (radiusX == radiusY) {
+        shape_rows_init(rows, radiusX, 1, 1, (long long)radiusX * radiusX);
+        return;
+    }
+
+    /* The running terms reach limit, (2 ry + 1) rx^2 and (2 rx + 1) ry^2 */
+    double rx = radiusX, ry = radiusY;
+    double largest = fmax(rx * rx * ry * ry, fmax((2.0 * ry + 1.0) * rx * rx, (2.0 * rx + 1.0) * ry * ry));
+    if (largest >= 0x1p62) {
+        shape_rows_init(rows, radiusX, 0, 0, 0);
+        rows->wide = 1;
+        rows->rx = radiusX;
+        rows->ry = radiusY;
+        return;
+    }
+    long long rx2 = (long long)radiusX * radiusX;
+    long long ry2 = (long long)radiusY * radiusY;
+    shape_rows_init(rows, radiusX, ry2, rx2, rx2 * ry2);
+}
+
+/* Fills columns x0..x1 of a row, clipped first, so the spans of shapes far
+ * wider than the int range never overflow a width */
+static void fill_run_clipped(Canvas* canvas, const ClipBounds* clip, long long x0, long long x1, long long row,
+                             Color color) {
+    if (row < clip->top || row > clip->bottom) {
+        return;
+    }
+    if (x0 < clip->left) x0 = clip->left;
+    if (x1 > clip->right) x1 = clip->right;
+    if (x0 > x1) {
+        return;
+    }
+    canvas_fill_span(canvas, (int)x0, (int)row, (int)(x1 - x0 + 1), color);
+}
+
+void draw_filled_circle(Canvas* canvas, int x, int y, int radius, Color color) {
+    draw_filled_ellipse(canvas, x, y, radius, radius, color);
 }
 
 void draw_ellipse(Canvas* canvas, int x, int y, int radiusX, int radiusY, Color color) {
-    // Simple approximation with points at regular angle intervals
-    const int num_segments = 36;
-    float theta = 0;
-    float step = 2.0f * 3.14159f / num_segments;
-    
-    for (int i = 0; i < num_segments; i++) {
-        int x1 = x + radiusX * cos(theta);
-        int y1 = y + radiusY * sin(theta);
-        theta += step;
-        int x2 = x + radiusX * cos(theta);
-        int y2 = y + radiusY * sin(theta);
-        
-        draw_line(canvas, x1, y1, x2, y2, color);
+    ClipBounds clip;
+    int first, last;
+    if (radiusX < 0 || radiusY < 0 || !clip_bounds(canvas, &clip) ||
+        !clip_row_offsets(&clip, y, radiusY, &first, &last)) {
+        return;
+    }
+
+    /* The outline is the edge of the draw_filled_ellipse area: on each row,
+     * the pixels not covered by the next row outward. Built from spans, each
+     * pixel is drawn once. Only the rows inside the clip are visited. */
+    ShapeRows rows;
+    shape_rows_ellipse(&rows, radiusX, radiusY);
+    int half = first > 0 ? shape_rows_seek(&rows, first) : rows.half;
+    for (int j = first; j <= last; j++) {
+        int next = (j < radiusY) ? shape_rows_next(&rows) : -1;
+        int start = (next + 1 < half) ? next + 1 : half; /* At least one pixel per side */
+        for (int side = 0; side < 2; side++) {
+            long long row = side ? (long long)y - j : (long long)y + j;
+            if (side && j == 0) {
+                break;
+            }
+            if (start == 0) {
+                /* The two sides meet in the middle: one span */
+                fill_run_clipped(canvas, &clip, (long long)x - half, (long long)x + half, row, color);
+            } else {
+                fill_run_clipped(canvas, &clip, (long long)x - half, (long long)x - start, row, color);
+                fill_run_clipped(canvas, &clip, (long long)x + start, (long long)x + half, row, color);
+            }
+        }
+        half = next;
     }
 }
 
 void draw_filled_ellipse(Canvas* canvas, int x, int y, int radiusX, int radiusY, Color color) {
-    for (int j = -radiusY; j <= radiusY; j++) {
-        for (int i = -radiusX; i <= radiusX; i++) {
-            if ((i*i * radiusY*radiusY + j*j * radiusX*radiusX) <= radiusX*radiusX * radiusY*radiusY) {
-                canvas_set_pixel(canvas, x + i, y + j, color);
+    ClipBounds clip;
+    int first, last;
+    if (radiusX < 0 || radiusY < 0 || !clip_bounds(canvas, &clip) ||
+        !clip_row_offsets(&clip, y, radiusY, &first, &last)) {
+        return;
+    }
+
+    /* One span per row, widths from the incremental row walk, starting at
+     * the first row inside the clip */
+    ShapeRows rows;
+    shape_rows_ellipse(&rows, radiusX, radiusY);
+    int half = first > 0 ? shape_rows_seek(&rows, first) : rows.half;
+    for (int j = first; j <= last; j++) {
+        if (j > first) {
+            half = shape_rows_next(&rows);
+        }
+        if (j > 0) {
+            fill_run_clipped(canvas, &clip, (long long)x - half, (long long)x + half, (long long)y - j, color);
+        }
+        fill_run_clipped(canvas, &clip, (long long)x - half, (long long)x + half, (long long)y + j, color);
+    }
+}
+
+/* --- Anti-aliased primitives --- */
+
+/* Coverage bytes computed per coverage kernel call */
+#define AA_EDGE_CHUNK 128
+
+typedef enum {
+    AA_SHAPE_ELLIPSE,
+    AA_SHAPE_RING,
+    AA_SHAPE_STROKE
+} AaShapeKind;
+
+/**
+ * @brief An anti-aliased shape, for filling its rows' edge pixels
+ */
+typedef struct {
+    AaShapeKind kind;
+    float x;          /* Center */
+    float y;
+    float inv_rx2;    /* Ellipse and ring: 1 / radius^2 */
+    float inv_ry2;
+    float half_width; /* Ring: stroke half-width */
+    CoverageStroke stroke;
+    Color color;
+} AaShape;
+
+/**
+ * @brief Stroke width to rasterize, and color to use, for a requested width
+ *
+ * Distance-based coverage overstates strokes thinner than a pixel, so
+ * those are drawn one pixel wide with their alpha scaled by the width.
+ */
+static float aa_stroke_width(float width, Color* color) {
+    if (width >= 1.0f) {
+        return width;
+    }
+    color->a = (uint8_t)(color->a * width + 0.5f);
+    return 1.0f;
+}
+
+/**
+ * @brief Draw pixels first..last of a row with their coverage of the shape
+ */
+static void draw_aa_pixels(Canvas* canvas, const AaShape* shape, int first, int last, int row) {
+    uint8_t coverage[AA_EDGE_CHUNK];
+    float dy = (float)row - shape->y;
+    while (first <= last) {
+        int count = last - first + 1;
+        if (count > AA_EDGE_CHUNK) {
+            count = AA_EDGE_CHUNK;
+        }
+        float dx = (float)first - shape->x;
+        switch (shape->kind) {
+        case AA_SHAPE_ELLIPSE:
+            coverage_ellipse_row(coverage, count, dx, dy, shape->inv_rx2, shape->inv_ry2);
+            break;
+        case AA_SHAPE_RING:
+            coverage_ring_row(coverage, count, dx, dy, shape->inv_rx2, shape->inv_ry2, shape->half_width);
+            break;
+        case AA_SHAPE_STROKE:
+            coverage_stroke_row(coverage, count, dx, dy, &shape->stroke);
+            break;
+        }
+        canvas_fill_span_coverage(canvas, first, row, count, coverage, shape->color);
+        first += count;
+    }
+}
+
+/**
+ * @brief Draw pixels left..right of a row, where solid_left..solid_right
+ *        (empty if solid_left > solid_right) are known to be fully covered
+ */
+static void draw_aa_row(Canvas* canvas, const AaShape* shape, int row, int left, int right,
+                        int solid_left, int solid_right) {
+    if (solid_left > solid_right) {
+        draw_aa_pixels(canvas, shape, left, right, row);
+        return;
+    }
+    draw_aa_pixels(canvas, shape, left, solid_left - 1, row);
+    canvas_fill_span(canvas, solid_left, row, solid_right - solid_left + 1, shape->color);
+    draw_aa_pixels(canvas, shape, solid_right + 1, right, row);
+}
+
+/**
+ * @brief Half-width of an ellipse at vertical offset dy from its center
+ *
+ * @return int Nonzero if the row crosses the ellipse
+ */
+static int ellipse_row_extent(float radiusX, float radiusY, float dy, float* half) {
+    if (!(radiusX > 0.0f) || !(radiusY > 0.0f) || fabsf(dy) >= radiusY) {
+        return 0;
+    }
+    *half = radiusX * sqrtf(1.0f - (dy * dy) / (radiusY * radiusY));
+    return 1;
+}
+
+void draw_line_aa(Canvas* canvas, float x1, float y1, float x2, float y2, Color color) {
+    ClipBounds clip;
+    if (!clip_bounds(canvas, &clip)) {
+        return;
+    }
+
+    /* Work along the major axis a and minor axis b; for steep lines the
+     * major axis is vertical */
+    int steep = fabsf(y2 - y1) > fabsf(x2 - x1);
+    float a1 = steep ? y1 : x1;
+    float b1 = steep ? x1 : y1;
+    float a2 = steep ? y2 : x2;
+    float b2 = steep ? x2 : y2;
+    if (a1 > a2) {
+        float t = a1;
+        a1 = a2;
+        a2 = t;
+        t = b1;
+        b1 = b2;
+        b2 = t;
+    }
+    if (!(a2 > a1)) {
+        return; /* No length, no ink */
+    }
+    float gradient = (b2 - b1) / (a2 - a1);
+
+    /* Pixel i spans [i - 0.5, i + 0.5] along the major axis; the end pixels
+     * are weighted by how much of that the line covers */
+    float a_first = floorf(a1 + 0.5f);
+    float a_last = floorf(a2 + 0.5f);
+    float first_weight = (a_first + 0.5f) - a1;
+    float last_weight = a2 - (a_last - 0.5f);
+    if (a_first == a_last) {
+        first_weight = a2 - a1;
+        last_weight = first_weight;
+    }
+
+    /* Clip the major range to the clip, and to where the line is within a
+     * pixel (widened a pixel for rounding) of the clip across it */
+    double lo = a_first;
+    double hi = a_last;
+    double b_min = steep ? clip.left : clip.top;
+    double b_max = steep ? clip.right : clip.bottom;
+    if (gradient != 0.0f) {
+        double ia = a1 + (b_min - 1.0 - b1) / gradient;
+        double ib = a1 + (b_max + 1.0 - b1) / gradient;
+        lo = fmax(lo, floor(fmin(ia, ib)) - 1.0);
+        hi = fmin(hi, ceil(fmax(ia, ib)) + 1.0);
+    } else if (b1 < b_min - 1.0 || b1 > b_max + 1.0) {
+        return;
+    }
+    int first, last;
+    if (!clip_range(lo, hi, steep ? clip.top : clip.left, steep ? clip.bottom : clip.right, &first, &last)) {
+        return;
+    }
+
+    uint8_t coverage[AA_EDGE_CHUNK];
+    if (steep) {
+        /* One row per major step, two pixels across it */
+        for (int row = first; row <= last; row++) {
+            float x = b1 + gradient * ((float)row - a1);
+            int column = (int)floorf(x);
+            coverage_tent_row(coverage, 2, (float)column - x, 1.0f);
+            float weight = (row == a_first) ? first_weight : (row == a_last ? last_weight : 1.0f);
+            if (weight < 1.0f) {
+                coverage[0] = (uint8_t)(coverage[0] * weight + 0.5f);
+                coverage[1] = (uint8_t)(coverage[1] * weight + 0.5f);
+            }
+            canvas_fill_span_coverage(canvas, column, row, 2, coverage, color);
+        }
+        return;
+    }
+
+    /* Shallow: on each row the line touches, the pixels within one pixel of
+     * it vertically form a run; emit it as one span */
+    float b_first = b1 + gradient * ((float)first - a1);
+    float b_last = b1 + gradient * ((float)last - a1);
+    int top, bottom;
+    if (!clip_range(floorf(fminf(b_first, b_last)), ceilf(fmaxf(b_first, b_last)), clip.top, clip.bottom,
+                    &top, &bottom)) {
+        return;
+    }
+    for (int row = top; row <= bottom; row++) {
+        int left = first;
+        int right = last;
+        if (gradient != 0.0f) {
+            /* Columns where |b(i) - row| < 1, widened a pixel for rounding */
+            float ia = a1 + ((float)row - 1.0f - b1) / gradient;
+            float ib = a1 + ((float)row + 1.0f - b1) / gradient;
+            if (!clip_range(floorf(fminf(ia, ib)) - 1.0f, ceilf(fmaxf(ia, ib)) + 1.0f, first, last,
+                            &left, &right)) {
+                continue;
+            }
+        }
+        for (int column = left; column <= right; column += AA_EDGE_CHUNK) {
+            int count = right - column + 1;
+            if (count > AA_EDGE_CHUNK) {
+                count = AA_EDGE_CHUNK;
+            }
+            float t = b1 + gradient * ((float)column - a1) - (float)row;
+            coverage_tent_row(coverage, count, t, gradient);
+            if (column == a_first) {
+                coverage[0] = (uint8_t)(coverage[0] * first_weight + 0.5f);
+            }
+            if (column + count - 1 == a_last) {
+                coverage[count - 1] = (uint8_t)(coverage[count - 1] * last_weight + 0.5f);
+            }
+            canvas_fill_span_coverage(canvas, column, row, count, coverage, color);
+        }
+    }
+}
+
+/**
+ * @brief Columns (as offsets from the stroke center) where row offset y
+ *        crosses the stroke grown by grow pixels all round
+ *
+ * @return int Nonzero if the row crosses it
+ */
+static int stroke_row_extent(const CoverageStroke* stroke, float grow, float y, float* lo, float* hi) {
+    float half_width = stroke->half_width + grow;
+    if (!(half_width > 0.0f)) {
+        return 0;
+    }
+
+    /* The straight part: |x ax + y ay| <= half_length, |y ax - x ay| <= half_width */
+    float half_length = stroke->half_length + (stroke->round ? 0.0f : grow);
+    float limits[2] = { half_length, half_width };
+    float slopes[2] = { stroke->ax, -stroke->ay };
+    float offsets[2] = { y * stroke->ay, y * stroke->ax };
+    float left = -INFINITY;
+    float right = INFINITY;
+    int found = 1;
+    for (int k = 0; k < 2; k++) {
+        if (fabsf(slopes[k]) < 1e-6f) {
+            if (fabsf(offsets[k]) > limits[k]) {
+                found = 0;
+            }
+            continue;
+        }
+        float ta = (-limits[k] - offsets[k]) / slopes[k];
+        float tb = (limits[k] - offsets[k]) / slopes[k];
+        left = fmaxf(left, fminf(ta, tb));
+        right = fminf(right, fmaxf(ta, tb));
+    }
+    if (found && left > right) {
+        found = 0;
+    }
+
+    if (stroke->round) {
+        /* Plus the end circles; the capsule is convex, so the union is one interval */
+        for (int end = -1; end <= 1; end += 2) {
+            float cx = end * stroke->half_length * stroke->ax;
+            float cy = end * stroke->half_length * stroke->ay;
+            float d2 = half_width * half_width - (y - cy) * (y - cy);
+            if (d2 < 0.0f) {
+                continue;
             }
+            float d = sqrtf(d2);
+            left = found ? fminf(left, cx - d) : cx - d;
+            right = found ? fmaxf(right, cx + d) : cx + d;
+            found = 1;
+        }
+    }
+
+    *lo = left;
+    *hi = right;
+    return found;
+}
+
+void draw_thick_line_aa(Canvas* canvas, float x1, float y1, float x2, float y2, float width, LineCap cap,
+                        Color color) {
+    ClipBounds clip;
+    if (!(width > 0.0f) || !clip_bounds(canvas, &clip)) {
+        return;
+    }
+
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length <= 0.0f && cap == LINE_CAP_BUTT) {
+        return;
+    }
+    width = aa_stroke_width(width, &color);
+
+    AaShape shape;
+    shape.kind = AA_SHAPE_STROKE;
+    shape.x = (x1 + x2) * 0.5f;
+    shape.y = (y1 + y2) * 0.5f;
+    shape.color = color;
+    shape.stroke.ax = length > 0.0f ? dx / length : 1.0f;
+    shape.stroke.ay = length > 0.0f ? dy / length : 0.0f;
+    shape.stroke.half_length = length * 0.5f + (cap == LINE_CAP_SQUARE ? width * 0.5f : 0.0f);
+    shape.stroke.half_width = width * 0.5f;
+    shape.stroke.round = cap == LINE_CAP_ROUND;
+
+    /* Rows the stroke grown by half a pixel can reach */
+    float reach = shape.stroke.half_length * fabsf(shape.stroke.ay) +
+                  shape.stroke.half_width * fabsf(shape.stroke.ax) + 1.0f;
+    if (shape.stroke.round) {
+        reach = shape.stroke.half_length * fabsf(shape.stroke.ay) + shape.stroke.half_width + 0.5f;
+    }
+    int top, bottom;
+    if (!clip_range(shape.y - reach, shape.y + reach, clip.top, clip.bottom, &top, &bottom)) {
+        return;
+    }
+    for (int row = top; row <= bottom; row++) {
+        float ry = (float)row - shape.y;
+        float lo, hi;
+        int left, right;
+        if (!stroke_row_extent(&shape.stroke, 0.5f, ry, &lo, &hi) ||
+            !clip_range(shape.x + lo, shape.x + hi, clip.left, clip.right, &left, &right)) {
+            continue;
+        }
+
+        int solid_left = right + 1;
+        int solid_right = right;
+        if (stroke_row_extent(&shape.stroke, -0.5f, ry, &lo, &hi)) {
+            clip_range(shape.x + lo, shape.x + hi, left, right, &solid_left, &solid_right);
+        }
+        draw_aa_row(canvas, &shape, row, left, right, solid_left, solid_right);
+    }
+}
+
+void draw_circle_aa(Canvas* canvas, float x, float y, float radius, float width, Color color) {
+    draw_ellipse_aa(canvas, x, y, radius, radius, width, color);
+}
+
+void draw_ellipse_aa(Canvas* canvas, float x, float y, float radiusX, float radiusY, float width, Color color) {
+    ClipBounds clip;
+    if (!(radiusX > 0.0f) || !(radiusY > 0.0f) || !(width > 0.0f) || !clip_bounds(canvas, &clip)) {
+        return;
+    }
+
+    width = aa_stroke_width(width, &color);
+
+    AaShape shape;
+    shape.kind = AA_SHAPE_RING;
+    shape.x = x;
+    shape.y = y;
+    shape.inv_rx2 = 1.0f / (radiusX * radiusX);
+    shape.inv_ry2 = 1.0f / (radiusY * radiusY);
+    shape.half_width = width * 0.5f;
+    shape.color = color;
+
+    /* Each row crosses the band between the ellipse grown and the one
+     * shrunk by the half-width plus half a pixel; pixels inside the inner
+     * one are untouched, so a row is one run or a left and a right run */
+    float reach = shape.half_width + 0.5f;
+    int top, bottom;
+    if (!clip_range(y - radiusY - reach, y + radiusY + reach, clip.top, clip.bottom, &top, &bottom)) {
+        return;
+    }
+    for (int row = top; row <= bottom; row++) {
+        float dy = (float)row - y;
+        float outer;
+        int left, right;
+        if (!ellipse_row_extent(radiusX + reach, radiusY + reach, dy, &outer) ||
+            !clip_range(x - outer, x + outer, clip.left, clip.right, &left, &right)) {
+            continue;
+        }
+
+        float inner;
+        int hole_left, hole_right;
+        if (!ellipse_row_extent(radiusX - reach, radiusY - reach, dy, &inner) ||
+            !clip_range(x - inner, x + inner, left, right, &hole_left, &hole_right)) {
+            draw_aa_pixels(canvas, &shape, left, right, row);
+            continue;
+        }
+        draw_aa_pixels(canvas, &shape, left, hole_left - 1, row);
+        draw_aa_pixels(canvas, &shape, hole_right + 1, right, row);
+    }
+}
+
+void draw_filled_circle_aa(Canvas* canvas, float x, float y, float radius, Color color) {
+    draw_filled_ellipse_aa(canvas, x, y, radius, radius, color);
+}
+
+void draw_filled_ellipse_aa(Canvas* canvas, float x, float y, float radiusX, float radiusY, Color color) {
+    ClipBounds clip;
+    if (!(radiusX > 0.0f) || !(radiusY > 0.0f) || !clip_bounds(canvas, &clip)) {
+        return;
+    }
+
+    AaShape shape;
+    shape.kind = AA_SHAPE_ELLIPSE;
+    shape.x = x;
+    shape.y = y;
+    shape.inv_rx2 = 1.0f / (radiusX * radiusX);
+    shape.inv_ry2 = 1.0f / (radiusY * radiusY);
+    shape.color = color;
+
+    /* Pixels inside the ellipse shrunk by half a pixel are solid and go out
+     * as one span; only the band out to the ellipse grown by half a pixel
+     * gets per-pixel coverage */
+    int top, bottom;
+    if (!clip_range(y - radiusY - 0.5f, y + radiusY + 0.5f, clip.top, clip.bottom, &top, &bottom)) {
+        return;
+    }
+    for (int row = top; row <= bottom; row++) {
+        float dy = (float)row - y;
+        float outer;
+        int left, right;
+        if (!ellipse_row_extent(radiusX + 0.5f, radiusY + 0.5f, dy, &outer) ||
+            !clip_range(x - outer, x + outer, clip.left, clip.right, &left, &right)) {
+            continue;
+        }
+
+        int solid_left = right + 1;
+        int solid_right = right;
+        float inner;
+        if (ellipse_row_extent(radiusX - 0.5f, radiusY - 0.5f, dy, &inner)) {
+            clip_range(x - inner, x + inner, left, right, &solid_left, &solid_right);
         }
+        draw_aa_row(canvas, &shape, row, left, right, solid_left, solid_right);
     }
 }
 
@@ -0,0 +1,167 @@
+#include "pal_egl_headless.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <SDL.h> // SDL_SpinLock
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+struct PAL_HeadlessContext {
+    EGLDisplay display;
+    EGLContext context;
+    EGLSurface surface; // 1x1 pbuffer, only when surfaceless contexts are unsupported
+};
+
+// Every headless context uses the same process-wide display, and
+// eglTerminate is not reference counted: terminating it releases the
+// contexts and surfaces of every user. The last context to go terminates it.
+static SDL_SpinLock display_lock;
+static EGLDisplay shared_display = EGL_NO_DISPLAY;
+static int display_users;
+static EGLint display_major, display_minor;
+
+static bool has_extension(const char* extensions, const char* name) {
+    if (!extensions) return false;
+    size_t length = strlen(name);
+    for (const char* found = strstr(extensions, name); found; found = strstr(found + length, name)) {
+        bool starts = (found == extensions) || found[-1] == ' ';
+        bool ends = found[length] == ' ' || found[length] == '\0';
+        if (starts && ends) return true;
+    }
+    return false;
+}
+
+static EGLDisplay open_display(void) {
+    // The Mesa surfaceless platform needs no display server at all
+    const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (has_extension(client_extensions, "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (get_platform_display) {
+            EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            if (display != EGL_NO_DISPLAY) return display;
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+// Returns the initialized shared display, or EGL_NO_DISPLAY on failure.
+// Each successful call must be paired with release_display.
+static EGLDisplay acquire_display(EGLint* major, EGLint* minor) {
+    SDL_AtomicLock(&display_lock);
+    if (display_users == 0) {
+        EGLDisplay display = open_display();
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &display_major, &display_minor)) {
+            SDL_AtomicUnlock(&display_lock);
+            return EGL_NO_DISPLAY;
+        }
+        shared_display = display;
+    }
+    display_users++;
+    *major = display_major;
+    *minor = display_minor;
+    EGLDisplay display = shared_display;
+    SDL_AtomicUnlock(&display_lock);
+    return display;
+}
+
+static void release_display(void) {
+    SDL_AtomicLock(&display_lock);
+    if (--display_users == 0) {
+        eglTerminate(shared_display);
+        shared_display = EGL_NO_DISPLAY;
+    }
+    SDL_AtomicUnlock(&display_lock);
+}
+
+PAL_HeadlessContext* headless_context_create(void) {
+    PAL_HeadlessContext* context = (PAL_HeadlessContext*)calloc(1, sizeof(PAL_HeadlessContext));
+    if (!context) {
+        fprintf(stderr, "PAL Headless Error: Failed to allocate context\n");
+        return NULL;
+    }
+
+    EGLint major = 0, minor = 0;
+    context->display = acquire_display(&major, &minor);
+    if (context->display == EGL_NO_DISPLAY) {
+        fprintf(stderr, "PAL Headless Error: Failed to initialize EGL display (0x%x)\n", (unsigned)eglGetError());
+        free(context);
+        return NULL;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        fprintf(stderr, "PAL Headless Error: EGL %d.%d does not support desktop OpenGL\n", major, minor);
+        headless_context_destroy(context);
+        return NULL;
+    }
+
+    bool surfaceless = has_extension(eglQueryString(context->display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint config_count = 0;
+    if (!eglChooseConfig(context->display, config_attribs, &config, 1, &config_count) || config_count == 0) {
+        fprintf(stderr, "PAL Headless Error: No suitable EGL config (0x%x)\n", (unsigned)eglGetError());
+        headless_context_destroy(context);
+        return NULL;
+    }
+
+    // Same context version the SDL backend requests
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    context->context = eglCreateContext(context->display, config, EGL_NO_CONTEXT, context_attribs);
+    if (context->context == EGL_NO_CONTEXT) {
+        fprintf(stderr, "PAL Headless Error: Failed to create OpenGL 3.3 context (0x%x)\n", (unsigned)eglGetError());
+        headless_context_destroy(context);
+        return NULL;
+    }
+
+    if (!surfaceless) {
+        const EGLint pbuffer_attribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        context->surface = eglCreatePbufferSurface(context->display, config, pbuffer_attribs);
+        if (context->surface == EGL_NO_SURFACE) {
+            fprintf(stderr, "PAL Headless Error: Failed to create pbuffer surface (0x%x)\n", (unsigned)eglGetError());
+            headless_context_destroy(context);
+            return NULL;
+        }
+    }
+
+    if (!headless_context_make_current(context)) {
+        fprintf(stderr, "PAL Headless Error: Failed to make context current (0x%x)\n", (unsigned)eglGetError());
+        headless_context_destroy(context);
+        return NULL;
+    }
+    return context;
+}
+
+void headless_context_destroy(PAL_HeadlessContext* context) {
+    if (!context) return;
+    if (context->display != EGL_NO_DISPLAY) {
+        eglMakeCurrent(context->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context->surface != EGL_NO_SURFACE) eglDestroySurface(context->display, context->surface);
+        if (context->context != EGL_NO_CONTEXT) eglDestroyContext(context->display, context->context);
+        release_display();
+    }
+    free(context);
+}
+
+bool headless_context_make_current(PAL_HeadlessContext* context) {
+    return eglMakeCurrent(context->display, context->surface, context->surface, context->context) == EGL_TRUE;
+}
+
+void* headless_context_get_proc_address(const char* name) {
+    return (void*)eglGetProcAddress(name);
+}
@@ -0,0 +1,25 @@
+#ifndef PAL_EGL_HEADLESS_H
+#define PAL_EGL_HEADLESS_H
+
+// Internal to the OpenGL renderer backend - not part of the public API.
+// Only built when UI_FRAMEWORK_HEADLESS is enabled (defines PAL_HAS_HEADLESS).
+
+#include <stdbool.h>
+
+// --- Headless GL Context --- //
+// An OpenGL 3.3 core context without a window or display server, created
+// through EGL (surfaceless where supported, else a 1x1 pbuffer). The renderer
+// draws into its own framebuffer object on top of it. All contexts share one
+// EGL display, which is terminated when the last of them is destroyed.
+typedef struct PAL_HeadlessContext PAL_HeadlessContext;
+
+PAL_HeadlessContext* headless_context_create(void);
+void headless_context_destroy(PAL_HeadlessContext* context);
+bool headless_context_make_current(PAL_HeadlessContext* context);
+
+/**
+ * @brief GL function loader for glad (gladLoadGLLoader).
+ */
+void* headless_context_get_proc_address(const char* name);
+
+#endif // PAL_EGL_HEADLESS_H
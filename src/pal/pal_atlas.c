@@ -0,0 +1,546 @@
+#include "ui_framework/pal/pal_atlas.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PAL_ATLAS_DEFAULT_PAGE_SIZE 1024
+#define PAL_ATLAS_DEFAULT_MAX_PAGES 4
+#define PAL_ATLAS_DEFAULT_PADDING 1
+
+// Handles pack (entry index + 1) in the low bits and a generation counter in
+// the high bits, so a stale handle to a reused entry slot is detected.
+#define PAL_ATLAS_INDEX_BITS 20
+#define PAL_ATLAS_INDEX_MASK ((1u << PAL_ATLAS_INDEX_BITS) - 1u)
+#define PAL_ATLAS_GENERATION_MASK ((1u << (32 - PAL_ATLAS_INDEX_BITS)) - 1u)
+
+// --- Skyline Packer --- //
+// The skyline is the top edge of the packed area, stored as horizontal
+// segments sorted by x that together span the page width. A new rectangle is
+// placed where it ends up lowest (bottom-left heuristic), then the segments
+// under it are raised to its bottom edge.
+
+typedef struct {
+    int x, y, width;
+} AtlasSkylineNode;
+
+typedef struct {
+    PAL_TextureHandle texture;
+    uint32_t* pixels; // CPU copy of the page, used to repack when defragmenting
+    AtlasSkylineNode* skyline;
+    int skyline_count;
+    int skyline_capacity;
+    size_t freed_pixels; // Padded area of removed entries not yet reclaimed
+    uint64_t last_used;
+} AtlasPage;
+
+typedef struct {
+    int page;            // -1 when the slot is free
+    int x, y, width, height; // Image rect within the page, excluding padding
+    uint32_t generation;
+    int next_free;       // Next free slot when page == -1
+} AtlasEntry;
+
+struct PAL_Atlas {
+    PAL_Renderer* renderer;
+    PAL_AtlasConfig config;
+
+    AtlasPage* pages; // config.max_pages slots, page_count in use
+    int page_count;
+
+    AtlasEntry* entries;
+    int entry_count;
+    int entry_capacity;
+    int free_entry; // Head of the free slot list, -1 if none
+    int live_entries;
+    size_t used_pixels;
+
+    uint64_t use_clock; // Advanced on every add/lookup; drives LRU eviction
+    uint32_t defragmentations;
+    uint32_t evictions;
+};
+
+static void skyline_reset(AtlasPage* page, int page_width) {
+    page->skyline_count = 1;
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].width = page_width;
+}
+
+// Returns the y at which a width x height rect fits on top of node index, or -1.
+static int skyline_fit(const AtlasPage* page, int index, int width, int height, int page_width, int page_height) {
+    int x = page->skyline[index].x;
+    if (x + width > page_width) return -1;
+
+    int y = 0;
+    int remaining = width;
+    for (int i = index; remaining > 0; i++) {
+        if (i >= page->skyline_count) return -1;
+        if (page->skyline[i].y > y) y = page->skyline[i].y;
+        if (y + height > page_height) return -1;
+        remaining -= page->skyline[i].width;
+    }
+    return y;
+}
+
+static bool skyline_insert(AtlasPage* page, int index, int x, int y, int width) {
+    if (page->skyline_count == page->skyline_capacity) {
+        int new_capacity = page->skyline_capacity * 2;
+        AtlasSkylineNode* grown = (AtlasSkylineNode*)realloc(page->skyline, (size_t)new_capacity * sizeof(AtlasSkylineNode));
+        if (!grown) return false;
+        page->skyline = grown;
+        page->skyline_capacity = new_capacity;
+    }
+
+    memmove(&page->skyline[index + 1], &page->skyline[index],
+            (size_t)(page->skyline_count - index) * sizeof(AtlasSkylineNode));
+    page->skyline[index].x = x;
+    page->skyline[index].y = y;
+    page->skyline[index].width = width;
+    page->skyline_count++;
+
+    // Trim or drop the segments now covered by the new one
+    for (int i = index + 1; i < page->skyline_count; i++) {
+        AtlasSkylineNode* prev = &page->skyline[i - 1];
+        AtlasSkylineNode* node = &page->skyline[i];
+        int prev_right = prev->x + prev->width;
+        if (node->x >= prev_right) break;
+
+        int shrink = prev_right - node->x;
+        node->x += shrink;
+        node->width -= shrink;
+        if (node->width > 0) break;
+
+        memmove(&page->skyline[i], &page->skyline[i + 1],
+                (size_t)(page->skyline_count - i - 1) * sizeof(AtlasSkylineNode));
+        page->skyline_count--;
+        i--;
+    }
+
+    // Merge neighbours at the same height
+    for (int i = 0; i + 1 < page->skyline_count; i++) {
+        if (page->skyline[i].y == page->skyline[i + 1].y) {
+            page->skyline[i].width += page->skyline[i + 1].width;
+            memmove(&page->skyline[i + 1], &page->skyline[i + 2],
+                    (size_t)(page->skyline_count - i - 2) * sizeof(AtlasSkylineNode));
+            page->skyline_count--;
+            i--;
+        }
+    }
+    return true;
+}
+
+// Reserves a width x height area (padding included) and returns its top-left corner.
+static bool skyline_pack(AtlasPage* page, int width, int height, int page_width, int page_height, int* out_x, int* out_y) {
+    int best_index = -1;
+    int best_bottom = page_height + 1;
+    int best_width = page_width + 1;
+
+    for (int i = 0; i < page->skyline_count; i++) {
+        int y = skyline_fit(page, i, width, height, page_width, page_height);
+        if (y < 0) continue;
+        int bottom = y + height;
+        if (bottom < best_bottom || (bottom == best_bottom && page->skyline[i].width < best_width)) {
+            best_index = i;
+            best_bottom = bottom;
+            best_width = page->skyline[i].width;
+        }
+    }
+    if (best_index < 0) return false;
+
+    int x = page->skyline[best_index].x;
+    int y = best_bottom - height;
+    if (!skyline_insert(page, best_index, x, best_bottom, width)) return false;
+
+    *out_x = x;
+    *out_y = y;
+    return true;
+}
+
+// --- Pages --- //
+
+static size_t page_pixel_count(const PAL_Atlas* atlas) {
+    return (size_t)atlas->config.page_width * (size_t)atlas->config.page_height;
+}
+
+static bool page_init(PAL_Atlas* atlas, AtlasPage* page) {
+    memset(page, 0, sizeof(*page));
+    page->pixels = (uint32_t*)calloc(page_pixel_count(atlas), sizeof(uint32_t));
+    page->skyline_capacity = 16;
+    page->skyline = (AtlasSkylineNode*)malloc((size_t)page->skyline_capacity * sizeof(AtlasSkylineNode));
+    if (!page->pixels || !page->skyline) {
+        free(page->pixels);
+        free(page->skyline);
+        return false;
+    }
+    skyline_reset(page, atlas->config.page_width);
+
+    page->texture = pal_renderer_create_texture(atlas->renderer, atlas->config.page_width,
+                                                atlas->config.page_height, page->pixels);
+    if (!page->texture) {
+        free(page->pixels);
+        free(page->skyline);
+        return false;
+    }
+    return true;
+}
+
+static void page_free(PAL_Atlas* atlas, AtlasPage* page) {
+    if (page->texture) pal_renderer_destroy_texture(atlas->renderer, page->texture);
+    free(page->pixels);
+    free(page->skyline);
+    memset(page, 0, sizeof(*page));
+}
+
+static void page_upload_rect(PAL_Atlas* atlas, AtlasPage* page, int x, int y, int width, int height) {
+    const uint32_t* first = page->pixels + (size_t)y * (size_t)atlas->config.page_width + (size_t)x;
+    pal_renderer_update_texture_region(atlas->renderer, page->texture, x, y, width, height,
+                                       first, atlas->config.page_width * (int)sizeof(uint32_t));
+}
+
+static size_t padded_area(const PAL_Atlas* atlas, int width, int height) {
+    int pad = atlas->config.padding * 2;
+    return (size_t)(width + pad) * (size_t)(height + pad);
+}
+
+// --- Entries --- //
+
+static PAL_AtlasHandle entry_handle(const PAL_Atlas* atlas, int index) {
+    return ((atlas->entries[index].generation & PAL_ATLAS_GENERATION_MASK) << PAL_ATLAS_INDEX_BITS) |
+           (uint32_t)(index + 1);
+}
+
+static AtlasEntry* entry_from_handle(const PAL_Atlas* atlas, PAL_AtlasHandle handle) {
+    if (handle == PAL_ATLAS_INVALID_HANDLE) return NULL;
+    int index = (int)(handle & PAL_ATLAS_INDEX_MASK) - 1;
+    if (index < 0 || index >= atlas->entry_count) return NULL;
+    AtlasEntry* entry = &atlas->entries[index];
+    if (entry->page < 0) return NULL;
+    if ((entry->generation & PAL_ATLAS_GENERATION_MASK) != (handle >> PAL_ATLAS_INDEX_BITS)) return NULL;
+    return entry;
+}
+
+static int entry_alloc(PAL_Atlas* atlas) {
+    if (atlas->free_entry >= 0) {
+        int index = atlas->free_entry;
+        atlas->free_entry = atlas->entries[index].next_free;
+        return index;
+    }
+    if ((uint32_t)atlas->entry_count >= PAL_ATLAS_INDEX_MASK) return -1;
+
+    if (atlas->entry_count == atlas->entry_capacity) {
+        int new_capacity = atlas->entry_capacity ? atlas->entry_capacity * 2 : 64;
+        AtlasEntry* grown = (AtlasEntry*)realloc(atlas->entries, (size_t)new_capacity * sizeof(AtlasEntry));
+        if (!grown) return -1;
+        atlas->entries = grown;
+        atlas->entry_capacity = new_capacity;
+    }
+    int index = atlas->entry_count++;
+    atlas->entries[index].page = -1;
+    atlas->entries[index].generation = 0;
+    return index;
+}
+
+// Returns the slot to the free list and bumps its generation so old handles fail.
+static void entry_release(PAL_Atlas* atlas, int index) {
+    AtlasEntry* entry = &atlas->entries[index];
+    atlas->used_pixels -= (size_t)entry->width * (size_t)entry->height;
+    atlas->live_entries--;
+    entry->page = -1;
+    entry->generation++;
+    entry->next_free = atlas->free_entry;
+    atlas->free_entry = index;
+}
+
+// --- Defragmentation and Eviction --- //
+
+// qsort has no user pointer; the entry table is only needed for the duration of the sort
+static const AtlasEntry* sort_entries;
+
+static int compare_entries_by_height(const void* a, const void* b) {
+    const AtlasEntry* ea = &sort_entries[*(const int*)a];
+    const AtlasEntry* eb = &sort_entries[*(const int*)b];
+    if (ea->height != eb->height) return eb->height - ea->height;
+    return eb->width - ea->width;
+}
+
+// Repacks the live entries of a page from scratch (tallest first), reclaiming
+// the holes left by removed images. Handles stay valid; their regions move.
+static bool page_defragment(PAL_Atlas* atlas, int page_index) {
+    AtlasPage* page = &atlas->pages[page_index];
+    int pad = atlas->config.padding;
+    int page_width = atlas->config.page_width;
+    int page_height = atlas->config.page_height;
+
+    int count = 0;
+    for (int i = 0; i < atlas->entry_count; i++) {
+        if (atlas->entries[i].page == page_index) count++;
+    }
+
+    int* order = (int*)malloc((size_t)(count ? count : 1) * sizeof(int) * 3);
+    uint32_t* pixels = (uint32_t*)calloc(page_pixel_count(atlas), sizeof(uint32_t));
+    AtlasPage scratch;
+    memset(&scratch, 0, sizeof(scratch));
+    scratch.skyline_capacity = page->skyline_capacity;
+    scratch.skyline = (AtlasSkylineNode*)malloc((size_t)scratch.skyline_capacity * sizeof(AtlasSkylineNode));
+    if (!order || !pixels || !scratch.skyline) {
+        free(order);
+        free(pixels);
+        free(scratch.skyline);
+        return false;
+    }
+    int* new_x = order + count;
+    int* new_y = order + count * 2;
+
+    count = 0;
+    for (int i = 0; i < atlas->entry_count; i++) {
+        if (atlas->entries[i].page == page_index) order[count++] = i;
+    }
+    sort_entries = atlas->entries;
+    qsort(order, (size_t)count, sizeof(int), compare_entries_by_height);
+
+    // Place everything first so a failure leaves the page untouched
+    skyline_reset(&scratch, page_width);
+    for (int i = 0; i < count; i++) {
+        const AtlasEntry* entry = &atlas->entries[order[i]];
+        if (!skyline_pack(&scratch, entry->width + pad * 2, entry->height + pad * 2,
+                          page_width, page_height, &new_x[i], &new_y[i])) {
+            free(order);
+            free(pixels);
+            free(scratch.skyline);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        AtlasEntry* entry = &atlas->entries[order[i]];
+        int x = new_x[i] + pad;
+        int y = new_y[i] + pad;
+        for (int row = 0; row < entry->height; row++) {
+            memcpy(pixels + (size_t)(y + row) * (size_t)page_width + (size_t)x,
+                   page->pixels + (size_t)(entry->y + row) * (size_t)page_width + (size_t)entry->x,
+                   (size_t)entry->width * sizeof(uint32_t));
+        }
+        entry->x = x;
+        entry->y = y;
+    }
+
+    free(order);
+    free(page->pixels);
+    free(page->skyline);
+    page->pixels = pixels;
+    page->skyline = scratch.skyline;
+    page->skyline_count = scratch.skyline_count;
+    page->skyline_capacity = scratch.skyline_capacity;
+    page->freed_pixels = 0;
+
+    // Whole-page update flushes, so draws recorded with the old UVs still render correctly
+    pal_renderer_update_texture(atlas->renderer, page->texture, page_width, page_height, page->pixels);
+    atlas->defragmentations++;
+    return true;
+}
+
+// Drops every image on the least recently used page and returns it empty.
+static int page_evict_lru(PAL_Atlas* atlas) {
+    int victim = 0;
+    for (int i = 1; i < atlas->page_count; i++) {
+        if (atlas->pages[i].last_used < atlas->pages[victim].last_used) victim = i;
+    }
+
+    // Draws already recorded this frame may reference the victim's contents
+    pal_renderer_flush(atlas->renderer);
+
+    for (int i = 0; i < atlas->entry_count; i++) {
+        if (atlas->entries[i].page == victim) entry_release(atlas, i);
+    }
+
+    AtlasPage* page = &atlas->pages[victim];
+    memset(page->pixels, 0, page_pixel_count(atlas) * sizeof(uint32_t));
+    skyline_reset(page, atlas->config.page_width);
+    page->freed_pixels = 0;
+    // Clear the texture too so stale texels never bleed into new neighbours' padding
+    pal_renderer_update_texture(atlas->renderer, page->texture, atlas->config.page_width,
+                                atlas->config.page_height, page->pixels);
+    atlas->evictions++;
+    return victim;
+}
+
+// --- Public API --- //
+
+PAL_Atlas* pal_atlas_create(PAL_Renderer* renderer, const PAL_AtlasConfig* config) {
+    if (!renderer) return NULL;
+
+    PAL_Atlas* atlas = (PAL_Atlas*)calloc(1, sizeof(PAL_Atlas));
+    if (!atlas) {
+        fprintf(stderr, "PAL Atlas Error: Failed to allocate atlas\n");
+        return NULL;
+    }
+
+    atlas->renderer = renderer;
+    atlas->config.page_width = PAL_ATLAS_DEFAULT_PAGE_SIZE;
+    atlas->config.page_height = PAL_ATLAS_DEFAULT_PAGE_SIZE;
+    atlas->config.max_pages = PAL_ATLAS_DEFAULT_MAX_PAGES;
+    atlas->config.padding = PAL_ATLAS_DEFAULT_PADDING;
+    if (config) {
+        if (config->page_width > 0) atlas->config.page_width = config->page_width;
+        if (config->page_height > 0) atlas->config.page_height = config->page_height;
+        if (config->max_pages > 0) atlas->config.max_pages = config->max_pages;
+        if (config->padding >= 0) atlas->config.padding = config->padding;
+    }
+    atlas->free_entry = -1;
+
+    atlas->pages = (AtlasPage*)calloc((size_t)atlas->config.max_pages, sizeof(AtlasPage));
+    if (!atlas->pages) {
+        fprintf(stderr, "PAL Atlas Error: Failed to allocate page table\n");
+        free(atlas);
+        return NULL;
+    }
+    return atlas;
+}
+
+void pal_atlas_destroy(PAL_Atlas* atlas) {
+    if (!atlas) return;
+    for (int i = 0; i < atlas->page_count; i++) {
+        page_free(atlas, &atlas->pages[i]);
+    }
+    free(atlas->pages);
+    free(atlas->entries);
+    free(atlas);
+}
+
+PAL_AtlasHandle pal_atlas_add(PAL_Atlas* atlas, int width, int height, const void* pixels, int stride_bytes) {
+    if (!atlas || !pixels || width <= 0 || height <= 0) return PAL_ATLAS_INVALID_HANDLE;
+
+    int pad = atlas->config.padding;
+    int padded_width = width + pad * 2;
+    int padded_height = height + pad * 2;
+    if (padded_width > atlas->config.page_width || padded_height > atlas->config.page_height) {
+        fprintf(stderr, "PAL Atlas Error: %dx%d image does not fit in a %dx%d page\n",
+                width, height, atlas->config.page_width, atlas->config.page_height);
+        return PAL_ATLAS_INVALID_HANDLE;
+    }
+    if (stride_bytes == 0) stride_bytes = width * (int)sizeof(uint32_t);
+
+    int index = entry_alloc(atlas);
+    if (index < 0) {
+        fprintf(stderr, "PAL Atlas Error: Out of memory growing entry table\n");
+        return PAL_ATLAS_INVALID_HANDLE;
+    }
+
+    // 1. Existing pages, 2. a new page, 3. defragment the emptiest page, 4. evict LRU page
+    int page_index = -1;
+    int x = 0, y = 0;
+    for (int i = 0; i < atlas->page_count && page_index < 0; i++) {
+        if (skyline_pack(&atlas->pages[i], padded_width, padded_height,
+                         atlas->config.page_width, atlas->config.page_height, &x, &y)) {
+            page_index = i;
+        }
+    }
+
+    if (page_index < 0 && atlas->page_count < atlas->config.max_pages) {
+        AtlasPage* page = &atlas->pages[atlas->page_count];
+        if (page_init(atlas, page)) {
+            int new_page = atlas->page_count++;
+            if (skyline_pack(page, padded_width, padded_height,
+                             atlas->config.page_width, atlas->config.page_height, &x, &y)) {
+                page_index = new_page;
+            }
+        }
+    }
+
+    if (page_index < 0 && atlas->page_count > 0) {
+        int candidate = -1;
+        size_t needed = padded_area(atlas, width, height);
+        for (int i = 0; i < atlas->page_count; i++) {
+            size_t freed = atlas->pages[i].freed_pixels;
+            if (freed >= needed && (candidate < 0 || freed > atlas->pages[candidate].freed_pixels)) candidate = i;
+        }
+        if (candidate >= 0 && page_defragment(atlas, candidate) &&
+            skyline_pack(&atlas->pages[candidate], padded_width, padded_height,
+                         atlas->config.page_width, atlas->config.page_height, &x, &y)) {
+            page_index = candidate;
+        }
+    }
+
+    if (page_index < 0 && atlas->page_count > 0) {
+        int victim = page_evict_lru(atlas);
+        if (skyline_pack(&atlas->pages[victim], padded_width, padded_height,
+                         atlas->config.page_width, atlas->config.page_height, &x, &y)) {
+            page_index = victim;
+        }
+    }
+
+    if (page_index < 0) {
+        // Slot was never published; hand it straight back
+        atlas->entries[index].page = -1;
+        atlas->entries[index].next_free = atlas->free_entry;
+        atlas->free_entry = index;
+        fprintf(stderr, "PAL Atlas Error: No space for %dx%d image\n", width, height);
+        return PAL_ATLAS_INVALID_HANDLE;
+    }
+
+    AtlasPage* page = &atlas->pages[page_index];
+    AtlasEntry* entry = &atlas->entries[index];
+    entry->page = page_index;
+    entry->x = x + pad;
+    entry->y = y + pad;
+    entry->width = width;
+    entry->height = height;
+    atlas->live_entries++;
+    atlas->used_pixels += (size_t)width * (size_t)height;
+    page->last_used = ++atlas->use_clock;
+
+    const unsigned char* src = (const unsigned char*)pixels;
+    for (int row = 0; row < height; row++) {
+        memcpy(page->pixels + (size_t)(entry->y + row) * (size_t)atlas->config.page_width + (size_t)entry->x,
+               src + (size_t)row * (size_t)stride_bytes, (size_t)width * sizeof(uint32_t));
+    }
+    page_upload_rect(atlas, page, entry->x, entry->y, width, height);
+
+    return entry_handle(atlas, index);
+}
+
+bool pal_atlas_get_region(PAL_Atlas* atlas, PAL_AtlasHandle handle, PAL_AtlasRegion* region) {
+    if (!atlas || !region) return false;
+    AtlasEntry* entry = entry_from_handle(atlas, handle);
+    if (!entry) return false;
+
+    AtlasPage* page = &atlas->pages[entry->page];
+    page->last_used = ++atlas->use_clock;
+
+    float inv_width = 1.0f / (float)atlas->config.page_width;
+    float inv_height = 1.0f / (float)atlas->config.page_height;
+    region->texture = page->texture;
+    region->x = entry->x;
+    region->y = entry->y;
+    region->width = entry->width;
+    region->height = entry->height;
+    region->u0 = (float)entry->x * inv_width;
+    region->v0 = (float)entry->y * inv_height;
+    region->u1 = (float)(entry->x + entry->width) * inv_width;
+    region->v1 = (float)(entry->y + entry->height) * inv_height;
+    return true;
+}
+
+void pal_atlas_remove(PAL_Atlas* atlas, PAL_AtlasHandle handle) {
+    if (!atlas) return;
+    AtlasEntry* entry = entry_from_handle(atlas, handle);
+    if (!entry) return;
+
+    // Space is only reclaimed by defragmentation; the texels stay until then
+    atlas->pages[entry->page].freed_pixels += padded_area(atlas, entry->width, entry->height);
+    entry_release(atlas, (int)(entry - atlas->entries));
+}
+
+void pal_atlas_get_stats(const PAL_Atlas* atlas, PAL_AtlasStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!atlas) return;
+
+    stats->page_count = atlas->page_count;
+    stats->entry_count = atlas->live_entries;
+    stats->used_pixels = atlas->used_pixels;
+    stats->total_pixels = page_pixel_count(atlas) * (size_t)atlas->page_count;
+    stats->defragmentations = atlas->defragmentations;
+    stats->evictions = atlas->evictions;
+}
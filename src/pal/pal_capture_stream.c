@@ -0,0 +1,337 @@
+#include "pal_capture_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Frames copied out and waiting for the writer thread; further frames are
+// dropped until it catches up
+#define PAL_CAPTURE_STREAM_QUEUE 4
+
+typedef struct {
+    uint8_t* pixels;    // Top-down, width * 4 bytes per row
+    size_t capacity;
+    int width;
+    int height;
+    uint64_t frame_index;
+    Uint64 captured_at;
+} PAL_CaptureFrame;
+
+struct PAL_CaptureStream {
+    FILE* file;
+    PAL_CaptureFormat format;
+    Uint64 opened_at;   // Performance counter; record timestamps are relative to it
+    uint8_t* encoded;   // Payload of the frame being written (writer thread only)
+    size_t capacity;
+
+    // Queued frames are frames[head] onwards; the writer keeps frames[head]
+    // queued while it writes it, so the submitter never touches a frame in use.
+    // The mutex guards everything below.
+    SDL_Thread* thread;
+    SDL_mutex* mutex;
+    SDL_cond* cond;     // Signalled when a frame is queued and on close
+    PAL_CaptureFrame frames[PAL_CAPTURE_STREAM_QUEUE];
+    int head;
+    int count;
+    bool closing;       // Write out what is queued, then stop
+    bool failed;        // A write failed; later frames are discarded
+    uint64_t bytes_written;
+};
+
+// --- Byte Order Helpers --- //
+// Record headers are little-endian; QOI headers are big-endian.
+
+static void put_le32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+static void put_le64(uint8_t* out, uint64_t value) {
+    put_le32(out, (uint32_t)value);
+    put_le32(out + 4, (uint32_t)(value >> 32));
+}
+
+static void put_be32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+}
+
+// --- QOI Encoder --- //
+// Straight implementation of the QOI specification (qoiformat.org). Input is
+// BGRA; the image is stored as 4-channel RGBA.
+
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF  0x40
+#define QOI_OP_LUMA  0x80
+#define QOI_OP_RUN   0xc0
+#define QOI_OP_RGB   0xfe
+#define QOI_OP_RGBA  0xff
+#define QOI_HEADER_SIZE 14
+#define QOI_PADDING_SIZE 8
+
+typedef struct {
+    uint8_t r, g, b, a;
+} QoiPixel;
+
+static size_t qoi_max_size(int width, int height) {
+    // Worst case is a QOI_OP_RGBA per pixel
+    return (size_t)width * (size_t)height * 5 + QOI_HEADER_SIZE + QOI_PADDING_SIZE;
+}
+
+static size_t qoi_encode(uint8_t* out, const uint8_t* top_row, ptrdiff_t stride, int width, int height) {
+    uint8_t* p = out;
+    memcpy(p, "qoif", 4);
+    put_be32(p + 4, (uint32_t)width);
+    put_be32(p + 8, (uint32_t)height);
+    p[12] = 4; // Channels
+    p[13] = 0; // sRGB with linear alpha
+    p += QOI_HEADER_SIZE;
+
+    QoiPixel index[64];
+    memset(index, 0, sizeof(index));
+    QoiPixel prev = { 0, 0, 0, 255 };
+    int run = 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* src = top_row + stride * (ptrdiff_t)y;
+        for (int x = 0; x < width; x++, src += 4) {
+            QoiPixel px = { src[2], src[1], src[0], src[3] };
+            if (px.r == prev.r && px.g == prev.g && px.b == prev.b && px.a == prev.a) {
+                if (++run == 62) {
+                    *p++ = (uint8_t)(QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                *p++ = (uint8_t)(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+
+            int slot = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+            QoiPixel* cached = &index[slot];
+            if (cached->r == px.r && cached->g == px.g && cached->b == px.b && cached->a == px.a) {
+                *p++ = (uint8_t)(QOI_OP_INDEX | slot);
+            } else {
+                *cached = px;
+                if (px.a == prev.a) {
+                    // Channel differences wrap around, as the decoder adds them modulo 256
+                    int dr = (int8_t)(uint8_t)(px.r - prev.r);
+                    int dg = (int8_t)(uint8_t)(px.g - prev.g);
+                    int db = (int8_t)(uint8_t)(px.b - prev.b);
+                    int dr_dg = dr - dg;
+                    int db_dg = db - dg;
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        *p++ = (uint8_t)(QOI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+                    } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+                        *p++ = (uint8_t)(QOI_OP_LUMA | (dg + 32));
+                        *p++ = (uint8_t)(((dr_dg + 8) << 4) | (db_dg + 8));
+                    } else {
+                        *p++ = QOI_OP_RGB;
+                        *p++ = px.r;
+                        *p++ = px.g;
+                        *p++ = px.b;
+                    }
+                } else {
+                    *p++ = QOI_OP_RGBA;
+                    *p++ = px.r;
+                    *p++ = px.g;
+                    *p++ = px.b;
+                    *p++ = px.a;
+                }
+            }
+            prev = px;
+        }
+    }
+    if (run > 0) *p++ = (uint8_t)(QOI_OP_RUN | (run - 1));
+
+    static const uint8_t padding[QOI_PADDING_SIZE] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(p, padding, sizeof(padding));
+    p += sizeof(padding);
+    return (size_t)(p - out);
+}
+
+// --- Writer Thread --- //
+
+// Encodes and appends one frame. Returns bytes written, or 0 on failure.
+static size_t write_frame(PAL_CaptureStream* stream, const PAL_CaptureFrame* frame) {
+    size_t row_size = (size_t)frame->width * 4;
+    size_t payload_size = row_size * (size_t)frame->height;
+    const uint8_t* payload = frame->pixels;
+
+    if (stream->format == PAL_CAPTURE_FORMAT_QOI) {
+        size_t needed = qoi_max_size(frame->width, frame->height);
+        if (needed > stream->capacity) {
+            uint8_t* encoded = (uint8_t*)realloc(stream->encoded, needed);
+            if (!encoded) {
+                fprintf(stderr, "PAL Renderer Error: Failed to allocate capture encode buffer\n");
+                return 0;
+            }
+            stream->encoded = encoded;
+            stream->capacity = needed;
+        }
+        payload_size = qoi_encode(stream->encoded, frame->pixels, (ptrdiff_t)row_size, frame->width, frame->height);
+        payload = stream->encoded;
+    }
+
+    Uint64 elapsed = frame->captured_at > stream->opened_at ? frame->captured_at - stream->opened_at : 0;
+    uint64_t timestamp_us = (uint64_t)((double)elapsed * 1.0e6 / (double)SDL_GetPerformanceFrequency());
+
+    uint8_t header[PAL_CAPTURE_RECORD_HEADER_SIZE];
+    memcpy(header, "PALF", 4);
+    put_le32(header + 4, (uint32_t)stream->format);
+    put_le32(header + 8, (uint32_t)frame->width);
+    put_le32(header + 12, (uint32_t)frame->height);
+    put_le64(header + 16, frame->frame_index);
+    put_le64(header + 24, timestamp_us);
+    put_le32(header + 32, (uint32_t)payload_size);
+
+    bool ok = fwrite(header, sizeof(header), 1, stream->file) == 1 &&
+              fwrite(payload, payload_size, 1, stream->file) == 1;
+    if (!ok) {
+        fprintf(stderr, "PAL Renderer Error: Failed to write capture frame\n");
+        return 0;
+    }
+    return sizeof(header) + payload_size;
+}
+
+static int capture_stream_writer(void* data) {
+    PAL_CaptureStream* stream = (PAL_CaptureStream*)data;
+
+    SDL_LockMutex(stream->mutex);
+    for (;;) {
+        while (stream->count == 0 && !stream->closing) {
+            SDL_CondWait(stream->cond, stream->mutex);
+        }
+        if (stream->count == 0) break; // Closing with everything written
+
+        PAL_CaptureFrame* frame = &stream->frames[stream->head];
+        bool failed = stream->failed;
+        SDL_UnlockMutex(stream->mutex);
+        size_t written = failed ? 0 : write_frame(stream, frame);
+        SDL_LockMutex(stream->mutex);
+
+        if (written) {
+            stream->bytes_written += written;
+        } else {
+            stream->failed = true;
+        }
+        stream->head = (stream->head + 1) % PAL_CAPTURE_STREAM_QUEUE;
+        stream->count--;
+    }
+    SDL_UnlockMutex(stream->mutex);
+    return 0;
+}
+
+// --- Stream --- //
+
+PAL_CaptureStream* capture_stream_open(const char* path, PAL_CaptureFormat format) {
+    if (!path) return NULL;
+    if (format != PAL_CAPTURE_FORMAT_RAW && format != PAL_CAPTURE_FORMAT_QOI) {
+        fprintf(stderr, "PAL Renderer Error: Unknown capture format %d\n", (int)format);
+        return NULL;
+    }
+
+    PAL_CaptureStream* stream = (PAL_CaptureStream*)calloc(1, sizeof(PAL_CaptureStream));
+    if (!stream) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate capture stream\n");
+        return NULL;
+    }
+    stream->file = fopen(path, "wb");
+    if (!stream->file) {
+        fprintf(stderr, "PAL Renderer Error: Failed to open capture file '%s'\n", path);
+        free(stream);
+        return NULL;
+    }
+    stream->format = format;
+    stream->opened_at = SDL_GetPerformanceCounter();
+
+    stream->mutex = SDL_CreateMutex();
+    stream->cond = SDL_CreateCond();
+    if (stream->mutex && stream->cond) {
+        stream->thread = SDL_CreateThread(capture_stream_writer, "PAL Capture", stream);
+    }
+    if (!stream->thread) {
+        fprintf(stderr, "PAL Renderer Error: Failed to start capture writer: %s\n", SDL_GetError());
+        capture_stream_close(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+uint64_t capture_stream_close(PAL_CaptureStream* stream) {
+    if (!stream) return 0;
+    if (stream->thread) {
+        SDL_LockMutex(stream->mutex);
+        stream->closing = true;
+        SDL_CondBroadcast(stream->cond);
+        SDL_UnlockMutex(stream->mutex);
+        SDL_WaitThread(stream->thread, NULL);
+    }
+    if (stream->cond) SDL_DestroyCond(stream->cond);
+    if (stream->mutex) SDL_DestroyMutex(stream->mutex);
+
+    if (fclose(stream->file) != 0) {
+        fprintf(stderr, "PAL Renderer Error: Failed to finish writing capture file\n");
+    }
+    uint64_t bytes_written = stream->bytes_written;
+    for (int i = 0; i < PAL_CAPTURE_STREAM_QUEUE; i++) free(stream->frames[i].pixels);
+    free(stream->encoded);
+    free(stream);
+    return bytes_written;
+}
+
+bool capture_stream_submit(PAL_CaptureStream* stream, const uint8_t* top_row, ptrdiff_t stride,
+                           int width, int height, uint64_t frame_index, Uint64 captured_at) {
+    if (!stream || !top_row || width <= 0 || height <= 0) return false;
+
+    SDL_LockMutex(stream->mutex);
+    bool full = stream->failed || stream->count == PAL_CAPTURE_STREAM_QUEUE;
+    int slot = (stream->head + stream->count) % PAL_CAPTURE_STREAM_QUEUE;
+    SDL_UnlockMutex(stream->mutex);
+    if (full) return false;
+
+    // The slot after the queued frames is only ever touched here
+    PAL_CaptureFrame* frame = &stream->frames[slot];
+    size_t row_size = (size_t)width * 4;
+    size_t size = row_size * (size_t)height;
+    if (size > frame->capacity) {
+        uint8_t* pixels = (uint8_t*)realloc(frame->pixels, size);
+        if (!pixels) {
+            fprintf(stderr, "PAL Renderer Error: Failed to allocate capture frame\n");
+            return false;
+        }
+        frame->pixels = pixels;
+        frame->capacity = size;
+    }
+    if (stride == (ptrdiff_t)row_size) {
+        memcpy(frame->pixels, top_row, size);
+    } else {
+        for (int y = 0; y < height; y++) {
+            memcpy(frame->pixels + row_size * (size_t)y, top_row + stride * (ptrdiff_t)y, row_size);
+        }
+    }
+    frame->width = width;
+    frame->height = height;
+    frame->frame_index = frame_index;
+    frame->captured_at = captured_at;
+
+    SDL_LockMutex(stream->mutex);
+    stream->count++;
+    SDL_CondBroadcast(stream->cond);
+    SDL_UnlockMutex(stream->mutex);
+    return true;
+}
+
+bool capture_stream_poll(PAL_CaptureStream* stream, uint64_t* bytes_written) {
+    if (!stream) return false;
+    SDL_LockMutex(stream->mutex);
+    bool ok = !stream->failed;
+    if (bytes_written) *bytes_written = stream->bytes_written;
+    SDL_UnlockMutex(stream->mutex);
+    return ok;
+}
@@ -0,0 +1,47 @@
+#ifndef PAL_CAPTURE_STREAM_H
+#define PAL_CAPTURE_STREAM_H
+
+// Internal to the renderer backends (OpenGL and software) - not part of the public API.
+
+#include "ui_framework/pal/pal_renderer.h"
+#include <SDL.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Capture Stream --- //
+// Appends captured frames to a file as PAL_CAPTURE_RECORD_HEADER_SIZE-byte
+// record headers, each followed by its payload (see PAL_CaptureFormat for the
+// layout). Submitting a frame only copies its pixels into a small queue; a
+// writer thread owned by the stream encodes and writes them, so a slow disk or
+// encoder never holds up rendering. Frames submitted while the queue is full
+// are dropped. Submit from one thread at a time.
+typedef struct PAL_CaptureStream PAL_CaptureStream;
+
+PAL_CaptureStream* capture_stream_open(const char* path, PAL_CaptureFormat format);
+
+/**
+ * @brief Writes out every queued frame, stops the writer thread and closes the file.
+ * @return Bytes written to the file.
+ */
+uint64_t capture_stream_close(PAL_CaptureStream* stream);
+
+/**
+ * @brief Queues one frame for writing.
+ * @param top_row First byte of the top row of BGRA pixels.
+ * @param stride Bytes from one row to the next one down; negative for
+ *        bottom-up data such as GL readbacks.
+ * @param captured_at Performance counter when the frame was captured;
+ *        stored relative to when the stream was opened.
+ * @return false if the frame was dropped: the writer is behind or has failed.
+ */
+bool capture_stream_submit(PAL_CaptureStream* stream, const uint8_t* top_row, ptrdiff_t stride,
+                           int width, int height, uint64_t frame_index, Uint64 captured_at);
+
+/**
+ * @brief Gets the bytes written so far.
+ * @return false once a write has failed (e.g. disk full); the stream should be closed.
+ */
+bool capture_stream_poll(PAL_CaptureStream* stream, uint64_t* bytes_written);
+
+#endif // PAL_CAPTURE_STREAM_H
@@ -0,0 +1,271 @@
+#include "ui_framework/pal/pal_quad_batch.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PAL_QUAD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PAL_QUAD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// The kernels load and store these structs as runs of 32-bit lanes
+_Static_assert(sizeof(PAL_QuadRect) == 16 && sizeof(PAL_QuadUV) == 16, "Quad inputs must be four packed floats");
+_Static_assert(sizeof(PAL_Vertex) == 20, "PAL_Vertex must be five packed 32-bit fields");
+_Static_assert(sizeof(PAL_VertexCompact) == 12, "PAL_VertexCompact must be three packed 32-bit fields");
+
+static const PAL_QuadUV full_uv = { 0.0f, 0.0f, 1.0f, 1.0f };
+static const uint32_t white = 0xFFFFFFFFu;
+
+// Missing uvs or colors repeat one default: the pointer then does not advance
+#define QUAD_INPUTS(uvs, colors)                                   \
+    const PAL_QuadUV* uv = (uvs) ? (uvs) : &full_uv;               \
+    size_t uv_step = (uvs) ? 1 : 0;                                \
+    const uint32_t* color = (colors) ? (colors) : &white;          \
+    size_t color_step = (colors) ? 1 : 0
+
+// --- Scalar Reference --- //
+// Used on targets without SIMD and for the compact layout on ARM.
+
+static inline int16_t compact_position(float value) {
+    float fixed = value * (float)(1 << PAL_COMPACT_VERTEX_SUBPIXEL_BITS);
+    if (fixed >= 32767.0f) return INT16_MAX;
+    if (fixed <= -32768.0f) return INT16_MIN;
+    return (int16_t)lrintf(fixed);
+}
+
+static inline uint16_t compact_tex_coord(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return UINT16_MAX;
+    return (uint16_t)(value * 65535.0f + 0.5f);
+}
+
+#if !defined(PAL_QUAD_SSE2) && !defined(PAL_QUAD_NEON)
+static void write_vertex(PAL_Vertex* v, float x, float y, float u, float tv, uint32_t color) {
+    v->x = x;
+    v->y = y;
+    v->u = u;
+    v->v = tv;
+    v->color = color;
+}
+
+static void write_quad_scalar(PAL_Vertex* out, const PAL_QuadRect* r, const PAL_QuadUV* t, uint32_t c, bool triangles) {
+    float x1 = r->x + r->width;
+    float y1 = r->y + r->height;
+    write_vertex(&out[0], r->x, r->y, t->u0, t->v0, c);
+    write_vertex(&out[1], x1, r->y, t->u1, t->v0, c);
+    write_vertex(&out[2], x1, y1, t->u1, t->v1, c);
+    if (triangles) {
+        out[3] = out[0];
+        out[4] = out[2];
+        write_vertex(&out[5], r->x, y1, t->u0, t->v1, c);
+    } else {
+        write_vertex(&out[3], r->x, y1, t->u0, t->v1, c);
+    }
+}
+#endif
+
+// --- SSE2 --- //
+// A quad's corners p = (x0, y0, x1, y1) and texture area t = (u0, v0, u1, v1)
+// each fill one register; the vertices are then five 32-bit fields in a
+// row, so every 16-byte store takes lanes from p, t and the color. The
+// comments give each store's lanes.
+#ifdef PAL_QUAD_SSE2
+typedef struct {
+    __m128i lane0, lane1, lane2, lane3; // Color in one lane, zero elsewhere
+    __m128i keep1, keep2;               // All lanes but 1 (or 2)
+    __m128 color;                       // Color in every lane
+} PAL_QuadColor;
+
+static inline PAL_QuadColor quad_color(uint32_t c) {
+    PAL_QuadColor qc;
+    __m128i all = _mm_set1_epi32((int)c);
+    qc.lane0 = _mm_cvtsi32_si128((int)c);
+    qc.lane1 = _mm_slli_si128(qc.lane0, 4);
+    qc.lane2 = _mm_slli_si128(qc.lane0, 8);
+    qc.lane3 = _mm_slli_si128(qc.lane0, 12);
+    qc.keep1 = _mm_set_epi32(-1, -1, 0, -1);
+    qc.keep2 = _mm_set_epi32(-1, 0, -1, -1);
+    qc.color = _mm_castsi128_ps(all);
+    return qc;
+}
+
+static inline __m128 quad_corners(const PAL_QuadRect* r) {
+    __m128 rect = _mm_loadu_ps(&r->x);                               // x y w h
+    __m128 origin = _mm_movelh_ps(rect, rect);                       // x y x y
+    __m128 size = _mm_and_ps(rect, _mm_castsi128_ps(_mm_set_epi32(-1, -1, 0, 0))); // 0 0 w h
+    return _mm_add_ps(origin, size);                                 // x0 y0 x1 y1
+}
+
+#define STORE(dst, v) _mm_storeu_si128((__m128i*)(dst), (v))
+#define AS_INT(v) _mm_castps_si128(v)
+
+// The first 16 floats are the same for both layouts: vertex 0, 1, 2 and the
+// x of the next vertex (vertex 3 for quads, vertex 0 again for triangles)
+static inline void store_first_three(float* f, __m128 p, __m128 t, const PAL_QuadColor* qc) {
+    STORE(f + 0, AS_INT(_mm_shuffle_ps(p, t, _MM_SHUFFLE(1, 0, 1, 0))));                   // x0 y0 u0 v0
+    STORE(f + 4, _mm_or_si128(_mm_slli_si128(AS_INT(_mm_shuffle_ps(p, t, _MM_SHUFFLE(2, 2, 1, 2))), 4),
+                              qc->lane0));                                                 // c  x1 y0 u1
+    STORE(f + 8, _mm_or_si128(_mm_and_si128(AS_INT(_mm_shuffle_ps(t, p, _MM_SHUFFLE(3, 2, 1, 1))), qc->keep1),
+                              qc->lane1));                                                 // v0 c  x1 y1
+    STORE(f + 12, _mm_or_si128(_mm_and_si128(AS_INT(_mm_shuffle_ps(t, p, _MM_SHUFFLE(0, 0, 3, 2))), qc->keep2),
+                               qc->lane2));                                                // u1 v1 c  x0
+}
+#endif
+
+// --- NEON --- //
+// Same idea with 64-bit halves: vext_f32(a, b, 1) gives (a[1], b[0]), which
+// produces every pair of neighbouring fields.
+#ifdef PAL_QUAD_NEON
+static inline void store_first_three_neon(float* f, float32x2_t p_lo, float32x2_t p_hi,
+                                          float32x2_t t_lo, float32x2_t t_hi, float32x2_t c) {
+    vst1q_f32(f + 0, vcombine_f32(p_lo, t_lo));                                         // x0 y0 u0 v0
+    vst1q_f32(f + 4, vcombine_f32(vext_f32(c, p_hi, 1), vext_f32(p_lo, t_hi, 1)));      // c  x1 y0 u1
+    vst1q_f32(f + 8, vcombine_f32(vext_f32(t_lo, c, 1), p_hi));                         // v0 c  x1 y1
+    vst1q_f32(f + 12, vcombine_f32(t_hi, vext_f32(c, p_lo, 1)));                        // u1 v1 c  x0
+}
+
+static inline void load_quad_neon(const PAL_QuadRect* r, const PAL_QuadUV* uv, float32x2_t* p_lo,
+                                  float32x2_t* p_hi, float32x2_t* t_lo, float32x2_t* t_hi) {
+    float32x4_t rect = vld1q_f32(&r->x);
+    *p_lo = vget_low_f32(rect);
+    *p_hi = vadd_f32(*p_lo, vget_high_f32(rect));
+    float32x4_t t = vld1q_f32(&uv->u0);
+    *t_lo = vget_low_f32(t);
+    *t_hi = vget_high_f32(t);
+}
+#endif
+
+void pal_quad_batch_write_quads(PAL_Vertex* out, const PAL_QuadRect* rects, const PAL_QuadUV* uvs,
+                                const uint32_t* colors, size_t quad_count) {
+    if (!out || !rects) return;
+    QUAD_INPUTS(uvs, colors);
+
+    for (size_t i = 0; i < quad_count; i++, uv += uv_step, color += color_step) {
+        float* f = (float*)(out + i * 4);
+#if defined(PAL_QUAD_SSE2)
+        PAL_QuadColor qc = quad_color(*color);
+        __m128 p = quad_corners(&rects[i]);
+        __m128 t = _mm_loadu_ps(&uv->u0);
+        store_first_three(f, p, t, &qc);
+        STORE(f + 16, _mm_or_si128(_mm_srli_si128(AS_INT(_mm_shuffle_ps(p, t, _MM_SHUFFLE(3, 0, 3, 3))), 4),
+                                   qc.lane3));                                             // y1 u0 v1 c
+#elif defined(PAL_QUAD_NEON)
+        float32x2_t p_lo, p_hi, t_lo, t_hi;
+        float32x2_t c = vreinterpret_f32_u32(vdup_n_u32(*color));
+        load_quad_neon(&rects[i], uv, &p_lo, &p_hi, &t_lo, &t_hi);
+        store_first_three_neon(f, p_lo, p_hi, t_lo, t_hi, c);
+        vst1q_f32(f + 16, vcombine_f32(vext_f32(p_hi, t_lo, 1), vext_f32(t_hi, c, 1)));   // y1 u0 v1 c
+#else
+        (void)f;
+        write_quad_scalar(out + i * 4, &rects[i], uv, *color, false);
+#endif
+    }
+}
+
+void pal_quad_batch_write_triangles(PAL_Vertex* out, const PAL_QuadRect* rects, const PAL_QuadUV* uvs,
+                                    const uint32_t* colors, size_t quad_count) {
+    if (!out || !rects) return;
+    QUAD_INPUTS(uvs, colors);
+
+    for (size_t i = 0; i < quad_count; i++, uv += uv_step, color += color_step) {
+        float* f = (float*)(out + i * 6);
+#if defined(PAL_QUAD_SSE2)
+        PAL_QuadColor qc = quad_color(*color);
+        __m128 p = quad_corners(&rects[i]);
+        __m128 t = _mm_loadu_ps(&uv->u0);
+        store_first_three(f, p, t, &qc);
+        STORE(f + 16, _mm_or_si128(_mm_srli_si128(AS_INT(_mm_shuffle_ps(p, t, _MM_SHUFFLE(1, 0, 1, 1))), 4),
+                                   qc.lane3));                                             // y0 u0 v0 c
+        STORE(f + 20, AS_INT(_mm_shuffle_ps(p, t, _MM_SHUFFLE(3, 2, 3, 2))));              // x1 y1 u1 v1
+        STORE(f + 24, _mm_or_si128(_mm_slli_si128(AS_INT(_mm_shuffle_ps(p, t, _MM_SHUFFLE(0, 0, 3, 0))), 4),
+                                   qc.lane0));                                             // c  x0 y1 u0
+        __m128 tail = _mm_unpackhi_ps(t, qc.color);                                        // u1 c  v1 c
+        _mm_storel_epi64((__m128i*)(f + 28), AS_INT(_mm_movehl_ps(tail, tail)));           // v1 c
+#elif defined(PAL_QUAD_NEON)
+        float32x2_t p_lo, p_hi, t_lo, t_hi;
+        float32x2_t c = vreinterpret_f32_u32(vdup_n_u32(*color));
+        load_quad_neon(&rects[i], uv, &p_lo, &p_hi, &t_lo, &t_hi);
+        store_first_three_neon(f, p_lo, p_hi, t_lo, t_hi, c);
+        vst1q_f32(f + 16, vcombine_f32(vext_f32(p_lo, t_lo, 1), vext_f32(t_lo, c, 1)));   // y0 u0 v0 c
+        vst1q_f32(f + 20, vcombine_f32(p_hi, t_hi));                                       // x1 y1 u1 v1
+        vst1q_f32(f + 24, vcombine_f32(vext_f32(c, p_lo, 1), vext_f32(p_hi, t_lo, 1)));   // c  x0 y1 u0
+        vst1_f32(f + 28, vext_f32(t_hi, c, 1));                                            // v1 c
+#else
+        (void)f;
+        write_quad_scalar(out + i * 6, &rects[i], uv, *color, true);
+#endif
+    }
+}
+
+// --- Compact Layout --- //
+// A compact vertex is three 32-bit fields: packed x/y, packed u/v and the
+// color. On SSE2 both corner pairs of a quad are converted and packed to
+// 16 bits at once; the three stores per quad then interleave them with the
+// color.
+
+void pal_quad_batch_write_quads_compact(PAL_VertexCompact* out, const PAL_QuadRect* rects, const PAL_QuadUV* uvs,
+                                        const uint32_t* colors, size_t quad_count) {
+    if (!out || !rects) return;
+    QUAD_INPUTS(uvs, colors);
+
+#ifdef PAL_QUAD_SSE2
+    const __m128 pos_scale = _mm_set1_ps((float)(1 << PAL_COMPACT_VERTEX_SUBPIXEL_BITS));
+    const __m128 pos_min = _mm_set1_ps(-32768.0f);
+    const __m128 pos_max = _mm_set1_ps(32767.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i sign16 = _mm_set1_epi16((short)0x8000);
+#endif
+
+    for (size_t i = 0; i < quad_count; i++, uv += uv_step, color += color_step) {
+#ifdef PAL_QUAD_SSE2
+        __m128i* dst = (__m128i*)(out + i * 4);
+        __m128i c = _mm_set1_epi32((int)*color);
+
+        // Positions: round to fixed point, saturating like compact_position
+        __m128 p = _mm_mul_ps(quad_corners(&rects[i]), pos_scale);
+        p = _mm_min_ps(_mm_max_ps(p, pos_min), pos_max);
+        __m128i p_near = _mm_cvtps_epi32(p);                                       // x0 y0 x1 y1
+        __m128i p_cross = _mm_shuffle_epi32(p_near, _MM_SHUFFLE(3, 0, 1, 2));      // x1 y0 x0 y1
+        __m128i pos = _mm_packs_epi32(p_near, p_cross);  // 32-bit lanes: (x0,y0) (x1,y1) (x1,y0) (x0,y1)
+
+        // Texture coordinates: clamp, scale and truncate like compact_tex_coord,
+        // then pack unsigned through a signed pack by shifting the range
+        __m128 t = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&uv->u0), zero), one);
+        __m128i t_near = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(65535.0f)), _mm_set1_ps(0.5f)));
+        __m128i t_cross = _mm_shuffle_epi32(t_near, _MM_SHUFFLE(3, 0, 1, 2));
+        __m128i tex = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(t_near, bias), _mm_sub_epi32(t_cross, bias)), sign16);
+
+        // Vertices 0..3 use pair 0, 2, 1, 3
+        __m128i lo = _mm_unpacklo_epi32(pos, tex);                                 // P0 T0 P1 T1
+        __m128i hi = _mm_unpackhi_epi32(pos, tex);                                 // P2 T2 P3 T3
+        __m128i c_hi = _mm_unpacklo_epi32(c, hi);                                  // c  P2 c  T2
+        __m128i c_top = _mm_unpackhi_epi32(c, hi);                                 // c  P3 c  T3
+        _mm_storeu_si128(dst + 0, AS_INT(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(c_hi),
+                                                         _MM_SHUFFLE(1, 0, 1, 0)))); // P0 T0 c  P2
+        _mm_storeu_si128(dst + 1, AS_INT(_mm_shuffle_ps(_mm_castsi128_ps(c_hi), _mm_castsi128_ps(lo),
+                                                         _MM_SHUFFLE(3, 2, 2, 3)))); // T2 c  P1 T1
+        _mm_storeu_si128(dst + 2, _mm_shuffle_epi32(c_top, _MM_SHUFFLE(0, 3, 1, 0)));  // c  P3 T3 c
+#else
+        const PAL_QuadRect* r = &rects[i];
+        float xs[2] = { r->x, r->x + r->width };
+        float ys[2] = { r->y, r->y + r->height };
+        float us[2] = { uv->u0, uv->u1 };
+        float vs[2] = { uv->v0, uv->v1 };
+        static const int corner_x[4] = { 0, 1, 1, 0 };
+        static const int corner_y[4] = { 0, 0, 1, 1 };
+        for (int k = 0; k < 4; k++) {
+            PAL_VertexCompact* v = &out[i * 4 + (size_t)k];
+            v->x = compact_position(xs[corner_x[k]]);
+            v->y = compact_position(ys[corner_y[k]]);
+            v->u = compact_tex_coord(us[corner_x[k]]);
+            v->v = compact_tex_coord(vs[corner_y[k]]);
+            v->color = *color;
+        }
+#endif
+    }
+}
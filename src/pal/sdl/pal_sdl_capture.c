@@ -0,0 +1,136 @@
+#include "pal_sdl_capture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void capture_queue_init(PAL_CaptureQueue* queue) {
+    memset(queue, 0, sizeof(*queue));
+}
+
+void capture_queue_destroy(PAL_CaptureQueue* queue) {
+    capture_queue_poll(queue, true);
+    capture_stream_close(queue->stream);
+    queue->stream = NULL;
+    for (int i = 0; i < PAL_CAPTURE_SLOTS; i++) {
+        if (queue->slots[i].pbo) glDeleteBuffers(1, &queue->slots[i].pbo);
+    }
+    free(queue->pixels);
+    memset(queue, 0, sizeof(*queue));
+}
+
+// Hands a finished slot's pixels to the stream and callback
+static void complete_slot(PAL_CaptureQueue* queue, PAL_CaptureSlot* slot) {
+    size_t row_size = (size_t)slot->width * 4;
+    size_t size = row_size * (size_t)slot->height;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    const unsigned char* data = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                                       (GLsizeiptr)size, GL_MAP_READ_BIT);
+    if (!data) {
+        fprintf(stderr, "PAL Renderer Error: Failed to map capture buffer\n");
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return;
+    }
+
+    // GL rows run bottom-up
+    const unsigned char* top_row = data + row_size * (size_t)(slot->height - 1);
+    if (slot->to_stream && queue->stream) {
+        // Only a copy happens here; the stream's writer thread encodes and writes it
+        if (!capture_stream_submit(queue->stream, top_row, -(ptrdiff_t)row_size, slot->width, slot->height,
+                                   slot->frame_index, slot->captured_at)) {
+            queue->stats.dropped_frames++;
+        }
+        if (!capture_stream_poll(queue->stream, &queue->stats.stream_bytes)) {
+            // The file is unusable (e.g. disk full); stop rather than fail every frame
+            capture_stream_close(queue->stream);
+            queue->stream = NULL;
+            queue->stats.streaming = false;
+        }
+    }
+    if (slot->callback) {
+        if (size > queue->pixels_capacity) {
+            unsigned char* pixels = (unsigned char*)realloc(queue->pixels, size);
+            if (!pixels) {
+                fprintf(stderr, "PAL Renderer Error: Failed to allocate capture pixels\n");
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                return;
+            }
+            queue->pixels = pixels;
+            queue->pixels_capacity = size;
+        }
+        for (int y = 0; y < slot->height; y++) {
+            memcpy(queue->pixels + row_size * (size_t)y, top_row - row_size * (size_t)y, row_size);
+        }
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    queue->stats.captured_frames++;
+    // Last, as the callback may request another capture
+    if (slot->callback) {
+        slot->callback(queue->pixels, slot->width, slot->height, slot->frame_index, slot->user_data);
+    }
+}
+
+void capture_queue_poll(PAL_CaptureQueue* queue, bool wait) {
+    while (queue->in_flight > 0) {
+        PAL_CaptureSlot* slot = &queue->slots[queue->oldest];
+        GLenum result = glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (wait && result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+        if (result == GL_TIMEOUT_EXPIRED) break; // Later copies were issued after this one
+        if (result == GL_WAIT_FAILED) {
+            fprintf(stderr, "PAL Renderer Warning: Capture fence wait failed\n");
+        }
+        glDeleteSync(slot->fence);
+        slot->fence = NULL;
+        queue->oldest = (queue->oldest + 1) % PAL_CAPTURE_SLOTS;
+        queue->in_flight--;
+
+        if (result != GL_WAIT_FAILED) complete_slot(queue, slot);
+    }
+}
+
+void capture_queue_read_frame(PAL_CaptureQueue* queue, GLuint framebuffer, int width, int height,
+                              uint64_t frame_index) {
+    // Free up slots whose copies are done
+    capture_queue_poll(queue, false);
+    if (!queue->request && !queue->stream) return;
+    if (width <= 0 || height <= 0) return;
+
+    if (queue->in_flight == PAL_CAPTURE_SLOTS) {
+        // A requested capture stays queued for the next frame
+        if (queue->stream) queue->stats.dropped_frames++;
+        return;
+    }
+
+    PAL_CaptureSlot* slot = &queue->slots[(queue->oldest + queue->in_flight) % PAL_CAPTURE_SLOTS];
+    size_t size = (size_t)width * (size_t)height * 4;
+    if (!slot->pbo) glGenBuffers(1, &slot->pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    if (size > slot->capacity) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_READ);
+        slot->capacity = size;
+    }
+
+    // With a pack buffer bound the pixels go into it, and the call does not wait
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    slot->width = width;
+    slot->height = height;
+    slot->frame_index = frame_index;
+    slot->captured_at = SDL_GetPerformanceCounter();
+    slot->callback = queue->request;
+    slot->user_data = queue->request_user_data;
+    slot->to_stream = queue->stream != NULL;
+    queue->request = NULL;
+    queue->request_user_data = NULL;
+    queue->in_flight++;
+}
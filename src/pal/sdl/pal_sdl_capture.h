@@ -0,0 +1,71 @@
+#ifndef PAL_SDL_CAPTURE_H
+#define PAL_SDL_CAPTURE_H
+
+// Internal to the SDL/OpenGL renderer backend - not part of the public API.
+
+#include "ui_framework/pal/pal_renderer.h"
+#include "../pal_capture_stream.h"
+#include <glad/glad.h>
+#include <SDL.h>
+#include <stdbool.h>
+
+// Readbacks in flight. The GPU normally finishes a copy within two frames;
+// with every buffer busy, stream frames are dropped instead of waited for.
+#define PAL_CAPTURE_SLOTS 3
+
+typedef struct {
+    GLuint pbo;                   // Pixel pack buffer, created on first use
+    size_t capacity;              // Bytes allocated for pbo
+    GLsync fence;                 // Signalled once the copy into pbo has finished
+    int width;
+    int height;
+    uint64_t frame_index;
+    Uint64 captured_at;           // Performance counter when the copy was issued
+    PAL_CaptureCallback callback; // NULL if only the stream wants the frame
+    void* user_data;
+    bool to_stream;
+} PAL_CaptureSlot;
+
+// --- Capture Queue --- //
+// Copies finished frames into a ring of pixel buffer objects with
+// glReadPixels, which returns immediately when a pack buffer is bound, and
+// fences each copy. Slots are completed in order once their fence has
+// signalled, so mapping a buffer never waits for the GPU.
+typedef struct {
+    PAL_CaptureSlot slots[PAL_CAPTURE_SLOTS];
+    int oldest;    // Next slot to complete
+    int in_flight;
+
+    PAL_CaptureCallback request; // Waiting for the next frame, NULL if none
+    void* request_user_data;
+    PAL_CaptureStream* stream;   // NULL when not streaming
+
+    unsigned char* pixels;       // Top-down copy handed to callbacks
+    size_t pixels_capacity;
+    PAL_CaptureStats stats;
+} PAL_CaptureQueue;
+
+void capture_queue_init(PAL_CaptureQueue* queue);
+
+/**
+ * @brief Completes every capture in flight (waiting if needed), closes the
+ *        stream and deletes the buffers. The GL context must be current.
+ */
+void capture_queue_destroy(PAL_CaptureQueue* queue);
+
+/**
+ * @brief Completes captures whose copies have finished: writes them to the
+ *        stream and runs their callbacks.
+ * @param wait Block until every capture in flight is complete.
+ */
+void capture_queue_poll(PAL_CaptureQueue* queue, bool wait);
+
+/**
+ * @brief Starts a copy of the finished frame if a request or stream wants it.
+ *        Call after the frame's last draw and before the swap.
+ * @param framebuffer Framebuffer holding the frame (0 for the back buffer).
+ */
+void capture_queue_read_frame(PAL_CaptureQueue* queue, GLuint framebuffer, int width, int height,
+                              uint64_t frame_index);
+
+#endif // PAL_SDL_CAPTURE_H
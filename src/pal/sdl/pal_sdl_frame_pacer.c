@@ -0,0 +1,106 @@
+#include "pal_sdl_frame_pacer.h"
+
+#include <string.h>
+
+#define PAL_PACER_DEFAULT_REFRESH_HZ 60
+#define PAL_PACER_SAFETY_MARGIN 0.0015 // Seconds kept spare before the deadline
+#define PAL_PACER_SPIN_THRESHOLD 0.002 // Below this, spin instead of trusting SDL_Delay granularity
+#define PAL_PACER_WORK_DECAY 0.05      // How fast the work estimate falls after a slow frame
+
+static double counter_to_seconds(Uint64 ticks) {
+    return (double)ticks / (double)SDL_GetPerformanceFrequency();
+}
+
+void frame_pacer_init(PAL_FramePacer* pacer, PAL_PresentMode mode, int refresh_rate_hz) {
+    memset(pacer, 0, sizeof(*pacer));
+    pacer->mode = mode;
+    if (refresh_rate_hz <= 0) refresh_rate_hz = PAL_PACER_DEFAULT_REFRESH_HZ;
+    pacer->refresh_interval = 1.0 / (double)refresh_rate_hz;
+    // Start pessimistic: assume half a refresh until real frames are measured
+    pacer->work_estimate = pacer->refresh_interval * 0.5;
+}
+
+void frame_pacer_wait(PAL_FramePacer* pacer) {
+    if (pacer->mode != PAL_PRESENT_MODE_FRAME_PACED || !pacer->last_present) return;
+
+    // The last present returned at a vertical blank; the next one is a period later
+    double deadline = counter_to_seconds(pacer->last_present) + pacer->refresh_interval;
+    double start_at = deadline - pacer->work_estimate - PAL_PACER_SAFETY_MARGIN;
+
+    double now = counter_to_seconds(SDL_GetPerformanceCounter());
+    double remaining = start_at - now;
+    if (remaining <= 0.0) return; // Already late; render right away
+
+    if (remaining > PAL_PACER_SPIN_THRESHOLD) {
+        SDL_Delay((Uint32)((remaining - PAL_PACER_SPIN_THRESHOLD) * 1000.0));
+    }
+    while (counter_to_seconds(SDL_GetPerformanceCounter()) < start_at) {
+        // Spin the last stretch; sleep granularity is too coarse for it
+    }
+}
+
+void frame_pacer_frame_started(PAL_FramePacer* pacer) {
+    pacer->frame_start = SDL_GetPerformanceCounter();
+    pacer->work_done = 0;
+}
+
+void frame_pacer_work_done(PAL_FramePacer* pacer) {
+    pacer->work_done = SDL_GetPerformanceCounter();
+}
+
+void frame_pacer_presented(PAL_FramePacer* pacer) {
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    if (pacer->frame_start) {
+        Uint64 end = pacer->work_done ? pacer->work_done : now;
+        double work = counter_to_seconds(end - pacer->frame_start);
+        // Rise immediately, decay slowly: a missed deadline costs a whole frame
+        if (work > pacer->work_estimate) {
+            pacer->work_estimate = work;
+        } else {
+            pacer->work_estimate += (work - pacer->work_estimate) * PAL_PACER_WORK_DECAY;
+        }
+
+        if (pacer->last_present) {
+            int slot = pacer->next_sample;
+            pacer->intervals[slot] = (float)(counter_to_seconds(now - pacer->last_present) * 1000.0);
+            pacer->work[slot] = (float)(work * 1000.0);
+            pacer->next_sample = (slot + 1) % PAL_FRAME_TIMING_HISTORY;
+            if (pacer->sample_count < PAL_FRAME_TIMING_HISTORY) pacer->sample_count++;
+        }
+    }
+
+    pacer->last_present = now;
+    pacer->frame_start = 0;
+}
+
+void frame_pacer_frame_skipped(PAL_FramePacer* pacer) {
+    // An idle gap is not a frame interval; the next present starts over
+    pacer->last_present = 0;
+    pacer->frame_start = 0;
+}
+
+void frame_pacer_get_timing(const PAL_FramePacer* pacer, PAL_FrameTiming* timing) {
+    memset(timing, 0, sizeof(*timing));
+    timing->present_mode = pacer->mode;
+    timing->refresh_interval_ms = (float)(pacer->refresh_interval * 1000.0);
+    timing->samples = (uint32_t)pacer->sample_count;
+    if (pacer->sample_count == 0) return;
+
+    int last = (pacer->next_sample + PAL_FRAME_TIMING_HISTORY - 1) % PAL_FRAME_TIMING_HISTORY;
+    timing->last_interval_ms = pacer->intervals[last];
+    timing->min_interval_ms = pacer->intervals[0];
+    timing->max_interval_ms = pacer->intervals[0];
+
+    double interval_sum = 0.0;
+    double work_sum = 0.0;
+    for (int i = 0; i < pacer->sample_count; ++i) {
+        float interval = pacer->intervals[i];
+        if (interval < timing->min_interval_ms) timing->min_interval_ms = interval;
+        if (interval > timing->max_interval_ms) timing->max_interval_ms = interval;
+        interval_sum += interval;
+        work_sum += pacer->work[i];
+    }
+    timing->average_interval_ms = (float)(interval_sum / pacer->sample_count);
+    timing->average_work_ms = (float)(work_sum / pacer->sample_count);
+}
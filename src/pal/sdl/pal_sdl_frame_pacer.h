@@ -0,0 +1,45 @@
+#ifndef PAL_SDL_FRAME_PACER_H
+#define PAL_SDL_FRAME_PACER_H
+
+// Internal to the SDL renderer backends (OpenGL and software) - not part of the public API.
+
+#include "ui_framework/pal/pal_renderer.h"
+#include <SDL.h>
+#include <stdbool.h>
+
+// --- Frame Pacer --- //
+// Measures present-to-present intervals and frame work time, and in
+// PAL_PRESENT_MODE_FRAME_PACED delays the start of each frame so that it
+// finishes just before the next vertical blank. The renderer reports the
+// frame's milestones; the pacer only ever reads the performance counter.
+typedef struct {
+    PAL_PresentMode mode;
+    double refresh_interval; // Seconds between vertical blanks
+    double work_estimate;    // Seconds from frame start to submitted, tracked pessimistically
+
+    Uint64 frame_start;  // Counter at begin_frame, 0 if no frame is in progress
+    Uint64 work_done;    // Counter when the GPU finished the frame, 0 if not measured
+    Uint64 last_present; // Counter at the last present, 0 after a skipped frame
+
+    float intervals[PAL_FRAME_TIMING_HISTORY]; // Milliseconds, ring buffer
+    float work[PAL_FRAME_TIMING_HISTORY];
+    int sample_count;
+    int next_sample;
+} PAL_FramePacer;
+
+void frame_pacer_init(PAL_FramePacer* pacer, PAL_PresentMode mode, int refresh_rate_hz);
+
+/**
+ * @brief In frame-paced mode, sleeps until the latest point at which the next
+ *        frame can still make the upcoming vertical blank. No-op otherwise.
+ */
+void frame_pacer_wait(PAL_FramePacer* pacer);
+
+void frame_pacer_frame_started(PAL_FramePacer* pacer);
+void frame_pacer_work_done(PAL_FramePacer* pacer);   // GPU finished (after glFinish)
+void frame_pacer_presented(PAL_FramePacer* pacer);   // Swap returned
+void frame_pacer_frame_skipped(PAL_FramePacer* pacer);
+
+void frame_pacer_get_timing(const PAL_FramePacer* pacer, PAL_FrameTiming* timing);
+
+#endif // PAL_SDL_FRAME_PACER_H
@@ -0,0 +1,101 @@
+#include "pal_sdl_gl_state.h"
+
+void gl_state_invalidate(PAL_GLStateCache* cache) {
+    cache->program = PAL_GL_STATE_UNKNOWN;
+    cache->vertex_array = PAL_GL_STATE_UNKNOWN;
+    cache->element_buffer = PAL_GL_STATE_UNKNOWN;
+    cache->texture = PAL_GL_STATE_UNKNOWN;
+    cache->scissor_test = -1;
+    cache->scissor_box[0] = cache->scissor_box[1] = -1;
+    cache->scissor_box[2] = cache->scissor_box[3] = -1;
+}
+
+void gl_state_reset_counters(PAL_GLStateCache* cache) {
+    cache->changes = 0;
+    cache->skipped = 0;
+}
+
+void gl_state_use_program(PAL_GLStateCache* cache, GLuint program) {
+    if (cache->program == program) {
+        cache->skipped++;
+        return;
+    }
+    glUseProgram(program);
+    cache->program = program;
+    cache->changes++;
+}
+
+void gl_state_bind_vertex_array(PAL_GLStateCache* cache, GLuint vertex_array) {
+    if (cache->vertex_array == vertex_array) {
+        cache->skipped++;
+        return;
+    }
+    glBindVertexArray(vertex_array);
+    cache->vertex_array = vertex_array;
+    // Element buffer binding belongs to the VAO we just switched to
+    cache->element_buffer = PAL_GL_STATE_UNKNOWN;
+    cache->changes++;
+}
+
+void gl_state_bind_element_buffer(PAL_GLStateCache* cache, GLuint buffer) {
+    if (cache->element_buffer == buffer) {
+        cache->skipped++;
+        return;
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    cache->element_buffer = buffer;
+    cache->changes++;
+}
+
+void gl_state_bind_texture(PAL_GLStateCache* cache, GLuint texture) {
+    if (cache->texture == texture) {
+        cache->skipped++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    cache->texture = texture;
+    cache->changes++;
+}
+
+void gl_state_forget_texture(PAL_GLStateCache* cache, GLuint texture) {
+    if (cache->texture == texture) {
+        cache->texture = 0;
+    }
+}
+
+void gl_state_set_scissor(PAL_GLStateCache* cache, bool enabled, GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (!enabled) {
+        if (cache->scissor_test == 0) {
+            cache->skipped++;
+            return;
+        }
+        glDisable(GL_SCISSOR_TEST);
+        cache->scissor_test = 0;
+        cache->changes++;
+        return;
+    }
+
+    if (cache->scissor_test == 1) {
+        cache->skipped++;
+    } else {
+        glEnable(GL_SCISSOR_TEST);
+        cache->scissor_test = 1;
+        cache->changes++;
+    }
+
+    if (cache->scissor_box[0] == x && cache->scissor_box[1] == y &&
+        cache->scissor_box[2] == width && cache->scissor_box[3] == height) {
+        cache->skipped++;
+        return;
+    }
+    glScissor(x, y, width, height);
+    cache->scissor_box[0] = x;
+    cache->scissor_box[1] = y;
+    cache->scissor_box[2] = width;
+    cache->scissor_box[3] = height;
+    cache->changes++;
+}
+
+void gl_state_note_change(PAL_GLStateCache* cache) {
+    cache->changes++;
+}
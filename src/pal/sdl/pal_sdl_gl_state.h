@@ -0,0 +1,55 @@
+#ifndef PAL_SDL_GL_STATE_H
+#define PAL_SDL_GL_STATE_H
+
+// Internal to the SDL/OpenGL renderer backend - not part of the public API.
+
+#include <glad/glad.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Value meaning "binding not known"; forces the next bind to reach GL
+#define PAL_GL_STATE_UNKNOWN ((GLuint)~0u)
+
+// --- GL State Cache --- //
+// Shadows the GL bindings the renderer touches so redundant calls are skipped.
+// All renderer code must change these bindings through the functions below,
+// otherwise the shadow copy goes stale (call gl_state_invalidate if unavoidable).
+typedef struct {
+    GLuint program;
+    GLuint vertex_array;
+    GLuint element_buffer; // Element binding of the currently bound VAO
+    GLuint texture;        // GL_TEXTURE_2D on texture unit 0
+    int scissor_test;      // -1 unknown, 0 disabled, 1 enabled
+    GLint scissor_box[4];
+
+    // Counters, reset by the renderer each frame
+    uint32_t changes; // State calls issued to GL
+    uint32_t skipped; // Redundant state calls avoided
+} PAL_GLStateCache;
+
+void gl_state_invalidate(PAL_GLStateCache* cache);
+void gl_state_reset_counters(PAL_GLStateCache* cache);
+
+void gl_state_use_program(PAL_GLStateCache* cache, GLuint program);
+void gl_state_bind_vertex_array(PAL_GLStateCache* cache, GLuint vertex_array);
+void gl_state_bind_element_buffer(PAL_GLStateCache* cache, GLuint buffer);
+void gl_state_bind_texture(PAL_GLStateCache* cache, GLuint texture);
+
+/**
+ * @brief Must be called after deleting a texture: GL unbinds deleted textures,
+ *        and the name may be reused by a later glGenTextures.
+ */
+void gl_state_forget_texture(PAL_GLStateCache* cache, GLuint texture);
+
+/**
+ * @brief Enables the scissor test with the given box (GL coordinates), or disables it.
+ *        The box is only compared and uploaded while the test is enabled.
+ */
+void gl_state_set_scissor(PAL_GLStateCache* cache, bool enabled, GLint x, GLint y, GLsizei width, GLsizei height);
+
+/**
+ * @brief Records an issued uniform upload (e.g. the projection) in the counters.
+ */
+void gl_state_note_change(PAL_GLStateCache* cache);
+
+#endif // PAL_SDL_GL_STATE_H
@@ -0,0 +1,148 @@
+#include "pal_sdl_gpu_timer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static float counter_to_ms(Uint64 ticks) {
+    return (float)((double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+void gpu_timer_init(PAL_GpuTimer* timer) {
+    memset(timer, 0, sizeof(*timer));
+    timer->current = -1;
+
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    if (bits == 0) {
+        fprintf(stderr, "PAL Renderer Warning: GPU timestamps unsupported, GPU timing disabled\n");
+        return;
+    }
+    for (int i = 0; i < PAL_GPU_TIMER_FRAMES; i++) {
+        glGenQueries(PAL_GPU_TIMER_QUERIES, timer->frames[i].queries);
+    }
+    timer->supported = true;
+}
+
+void gpu_timer_destroy(PAL_GpuTimer* timer) {
+    if (!timer->supported) return;
+    for (int i = 0; i < PAL_GPU_TIMER_FRAMES; i++) {
+        glDeleteQueries(PAL_GPU_TIMER_QUERIES, timer->frames[i].queries);
+    }
+    timer->supported = false;
+}
+
+// Reads a finished slot into timer->latest
+static void read_frame(PAL_GpuTimer* timer, PAL_GpuTimerFrame* frame) {
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(frame->queries[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(frame->queries[1], GL_QUERY_RESULT, &end);
+
+    PAL_GpuTiming* timing = &timer->latest;
+    memset(timing, 0, sizeof(*timing));
+    timing->available = true;
+    timing->frame_index = frame->frame_index;
+    timing->gpu_frame_ms = (float)((double)(end - begin) / 1.0e6);
+    timing->cpu_frame_ms = counter_to_ms(frame->cpu_end - frame->cpu_begin);
+
+    for (uint32_t i = 0; i < frame->pass_count; i++) {
+        PAL_GpuPassTiming* pass = &timing->passes[timing->pass_count];
+        memcpy(pass->label, frame->labels[i], sizeof(pass->label));
+        pass->depth = frame->depths[i];
+        if (frame->pass_closed[i]) {
+            GLuint64 pass_begin = 0, pass_end = 0;
+            glGetQueryObjectui64v(frame->queries[2 + 2 * i], GL_QUERY_RESULT, &pass_begin);
+            glGetQueryObjectui64v(frame->queries[3 + 2 * i], GL_QUERY_RESULT, &pass_end);
+            pass->gpu_ms = (float)((double)(pass_end - pass_begin) / 1.0e6);
+        }
+        timing->pass_count++;
+    }
+    timing->dropped_frames = timer->dropped;
+    frame->pending = false;
+}
+
+void gpu_timer_collect(PAL_GpuTimer* timer) {
+    if (!timer->supported) return;
+
+    // Oldest first, so latest ends up holding the newest finished frame.
+    // The frame-end query is issued last, so once it is available all are.
+    for (int n = 0; n < PAL_GPU_TIMER_FRAMES; n++) {
+        PAL_GpuTimerFrame* frame = &timer->frames[(timer->next + n) % PAL_GPU_TIMER_FRAMES];
+        if (!frame->pending) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(frame->queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break; // Later frames cannot be done before this one
+        read_frame(timer, frame);
+    }
+}
+
+void gpu_timer_begin_frame(PAL_GpuTimer* timer, uint64_t frame_index) {
+    if (!timer->supported) return;
+
+    PAL_GpuTimerFrame* frame = &timer->frames[timer->next];
+    if (frame->pending) {
+        // Still not available after a full ring of frames: drop it rather than stall
+        frame->pending = false;
+        timer->dropped++;
+    }
+    frame->pass_count = 0;
+    frame->frame_index = frame_index;
+    frame->cpu_begin = SDL_GetPerformanceCounter();
+    glQueryCounter(frame->queries[0], GL_TIMESTAMP);
+
+    timer->current = timer->next;
+    timer->next = (timer->next + 1) % PAL_GPU_TIMER_FRAMES;
+    timer->open_count = 0;
+    timer->untracked_depth = 0;
+}
+
+void gpu_timer_end_frame(PAL_GpuTimer* timer) {
+    if (!timer->supported || timer->current < 0) return;
+
+    // Passes left open end with the frame
+    timer->untracked_depth = 0;
+    while (timer->open_count > 0) {
+        gpu_timer_end_pass(timer);
+    }
+    PAL_GpuTimerFrame* frame = &timer->frames[timer->current];
+    glQueryCounter(frame->queries[1], GL_TIMESTAMP);
+    frame->cpu_end = SDL_GetPerformanceCounter();
+    frame->pending = true;
+    timer->current = -1;
+}
+
+void gpu_timer_begin_pass(PAL_GpuTimer* timer, const char* label) {
+    if (!timer->supported || timer->current < 0) return;
+
+    PAL_GpuTimerFrame* frame = &timer->frames[timer->current];
+    // Passes beyond the limits go untimed, but their ends must still pair up
+    if (timer->open_count >= PAL_GPU_TIMER_MAX_DEPTH) {
+        timer->untracked_depth++;
+        return;
+    }
+    if (frame->pass_count >= PAL_GPU_TIMING_MAX_PASSES) {
+        timer->open[timer->open_count++] = -1;
+        return;
+    }
+
+    uint32_t index = frame->pass_count++;
+    snprintf(frame->labels[index], PAL_GPU_PASS_LABEL_SIZE, "%s", label ? label : "");
+    frame->depths[index] = (uint8_t)timer->open_count;
+    frame->pass_closed[index] = false;
+    glQueryCounter(frame->queries[2 + 2 * index], GL_TIMESTAMP);
+    timer->open[timer->open_count++] = (int)index;
+}
+
+void gpu_timer_end_pass(PAL_GpuTimer* timer) {
+    if (!timer->supported || timer->current < 0) return;
+    if (timer->untracked_depth > 0) {
+        timer->untracked_depth--;
+        return;
+    }
+    if (timer->open_count == 0) return;
+
+    int index = timer->open[--timer->open_count];
+    if (index < 0) return; // Pass was over the limit
+    PAL_GpuTimerFrame* frame = &timer->frames[timer->current];
+    glQueryCounter(frame->queries[3 + 2 * index], GL_TIMESTAMP);
+    frame->pass_closed[index] = true;
+}
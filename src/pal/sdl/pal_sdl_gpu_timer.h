@@ -0,0 +1,70 @@
+#ifndef PAL_SDL_GPU_TIMER_H
+#define PAL_SDL_GPU_TIMER_H
+
+// Internal to the SDL/OpenGL renderer backend - not part of the public API.
+
+#include "ui_framework/pal/pal_renderer.h"
+#include <glad/glad.h>
+#include <SDL.h>
+#include <stdbool.h>
+
+// Frames of queries in flight. Results are read when the GPU has made them
+// available, normally two frames later; a slot still pending when its turn
+// comes round again is dropped rather than waited for.
+#define PAL_GPU_TIMER_FRAMES 4
+
+// Two timestamps per pass plus the frame's begin and end
+#define PAL_GPU_TIMER_QUERIES (2 + 2 * PAL_GPU_TIMING_MAX_PASSES)
+#define PAL_GPU_TIMER_MAX_DEPTH 8
+
+typedef struct {
+    GLuint queries[PAL_GPU_TIMER_QUERIES]; // [0] frame begin, [1] frame end, then begin/end per pass
+    char labels[PAL_GPU_TIMING_MAX_PASSES][PAL_GPU_PASS_LABEL_SIZE];
+    uint8_t depths[PAL_GPU_TIMING_MAX_PASSES];
+    bool pass_closed[PAL_GPU_TIMING_MAX_PASSES];
+    uint32_t pass_count;
+    uint64_t frame_index;
+    Uint64 cpu_begin; // Performance counter at begin_frame and end_frame
+    Uint64 cpu_end;
+    bool pending;     // Queries issued, results not read yet
+} PAL_GpuTimerFrame;
+
+// --- GPU Timer --- //
+// Brackets each frame, and any labelled passes inside it, with GL_TIMESTAMP
+// queries. Timestamps rather than GL_TIME_ELAPSED so that passes may nest
+// and overlap the frame query. Reading never blocks: results are only
+// fetched once GL_QUERY_RESULT_AVAILABLE reports them ready.
+typedef struct {
+    bool supported;
+    PAL_GpuTimerFrame frames[PAL_GPU_TIMER_FRAMES];
+    int current;          // Slot of the frame being recorded, -1 outside a frame
+    int next;             // Slot the next frame records into
+    int open[PAL_GPU_TIMER_MAX_DEPTH]; // Passes currently open, innermost last
+    int open_count;
+    int untracked_depth;  // Passes opened beyond PAL_GPU_TIMER_MAX_DEPTH
+    uint32_t dropped;     // Frames whose results were never available in time
+    PAL_GpuTiming latest; // Most recent completed frame
+} PAL_GpuTimer;
+
+/**
+ * @brief Creates the query objects; leaves the timer unsupported (and every
+ *        other call a no-op) if the driver has no timestamp counter.
+ *        The GL context must be current.
+ */
+void gpu_timer_init(PAL_GpuTimer* timer);
+void gpu_timer_destroy(PAL_GpuTimer* timer);
+
+void gpu_timer_begin_frame(PAL_GpuTimer* timer, uint64_t frame_index);
+void gpu_timer_end_frame(PAL_GpuTimer* timer); // After the frame's last command, before the swap
+
+// Passes are only valid inside a frame; the caller flushes pending draws first
+void gpu_timer_begin_pass(PAL_GpuTimer* timer, const char* label);
+void gpu_timer_end_pass(PAL_GpuTimer* timer);
+
+/**
+ * @brief Reads every frame whose results are available, without waiting.
+ *        Called at the start of each frame.
+ */
+void gpu_timer_collect(PAL_GpuTimer* timer);
+
+#endif // PAL_SDL_GPU_TIMER_H
@@ -1,35 +1,22 @@
 #include "ui_framework/pal/pal_input.h"
-#include "ui_framework/pal/pal_window.h" // Need access to PAL_Window internals
+#include "ui_framework/pal/pal_window.h"
+#include "pal_sdl_window_internal.h" // Need access to PAL_Window internals
 
 #include <SDL.h>
 #include <string.h>
 #include <stdlib.h> // For malloc/free if needed for text input buffer
 
-// Define PAL_Window struct again to access its internals (friend struct workaround)
-// This is slightly hacky; a better way involves passing internal state explicitly
-// or having dedicated pal_window_set_should_close function.
-struct PAL_Window {
-    SDL_Window* sdl_window;
-    bool should_close_flag;
-};
-
 // --- Internal State --- //
+// Mouse and text input are routed to the window they happened in and kept
+// in its PAL_Window. The keyboard state is the device's, as SDL reports it;
+// pal_input_get_keyboard_window says which window it is aimed at.
 
-static int mouse_x = 0;
-static int mouse_y = 0;
-static float mouse_wheel_x = 0.0f;
-static float mouse_wheel_y = 0.0f;
-
-static Uint32 mouse_state_current = 0;
-static Uint32 mouse_state_prev = 0;
+static Uint32 last_mouse_window_id = 0; // Window the unscoped mouse queries read when the pointer is outside all windows
 
 static const Uint8* keyboard_state_current = NULL;
 static Uint8* keyboard_state_prev = NULL;
 static int num_keys = 0; // Will be set on first poll
 
-#define MAX_TEXT_INPUT_LEN 32
-static char text_input_buffer[MAX_TEXT_INPUT_LEN] = {0};
-
 // --- Helper Functions --- //
 
 // Remove unused helper function
@@ -46,16 +33,28 @@ static Uint32 pal_button_to_sdl_mask(PAL_MouseButton pal_button) {
     }
 }
 
+static PAL_Window* window_from_sdl(SDL_Window* sdl_window) {
+    return sdl_window ? pal_sdl_window_from_id(SDL_GetWindowID(sdl_window)) : NULL;
+}
+
+// Window the mouse queries report on: the one under the pointer, or the last one it was over
+static PAL_Window* mouse_window(void) {
+    PAL_Window* window = window_from_sdl(SDL_GetMouseFocus());
+    return window ? window : pal_sdl_window_from_id(last_mouse_window_id);
+}
+
 // --- Event Polling --- //
 
 void pal_input_poll_events(PAL_Window* window) {
-    if (!window) return;
-
-    // Update previous states
-    mouse_state_prev = mouse_state_current;
-    mouse_wheel_x = 0.0f;
-    mouse_wheel_y = 0.0f;
-    text_input_buffer[0] = '\0'; // Clear text input buffer
+    (void)window; // Events for every window are handled and routed by window ID
+
+    // Start a new frame of per-window input
+    for (PAL_Window* w = pal_sdl_window_list(); w; w = w->next) {
+        w->mouse_buttons_prev = w->mouse_buttons;
+        w->wheel_x = 0.0f;
+        w->wheel_y = 0.0f;
+        w->text_input[0] = '\0'; // Clear text input buffer
+    }
 
     if (keyboard_state_current) {
         if (!keyboard_state_prev) {
@@ -70,60 +69,134 @@ void pal_input_poll_events(PAL_Window* window) {
     // Update current keyboard state pointer (SDL manages this memory)
     keyboard_state_current = SDL_GetKeyboardState(&num_keys);
 
-    // Update current mouse state
-    mouse_state_current = SDL_GetMouseState(&mouse_x, &mouse_y);
-
-    // Process SDL event queue
+    // Process SDL event queue. Events for windows already destroyed find no
+    // window and are dropped.
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
+        PAL_Window* target = NULL;
         switch (event.type) {
             case SDL_QUIT:
-                window->should_close_flag = true;
+                // Last window closed or the application was asked to quit
+                for (PAL_Window* w = pal_sdl_window_list(); w; w = w->next) {
+                    w->should_close_flag = true;
+                }
+                break;
+            case SDL_MOUSEMOTION:
+                target = pal_sdl_window_from_id(event.motion.windowID);
+                if (target) {
+                    target->mouse_x = event.motion.x;
+                    target->mouse_y = event.motion.y;
+                }
+                break;
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+                target = pal_sdl_window_from_id(event.button.windowID);
+                if (target) {
+                    target->mouse_x = event.button.x;
+                    target->mouse_y = event.button.y;
+                    if (event.type == SDL_MOUSEBUTTONDOWN) {
+                        target->mouse_buttons |= SDL_BUTTON(event.button.button);
+                    } else {
+                        target->mouse_buttons &= ~SDL_BUTTON(event.button.button);
+                    }
+                }
                 break;
             case SDL_MOUSEWHEEL:
-                mouse_wheel_x = event.wheel.x;
-                mouse_wheel_y = event.wheel.y;
+                target = pal_sdl_window_from_id(event.wheel.windowID);
+                if (target) {
+                    // Several wheel events can arrive in one frame
+                    target->wheel_x += event.wheel.x;
+                    target->wheel_y += event.wheel.y;
+                }
                 // SDL uses positive for scroll away from user (up/right)
                 // Many UIs expect positive for scroll towards user (down/right)
                 // Adjust if necessary based on UI framework convention:
                 // mouse_wheel_y *= -1.0f; 
                 break;
+            case SDL_WINDOWEVENT:
+                target = pal_sdl_window_from_id(event.window.windowID);
+                if (!target) break;
+                if (event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                    // Uncovered or restored windows need their last frame presented again
+                    target->exposed = true;
+                } else if (event.window.event == SDL_WINDOWEVENT_CLOSE) {
+                    // With several windows open SDL_QUIT only follows the last one
+                    target->should_close_flag = true;
+                } else if (event.window.event == SDL_WINDOWEVENT_ENTER) {
+                    last_mouse_window_id = target->window_id;
+                }
+                break;
             case SDL_TEXTINPUT:
-                // Append text input to buffer (simple concatenation)
-                strncat(text_input_buffer, event.text.text, MAX_TEXT_INPUT_LEN - strlen(text_input_buffer) - 1);
+                target = pal_sdl_window_from_id(event.text.windowID);
+                if (target) {
+                    // Append text input to buffer, truncated to the space left
+                    size_t used = strlen(target->text_input);
+                    size_t length = strlen(event.text.text);
+                    size_t space = PAL_WINDOW_TEXT_INPUT_SIZE - used - 1;
+                    if (length > space) length = space;
+                    memcpy(target->text_input + used, event.text.text, length);
+                    target->text_input[used + length] = '\0';
+                }
                 break;
-            // Handle other events like window resize, keyboard/mouse button presses/releases
+            // Handle other events like window resize, keyboard presses/releases
             // These are implicitly handled by querying SDL_Get*State functions below,
             // but specific event handling could be added here if needed.
         }
     }
+
+    // The pointer may not have moved since the window appeared under it
+    PAL_Window* hovered = window_from_sdl(SDL_GetMouseFocus());
+    if (hovered) {
+        last_mouse_window_id = hovered->window_id;
+        SDL_GetMouseState(&hovered->mouse_x, &hovered->mouse_y);
+    }
+}
+
+bool pal_input_wait_events(PAL_Window* window, int timeout_ms) {
+    // Passing NULL leaves the event queued for the regular poll below
+    bool has_event = (timeout_ms < 0) ? SDL_WaitEvent(NULL) != 0 : SDL_WaitEventTimeout(NULL, timeout_ms) != 0;
+    pal_input_poll_events(window);
+    return has_event;
 }
 
 // --- Input State Queries --- //
 
+PAL_Window* pal_input_get_mouse_window(void) {
+    return window_from_sdl(SDL_GetMouseFocus());
+}
+
+PAL_Window* pal_input_get_keyboard_window(void) {
+    return window_from_sdl(SDL_GetKeyboardFocus());
+}
+
 void pal_input_get_mouse_pos(int* x, int* y) {
-    if (x) *x = mouse_x;
-    if (y) *y = mouse_y;
+    PAL_Window* window = mouse_window();
+    if (x) *x = window ? window->mouse_x : 0;
+    if (y) *y = window ? window->mouse_y : 0;
 }
 
 bool pal_input_is_mouse_button_down(PAL_MouseButton button) {
+    PAL_Window* window = mouse_window();
     Uint32 mask = pal_button_to_sdl_mask(button);
-    return (mouse_state_current & mask) != 0;
+    return window && (window->mouse_buttons & mask) != 0;
 }
 
 bool pal_input_is_mouse_button_pressed(PAL_MouseButton button) {
+    PAL_Window* window = mouse_window();
     Uint32 mask = pal_button_to_sdl_mask(button);
-    return ((mouse_state_current & mask) != 0) && ((mouse_state_prev & mask) == 0);
+    return window && ((window->mouse_buttons & mask) != 0) && ((window->mouse_buttons_prev & mask) == 0);
 }
 
 bool pal_input_is_mouse_button_released(PAL_MouseButton button) {
+    PAL_Window* window = mouse_window();
     Uint32 mask = pal_button_to_sdl_mask(button);
-    return ((mouse_state_current & mask) == 0) && ((mouse_state_prev & mask) != 0);
+    return window && ((window->mouse_buttons & mask) == 0) && ((window->mouse_buttons_prev & mask) != 0);
 }
 
 void pal_input_get_mouse_wheel(float* x_offset, float* y_offset) {
-    if (x_offset) *x_offset = mouse_wheel_x;
-    if (y_offset) *y_offset = mouse_wheel_y;
+    PAL_Window* window = mouse_window();
+    if (x_offset) *x_offset = window ? window->wheel_x : 0.0f;
+    if (y_offset) *y_offset = window ? window->wheel_y : 0.0f;
 }
 
 bool pal_input_is_key_down(PAL_KeyCode key) {
@@ -149,7 +222,8 @@ bool pal_input_is_key_released(PAL_KeyCode key) {
 }
 
 const char* pal_input_get_text_input(void) {
-    return text_input_buffer;
+    PAL_Window* window = pal_input_get_keyboard_window();
+    return window ? window->text_input : "";
 }
 
 // TODO: Add function to cleanup keyboard_state_prev buffer on shutdown?
@@ -0,0 +1,163 @@
+#include "pal_sdl_program_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PAL_PROGRAM_CACHE_MAGIC 0x50474C50u // "PLGP" read as little-endian bytes
+#define PAL_PROGRAM_CACHE_VERSION 1
+#define PAL_PROGRAM_CACHE_MAX_BINARY (64u * 1024u * 1024u) // Rejects corrupt length fields
+
+// Written in native byte order: the file is only ever read back by the same machine
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;           // Full key, in case two keys share a file name
+    uint32_t binary_format; // As returned by glGetProgramBinary
+    uint32_t binary_length;
+} PAL_ProgramCacheHeader;
+
+// 64-bit FNV-1a, continued from hash
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static uint64_t hash_string(uint64_t hash, const char* string) {
+    // The terminator separates consecutive strings, so "ab"+"c" differs from "a"+"bc"
+    return hash_bytes(hash, string ? string : "", string ? strlen(string) + 1 : 1);
+}
+
+static uint64_t program_key(const PAL_ProgramCache* cache, const char* vertex_source, const char* fragment_source) {
+    uint64_t hash = hash_string(cache->driver_hash, vertex_source);
+    return hash_string(hash, fragment_source);
+}
+
+// Returns a malloc'd "<directory>/<key>.bin"
+static char* program_path(const PAL_ProgramCache* cache, uint64_t key) {
+    size_t size = strlen(cache->directory) + 1 + 16 + 4 + 1;
+    char* path = (char*)malloc(size);
+    if (path) {
+        snprintf(path, size, "%s/%016llx.bin", cache->directory, (unsigned long long)key);
+    }
+    return path;
+}
+
+void program_cache_init(PAL_ProgramCache* cache, const char* directory) {
+    memset(cache, 0, sizeof(*cache));
+    if (!directory || !directory[0]) return;
+
+    if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary) {
+        fprintf(stderr, "PAL Renderer Warning: Program binaries unsupported, shader cache disabled\n");
+        return;
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        // Some drivers expose the entry points but cannot save anything
+        fprintf(stderr, "PAL Renderer Warning: Driver offers no program binary formats, shader cache disabled\n");
+        return;
+    }
+
+    cache->directory = (char*)malloc(strlen(directory) + 1);
+    if (!cache->directory) return;
+    strcpy(cache->directory, directory);
+
+    uint64_t hash = 0xcbf29ce484222325ULL; // FNV offset basis
+    hash = hash_string(hash, (const char*)glGetString(GL_VENDOR));
+    hash = hash_string(hash, (const char*)glGetString(GL_RENDERER));
+    hash = hash_string(hash, (const char*)glGetString(GL_VERSION));
+    cache->driver_hash = hash;
+}
+
+void program_cache_destroy(PAL_ProgramCache* cache) {
+    free(cache->directory);
+    memset(cache, 0, sizeof(*cache));
+}
+
+bool program_cache_enabled(const PAL_ProgramCache* cache) {
+    return cache->directory != NULL;
+}
+
+GLuint program_cache_load(PAL_ProgramCache* cache, const char* vertex_source, const char* fragment_source) {
+    if (!cache->directory) return 0;
+
+    uint64_t key = program_key(cache, vertex_source, fragment_source);
+    char* path = program_path(cache, key);
+    if (!path) return 0;
+    FILE* file = fopen(path, "rb");
+    free(path);
+    if (!file) return 0; // Not cached yet
+
+    PAL_ProgramCacheHeader header;
+    void* binary = NULL;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 header.magic == PAL_PROGRAM_CACHE_MAGIC && header.version == PAL_PROGRAM_CACHE_VERSION &&
+                 header.key == key && header.binary_length > 0 &&
+                 header.binary_length <= PAL_PROGRAM_CACHE_MAX_BINARY;
+    if (valid) {
+        binary = malloc(header.binary_length);
+        valid = binary && fread(binary, header.binary_length, 1, file) == 1;
+    }
+    fclose(file);
+    if (!valid) {
+        free(binary);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, (GLenum)header.binary_format, binary, (GLsizei)header.binary_length);
+    free(binary);
+
+    // The driver validates the binary and reports a failed link if it cannot use it
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void program_cache_store(PAL_ProgramCache* cache, GLuint program, const char* vertex_source, const char* fragment_source) {
+    if (!cache->directory || !program) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || (uint32_t)length > PAL_PROGRAM_CACHE_MAX_BINARY) return;
+
+    void* binary = malloc((size_t)length);
+    if (!binary) return;
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary);
+    if (written <= 0) {
+        free(binary);
+        return;
+    }
+
+    PAL_ProgramCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = PAL_PROGRAM_CACHE_MAGIC;
+    header.version = PAL_PROGRAM_CACHE_VERSION;
+    header.key = program_key(cache, vertex_source, fragment_source);
+    header.binary_format = (uint32_t)format;
+    header.binary_length = (uint32_t)written;
+
+    char* path = program_path(cache, header.key);
+    FILE* file = path ? fopen(path, "wb") : NULL;
+    bool saved = file && fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 fwrite(binary, (size_t)written, 1, file) == 1;
+    if (file && fclose(file) != 0) saved = false;
+    if (!saved) {
+        // A partial file fails validation on load, but need not stay around
+        if (file) remove(path);
+        fprintf(stderr, "PAL Renderer Warning: Failed to write shader cache file in %s\n", cache->directory);
+    }
+    free(path);
+    free(binary);
+}
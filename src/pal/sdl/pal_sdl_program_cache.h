@@ -0,0 +1,47 @@
+#ifndef PAL_SDL_PROGRAM_CACHE_H
+#define PAL_SDL_PROGRAM_CACHE_H
+
+// Internal to the SDL/OpenGL renderer backend - not part of the public API.
+
+#include <glad/glad.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- Program Cache --- //
+// Keeps linked programs on disk as driver binaries (glGetProgramBinary), one
+// file per program, named after a hash of the GL vendor, renderer and version
+// strings and both shader sources. Changing a shader or updating the driver
+// changes the name, so stale binaries are not even opened; one the driver
+// still rejects is recompiled from source and overwritten.
+typedef struct {
+    char* directory;      // NULL when disabled or unsupported
+    uint64_t driver_hash; // Vendor, renderer and version strings
+} PAL_ProgramCache;
+
+/**
+ * @brief Enables the cache if the context can return program binaries.
+ *        The GL context must be current.
+ * @param directory Existing directory for the cache files, or NULL to disable.
+ */
+void program_cache_init(PAL_ProgramCache* cache, const char* directory);
+void program_cache_destroy(PAL_ProgramCache* cache);
+
+/**
+ * @brief True if programs should be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+ *        so program_cache_store can save them.
+ */
+bool program_cache_enabled(const PAL_ProgramCache* cache);
+
+/**
+ * @brief Creates a program from a cached binary.
+ * @return The linked program, or 0 if there is no usable binary.
+ */
+GLuint program_cache_load(PAL_ProgramCache* cache, const char* vertex_source, const char* fragment_source);
+
+/**
+ * @brief Saves a program linked from these sources for later launches.
+ *        Failures only print a warning.
+ */
+void program_cache_store(PAL_ProgramCache* cache, GLuint program, const char* vertex_source, const char* fragment_source);
+
+#endif // PAL_SDL_PROGRAM_CACHE_H
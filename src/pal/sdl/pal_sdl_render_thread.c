@@ -0,0 +1,83 @@
+#include "pal_sdl_render_thread.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int render_thread_main(void* data) {
+    PAL_RenderThread* thread = (PAL_RenderThread*)data;
+
+    SDL_LockMutex(thread->mutex);
+    for (;;) {
+        while (!thread->busy && !thread->quit) {
+            SDL_CondWait(thread->cond, thread->mutex);
+        }
+        if (!thread->busy) break; // Quit with nothing left to run
+
+        // The submitter is blocked from touching the job's data until busy clears
+        SDL_UnlockMutex(thread->mutex);
+        thread->run(thread->user_data);
+        SDL_LockMutex(thread->mutex);
+
+        thread->busy = false;
+        SDL_CondBroadcast(thread->cond);
+    }
+    SDL_UnlockMutex(thread->mutex);
+    return 0;
+}
+
+bool render_thread_start(PAL_RenderThread* thread, PAL_RenderJobFunction run, void* user_data) {
+    memset(thread, 0, sizeof(*thread));
+    thread->run = run;
+    thread->user_data = user_data;
+
+    thread->mutex = SDL_CreateMutex();
+    thread->cond = SDL_CreateCond();
+    if (thread->mutex && thread->cond) {
+        thread->thread = SDL_CreateThread(render_thread_main, "PAL Render", thread);
+    }
+    if (!thread->thread) {
+        fprintf(stderr, "PAL Renderer Error: Failed to start render thread: %s\n", SDL_GetError());
+        render_thread_stop(thread);
+        return false;
+    }
+    return true;
+}
+
+void render_thread_stop(PAL_RenderThread* thread) {
+    if (thread->thread) {
+        SDL_LockMutex(thread->mutex);
+        thread->quit = true;
+        SDL_CondBroadcast(thread->cond);
+        SDL_UnlockMutex(thread->mutex);
+        SDL_WaitThread(thread->thread, NULL);
+    }
+    if (thread->cond) SDL_DestroyCond(thread->cond);
+    if (thread->mutex) SDL_DestroyMutex(thread->mutex);
+    memset(thread, 0, sizeof(*thread));
+}
+
+void render_thread_submit(PAL_RenderThread* thread) {
+    SDL_LockMutex(thread->mutex);
+    while (thread->busy) {
+        SDL_CondWait(thread->cond, thread->mutex);
+    }
+    thread->busy = true;
+    SDL_CondBroadcast(thread->cond);
+    SDL_UnlockMutex(thread->mutex);
+}
+
+void render_thread_wait_idle(PAL_RenderThread* thread) {
+    SDL_LockMutex(thread->mutex);
+    while (thread->busy) {
+        SDL_CondWait(thread->cond, thread->mutex);
+    }
+    SDL_UnlockMutex(thread->mutex);
+}
+
+void render_thread_lock(const PAL_RenderThread* thread) {
+    SDL_LockMutex(thread->mutex);
+}
+
+void render_thread_unlock(const PAL_RenderThread* thread) {
+    SDL_UnlockMutex(thread->mutex);
+}
@@ -0,0 +1,52 @@
+#ifndef PAL_SDL_RENDER_THREAD_H
+#define PAL_SDL_RENDER_THREAD_H
+
+// Internal to the SDL/OpenGL renderer backend - not part of the public API.
+
+#include <SDL.h>
+#include <stdbool.h>
+
+typedef void (*PAL_RenderJobFunction)(void* user_data);
+
+// --- Render Thread --- //
+// A worker that runs one job at a time: the renderer hands it a finished
+// frame and goes on recording the next one. The handoff holds a single job,
+// so a caller submitting while the previous frame is still running waits for
+// it; the UI thread can never get more than one frame ahead.
+// The mutex is recursive (SDL mutexes are) and also guards state that both
+// threads read, such as statistics published by the job.
+typedef struct {
+    SDL_Thread* thread;
+    SDL_mutex* mutex;
+    SDL_cond* cond;       // Signalled when a job is submitted or finished, and on stop
+    PAL_RenderJobFunction run;
+    void* user_data;
+    bool busy;            // A job was submitted and has not finished
+    bool quit;
+} PAL_RenderThread;
+
+/**
+ * @brief Starts the thread; every submitted job calls run(user_data) on it.
+ */
+bool render_thread_start(PAL_RenderThread* thread, PAL_RenderJobFunction run, void* user_data);
+
+/**
+ * @brief Lets a running job finish, then joins the thread. Safe on a thread that never started.
+ */
+void render_thread_stop(PAL_RenderThread* thread);
+
+/**
+ * @brief Waits for the previous job to finish, then starts a new one.
+ *        Whatever the job reads must be in place before this call.
+ */
+void render_thread_submit(PAL_RenderThread* thread);
+
+/**
+ * @brief Blocks until no job is running.
+ */
+void render_thread_wait_idle(PAL_RenderThread* thread);
+
+void render_thread_lock(const PAL_RenderThread* thread);
+void render_thread_unlock(const PAL_RenderThread* thread);
+
+#endif // PAL_SDL_RENDER_THREAD_H
@@ -1,34 +1,214 @@
 #include "ui_framework/pal/pal_renderer.h"
 #include "ui_framework/pal/pal_window.h"
+#include "ui_framework/pal/pal_quad_batch.h"
+#include "pal_sdl_frame_pacer.h"
+#include "pal_sdl_gpu_timer.h"
+#include "pal_sdl_capture.h"
+#include "pal_sdl_gl_state.h"
+#include "pal_sdl_window_internal.h"
+#include "pal_sdl_texture_registry.h"
+#include "pal_sdl_render_thread.h"
+#include "pal_sdl_program_cache.h"
+
+#ifdef PAL_HAS_HEADLESS
+#include "../egl/pal_egl_headless.h"
+#endif
 
 #include <glad/glad.h>
 #include <SDL.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// --- Draw List --- //
+// Draw calls are not issued immediately. Each submission is appended to a
+// per-frame vertex array and recorded as a command; consecutive submissions
+// sharing the same texture and scissor state are merged into one command.
+// The whole list is flushed in pal_renderer_flush / pal_renderer_end_frame.
+
+#define PAL_DRAW_LIST_INITIAL_VERTICES 4096
+#define PAL_DRAW_LIST_INITIAL_INDICES 4096
+#define PAL_DRAW_LIST_INITIAL_RECTS 256
+#define PAL_DRAW_LIST_INITIAL_COMMANDS 64
+
+// Quads are drawn from a static index buffer holding the pattern
+// {0,1,2, 0,2,3} repeated for PAL_QUAD_BATCH_MAX quads with 16-bit indices.
+// A quad command never covers more quads than the pattern does.
+#define PAL_QUAD_BATCH_MAX 16384
+
+typedef enum {
+    PAL_DRAW_MODE_TRIANGLES, // Non-indexed triangle list (glDrawArrays)
+    PAL_DRAW_MODE_QUADS,     // 4 vertices per quad, static quad index pattern
+    PAL_DRAW_MODE_INDEXED,   // Arbitrary mesh with indices from the draw list
+    PAL_DRAW_MODE_RECTS      // Instanced SDF rectangles (separate pipeline)
+} PAL_DrawMode;
+
+typedef struct {
+    bool enabled;
+    int x, y, width, height; // In GL (bottom-left origin) coordinates
+} PAL_ScissorState;
+
+typedef struct {
+    PAL_DrawMode mode;
+    GLuint texture;
+    PAL_ScissorState scissor;
+    size_t vertex_offset;
+    size_t vertex_count;
+    size_t index_offset; // PAL_DRAW_MODE_INDEXED only; indices are relative to vertex_offset
+    size_t index_count;
+    size_t rect_offset;  // PAL_DRAW_MODE_RECTS only
+    size_t rect_count;
+} PAL_DrawCommand;
+
+typedef struct {
+    unsigned char* vertices; // PAL_Vertex or PAL_VertexCompact, see vertex_stride
+    size_t vertex_stride;
+    size_t vertex_count;
+    size_t vertex_capacity;
+
+    uint32_t* indices;
+    size_t index_count;
+    size_t index_capacity;
+
+    PAL_RectInstance* rects;
+    size_t rect_count;
+    size_t rect_capacity;
+
+    PAL_DrawCommand* commands;
+    size_t command_count;
+    size_t command_capacity;
+} PAL_DrawList;
+
+_Static_assert(sizeof(PAL_RectInstance) == 48, "PAL_RectInstance layout must match the rect pipeline attributes");
+
+// --- Damage Tracking --- //
+// With PAL_RendererConfig.damage_tracking the frame is drawn into a persistent
+// offscreen scene target instead of the back buffer (whose contents are
+// undefined after a swap). Only the bounding box of the damage reported since
+// the previous frame is cleared and redrawn - every command is clipped to it -
+// and the scene is then blitted to the back buffer. Frames without damage skip
+// rendering and SDL_GL_SwapWindow altogether.
+
+typedef struct {
+    bool full;          // Whole window damaged
+    int x0, y0, x1, y1; // Bounding box in window coordinates (top-left origin); empty if x0 >= x1
+} PAL_DamageRegion;
+
+// --- Streaming Buffer --- //
+// A single GL buffer split into PAL_STREAM_FRAME_COUNT regions, one per frame
+// in flight. Each frame writes sequentially into its own region with
+// unsynchronized mapped writes; a fence placed at the end of the frame guards
+// the region against being overwritten before the GPU has consumed it.
+// Storage is only reallocated if a frame outgrows its region. Uploads go
+// through GL_COPY_WRITE_BUFFER so they never disturb vertex array or element
+// bindings tracked by the state cache.
+
+#define PAL_STREAM_FRAME_COUNT 3
+#define PAL_STREAM_INITIAL_REGION_SIZE (2 * 1024 * 1024) // Bytes per frame region
+#define PAL_STREAM_INITIAL_INDEX_REGION_SIZE (512 * 1024)
+#define PAL_STREAM_INITIAL_UPLOAD_REGION_SIZE (1024 * 1024) // Pixel unpack staging
+
+typedef struct {
+    GLuint buffer;
+    size_t region_size;   // Bytes per frame region
+    int region;           // Region written by the current frame
+    size_t offset;        // Write offset within the current region
+    size_t fenced_offset; // Bytes of the current region its fence covers
+    GLsync fences[PAL_STREAM_FRAME_COUNT];
+} PAL_StreamBuffer;
+
+// --- Share Group --- //
+// GL objects that every renderer created with pal_renderer_create_shared uses
+// together with the original: their contexts share object names, so programs,
+// static buffers and textures (atlas pages included) exist once. Vertex arrays
+// and framebuffers are container objects GL never shares, so each renderer
+// keeps its own, along with its streaming buffers, whose fenced regions follow
+// that renderer's frames.
+typedef struct {
+    int ref_count; // Renderers in the group; the last one destroys the objects
 
-// Define PAL_Window struct again to access SDL_Window and SDL_GLContext
-struct PAL_Window {
-    SDL_Window* sdl_window;
-    SDL_GLContext gl_context;
-    bool should_close_flag;
-};
+    GLuint shader_program;
+    GLint proj_matrix_location;
+    GLint texture_sampler_location;
+    GLuint rect_program; // SDF rectangle pipeline (one instance per rectangle)
+    GLint rect_proj_matrix_location;
+    GLuint quad_index_buffer; // Static quad index pattern
+    GLuint default_texture;   // 1x1 white texture
+
+    PAL_TextureRegistry textures; // Every texture handed out by pal_renderer_create_texture
+    uint64_t frame_serial;        // Frames begun by any renderer in the group; stamps texture use for LRU eviction
+} PAL_ShareGroup;
+
+// Everything the GL side needs to know about a recorded frame. With a render
+// thread the UI thread fills one in while recording and hands a copy over
+// with the frame's draw list.
+typedef struct {
+    int width;               // Target size the frame was recorded at
+    int height;
+    PAL_ScissorState clip;   // Damage clip (GL coordinates)
+    Color clear_color;
+    uint64_t frame_index;
+    bool skipped;            // No damage: nothing is drawn
+    bool present;            // Skipped, but the window still needs presenting
+} PAL_FrameState;
 
 // Internal structure for the opaque PAL_Renderer handle
 struct PAL_Renderer {
-    PAL_Window* pal_window;
+    PAL_Window* pal_window;   // NULL for headless renderers
     SDL_GLContext gl_context;
+    struct PAL_HeadlessContext* headless; // Offscreen EGL context (headless renderers only)
+    PAL_ShareGroup* share;    // Programs and textures, possibly used by other renderers too
 
-    GLuint shader_program;
     GLuint vao;
-    GLuint vbo;
-    GLuint default_texture; // 1x1 white texture
+    PAL_StreamBuffer vertex_stream;
+    PAL_StreamBuffer index_stream;
+    PAL_StreamBuffer upload_stream; // Pixel unpack staging for texture updates
 
-    // Uniform locations
-    GLint proj_matrix_location;
-    GLint texture_sampler_location;
+    GLuint rect_vao; // Instance attributes for the shared SDF rectangle program
+    bool rect_projection_dirty;
 
-    int window_width;
+    int window_width;      // Size the GL state (viewport, projection, scene target) is set up for
     int window_height;
+    bool projection_dirty; // Projection uniform needs recomputing (window resized)
+
+    PAL_GLStateCache gl_state;
+    uint64_t frame_index;         // Incremented by begin_frame
+    PAL_RendererStats frame_stats;      // Accumulating for the frame in progress
+    PAL_RendererStats last_frame_stats; // Snapshot of the last completed frame
+
+    PAL_VertexFormat vertex_format; // Layout of the draw list and vertex buffer
+    PAL_DrawList draw_lists[2]; // The second is only used with a render thread
+    PAL_DrawList* draw_list;    // List being recorded; the other one may be executing on the render thread
+    PAL_ScissorState scissor; // Scissor applied to subsequent submissions
+    PAL_GLTexture* layer;     // Layer being drawn into (pal_renderer_begin_layer), NULL for the frame
+    GLuint layer_fbo;         // Framebuffer the layer being drawn is attached to, created on first use
+
+    // Damage tracking (only used when enabled in the config)
+    bool damage_tracking;
+    bool use_scene_target;       // Frames render into scene_fbo (damage tracking or headless)
+    GLuint scene_fbo;            // Persistent copy of the window contents
+    GLuint scene_texture;
+    PAL_DamageRegion damage;     // Accumulated for the next frame
+    PAL_ScissorState frame_clip; // Damage clip applied by the GL side for the frame it is drawing
+    bool present_pending;        // Window was exposed; present the scene even without damage
+
+    PAL_FrameState frame; // Frame being recorded (see pal_renderer_begin_frame)
+
+    // Render thread (PAL_RendererConfig.render_thread). The GL context lives
+    // on it between frames; the UI thread takes it back for GL work of its
+    // own, after waiting for the frame in flight.
+    bool threaded;
+    PAL_RenderThread render_thread;
+    PAL_FrameState job_frame;   // Frame handed to the render thread
+    PAL_DrawList* job_list;
+    bool job_begin;             // The job still has to set up the frame (frame_begin_gl)
+    bool context_on_caller;     // The UI thread holds the context
+    bool frame_begin_pending;   // The frame being recorded has not been set up on the GL side yet
+
+    PAL_FramePacer pacer; // Present mode, frame pacing and interval measurement
+    PAL_GpuTimer gpu_timer; // Timestamp queries around frames and labelled passes
+    PAL_CaptureQueue capture; // Asynchronous frame readback for captures and streams
 };
 
 // --- Shader Code --- //
@@ -64,6 +244,99 @@ void main() {
 }
 )";
 
+// Rectangle pipeline: each instance is expanded to a quad covering the rect
+// plus its shadow, and the fragment shader evaluates a rounded-box signed
+// distance field for fill, border and shadow with analytic anti-aliasing.
+const char* rect_vertex_shader_source = R"(
+#version 330 core
+layout (location = 0) in vec4 aRect;         // x, y, width, height
+layout (location = 1) in vec3 aParams;       // corner radius, border width, shadow blur
+layout (location = 2) in vec4 aFillColor;
+layout (location = 3) in vec4 aBorderColor;
+layout (location = 4) in vec4 aShadowColor;
+layout (location = 5) in vec2 aShadowOffset;
+
+out vec2 LocalPos; // Pixel position relative to the rect center
+flat out vec2 HalfSize;
+flat out vec3 Params;
+flat out vec4 FillColor;
+flat out vec4 BorderColor;
+flat out vec4 ShadowColor;
+flat out vec2 ShadowOffset;
+
+uniform mat4 projection;
+
+void main() {
+    // Triangle strip corners: (0,0) (1,0) (0,1) (1,1)
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    vec2 halfSize = aRect.zw * 0.5;
+    vec2 center = aRect.xy + halfSize;
+
+    // Grow the quad to cover the shadow and one pixel of anti-aliasing
+    float pad = 1.0;
+    if (aShadowColor.a > 0.0) {
+        pad += aParams.z + max(abs(aShadowOffset.x), abs(aShadowOffset.y));
+    }
+    vec2 local = (corner * 2.0 - 1.0) * (halfSize + pad);
+
+    gl_Position = projection * vec4(center + local, 0.0, 1.0);
+    LocalPos = local;
+    HalfSize = halfSize;
+    Params = aParams;
+    FillColor = aFillColor;
+    BorderColor = aBorderColor;
+    ShadowColor = aShadowColor;
+    ShadowOffset = aShadowOffset;
+}
+)";
+
+const char* rect_fragment_shader_source = R"(
+#version 330 core
+in vec2 LocalPos;
+flat in vec2 HalfSize;
+flat in vec3 Params;
+flat in vec4 FillColor;
+flat in vec4 BorderColor;
+flat in vec4 ShadowColor;
+flat in vec2 ShadowOffset;
+
+out vec4 color;
+
+float sdRoundRect(vec2 p, vec2 halfSize, float radius) {
+    vec2 q = abs(p) - halfSize + vec2(radius);
+    return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+}
+
+void main() {
+    float radius = min(Params.x, min(HalfSize.x, HalfSize.y));
+    float border = Params.y;
+    float blur = Params.z;
+
+    float d = sdRoundRect(LocalPos, HalfSize, radius);
+    float aa = max(fwidth(d), 1e-4);
+    float coverage = clamp(0.5 - d / aa, 0.0, 1.0);
+
+    vec4 shape = FillColor;
+    if (border > 0.0) {
+        float inner = sdRoundRect(LocalPos, max(HalfSize - vec2(border), vec2(0.0)), max(radius - border, 0.0));
+        float fill = clamp(0.5 - inner / aa, 0.0, 1.0);
+        shape = mix(BorderColor, FillColor, fill);
+    }
+    // Premultiplied from here on
+    vec4 result = vec4(shape.rgb * shape.a, shape.a) * coverage;
+
+    if (ShadowColor.a > 0.0) {
+        float ds = sdRoundRect(LocalPos - ShadowOffset, HalfSize, radius);
+        float shadow = (blur > 0.0) ? 1.0 - smoothstep(-blur, blur, ds) : clamp(0.5 - ds / aa, 0.0, 1.0);
+        vec4 shadowColor = vec4(ShadowColor.rgb * ShadowColor.a, ShadowColor.a) * shadow;
+        result += shadowColor * (1.0 - result.a); // Shape over shadow
+    }
+
+    if (result.a <= 0.0) discard;
+    color = vec4(result.rgb / result.a, result.a); // Blending expects straight alpha
+}
+)";
+
 // --- Helper Functions --- //
 static GLuint compile_shader(GLenum type, const char* source) {
     GLuint shader = glCreateShader(type);
@@ -83,10 +356,11 @@ static GLuint compile_shader(GLenum type, const char* source) {
     return shader;
 }
 
-static GLuint link_program(GLuint vertex_shader, GLuint fragment_shader) {
+static GLuint link_program(GLuint vertex_shader, GLuint fragment_shader, bool retrievable) {
     GLuint program = glCreateProgram();
     glAttachShader(program, vertex_shader);
     glAttachShader(program, fragment_shader);
+    if (retrievable) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program);
 
     GLint success;
@@ -104,285 +378,1954 @@ static GLuint link_program(GLuint vertex_shader, GLuint fragment_shader) {
     return program;
 }
 
-// --- Renderer Lifecycle --- //
+// Compiles and links a vertex/fragment pair, or loads it from the program
+// cache when a previous launch saved it; returns 0 on failure.
+static GLuint build_program(PAL_ProgramCache* cache, const char* vertex_source, const char* fragment_source) {
+    GLuint cached = program_cache_load(cache, vertex_source, fragment_source);
+    if (cached) return cached;
 
-PAL_Renderer* pal_renderer_create(PAL_Window* window) {
-    if (!window || !window->sdl_window) {
-        fprintf(stderr, "PAL Renderer Error: Invalid PAL_Window provided.\n");
-        return NULL;
+    GLuint vert_shader = compile_shader(GL_VERTEX_SHADER, vertex_source);
+    GLuint frag_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+    if (!vert_shader || !frag_shader) {
+        glDeleteShader(vert_shader); // In case one succeeded
+        glDeleteShader(frag_shader);
+        return 0;
     }
-
-    // Create OpenGL context using SDL
-    window->gl_context = SDL_GL_CreateContext(window->sdl_window);
-    if (!window->gl_context) {
-        fprintf(stderr, "PAL Renderer Error: Failed to create SDL GL context: %s\n", SDL_GetError());
-        return NULL;
+    GLuint program = link_program(vert_shader, frag_shader, program_cache_enabled(cache));
+    if (!program) {
+        glDeleteShader(vert_shader);
+        glDeleteShader(frag_shader);
+        return 0;
     }
+    program_cache_store(cache, program, vertex_source, fragment_source);
+    return program;
+}
 
-    // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress)) {
-        fprintf(stderr, "PAL Renderer Error: Failed to initialize GLAD\n");
-        SDL_GL_DeleteContext(window->gl_context);
-        window->gl_context = NULL;
-        return NULL;
+// --- Draw List Helpers --- //
+static bool draw_list_init(PAL_DrawList* list, size_t vertex_stride) {
+    list->vertex_stride = vertex_stride;
+    list->vertices = (unsigned char*)malloc(PAL_DRAW_LIST_INITIAL_VERTICES * vertex_stride);
+    list->indices = (uint32_t*)malloc(PAL_DRAW_LIST_INITIAL_INDICES * sizeof(uint32_t));
+    list->rects = (PAL_RectInstance*)malloc(PAL_DRAW_LIST_INITIAL_RECTS * sizeof(PAL_RectInstance));
+    list->commands = (PAL_DrawCommand*)malloc(PAL_DRAW_LIST_INITIAL_COMMANDS * sizeof(PAL_DrawCommand));
+    if (!list->vertices || !list->indices || !list->rects || !list->commands) {
+        free(list->vertices);
+        free(list->indices);
+        free(list->rects);
+        free(list->commands);
+        list->vertices = NULL;
+        list->indices = NULL;
+        list->rects = NULL;
+        list->commands = NULL;
+        return false;
     }
+    list->vertex_capacity = PAL_DRAW_LIST_INITIAL_VERTICES;
+    list->index_capacity = PAL_DRAW_LIST_INITIAL_INDICES;
+    list->rect_capacity = PAL_DRAW_LIST_INITIAL_RECTS;
+    list->rect_count = 0;
+    list->command_capacity = PAL_DRAW_LIST_INITIAL_COMMANDS;
+    list->vertex_count = 0;
+    list->index_count = 0;
+    list->command_count = 0;
+    return true;
+}
 
-    printf("OpenGL Version: %s\n", glGetString(GL_VERSION));
-    printf("GLSL Version: %s\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
-    printf("Renderer: %s\n", glGetString(GL_RENDERER));
+static void draw_list_free(PAL_DrawList* list) {
+    free(list->vertices);
+    free(list->indices);
+    free(list->rects);
+    free(list->commands);
+    list->vertices = NULL;
+    list->indices = NULL;
+    list->rects = NULL;
+    list->commands = NULL;
+    list->vertex_capacity = list->vertex_count = 0;
+    list->index_capacity = list->index_count = 0;
+    list->rect_capacity = list->rect_count = 0;
+    list->command_capacity = list->command_count = 0;
+}
 
-    // Allocate renderer structure
-    PAL_Renderer* renderer = (PAL_Renderer*)calloc(1, sizeof(PAL_Renderer)); // Use calloc for zero-init
-    if (!renderer) {
-        fprintf(stderr, "PAL Renderer Error: Failed to allocate PAL_Renderer structure\n");
-        SDL_GL_DeleteContext(window->gl_context);
-        window->gl_context = NULL;
-        return NULL;
+static void draw_list_reset(PAL_DrawList* list) {
+    list->vertex_count = 0;
+    list->index_count = 0;
+    list->rect_count = 0;
+    list->command_count = 0;
+}
+
+static bool draw_list_reserve_vertices(PAL_DrawList* list, size_t additional) {
+    size_t required = list->vertex_count + additional;
+    if (required <= list->vertex_capacity) return true;
+
+    size_t new_capacity = list->vertex_capacity ? list->vertex_capacity : PAL_DRAW_LIST_INITIAL_VERTICES;
+    while (new_capacity < required) new_capacity *= 2;
+
+    unsigned char* vertices = (unsigned char*)realloc(list->vertices, new_capacity * list->vertex_stride);
+    if (!vertices) return false;
+    list->vertices = vertices;
+    list->vertex_capacity = new_capacity;
+    return true;
+}
+
+static inline int16_t compact_position(float value) {
+    float fixed = value * (float)(1 << PAL_COMPACT_VERTEX_SUBPIXEL_BITS);
+    if (fixed >= 32767.0f) return INT16_MAX;
+    if (fixed <= -32768.0f) return INT16_MIN;
+    return (int16_t)lrintf(fixed);
+}
+
+static inline uint16_t compact_tex_coord(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return UINT16_MAX;
+    return (uint16_t)(value * 65535.0f + 0.5f);
+}
+
+// Appends vertices given in either layout, converting to the list's layout.
+// Capacity must have been reserved by the caller.
+static void draw_list_append_vertices(PAL_DrawList* list, const void* src, PAL_VertexFormat src_format, size_t count) {
+    unsigned char* dst = list->vertices + list->vertex_count * list->vertex_stride;
+    size_t src_stride = (src_format == PAL_VERTEX_FORMAT_COMPACT) ? sizeof(PAL_VertexCompact) : sizeof(PAL_Vertex);
+
+    if (src_stride == list->vertex_stride) {
+        memcpy(dst, src, count * src_stride);
+    } else if (src_format == PAL_VERTEX_FORMAT_STANDARD) {
+        const PAL_Vertex* in = (const PAL_Vertex*)src;
+        PAL_VertexCompact* out = (PAL_VertexCompact*)dst;
+        for (size_t i = 0; i < count; ++i) {
+            out[i].x = compact_position(in[i].x);
+            out[i].y = compact_position(in[i].y);
+            out[i].u = compact_tex_coord(in[i].u);
+            out[i].v = compact_tex_coord(in[i].v);
+            out[i].color = in[i].color;
+        }
+    } else {
+        const float pos_scale = 1.0f / (float)(1 << PAL_COMPACT_VERTEX_SUBPIXEL_BITS);
+        const PAL_VertexCompact* in = (const PAL_VertexCompact*)src;
+        PAL_Vertex* out = (PAL_Vertex*)dst;
+        for (size_t i = 0; i < count; ++i) {
+            out[i].x = in[i].x * pos_scale;
+            out[i].y = in[i].y * pos_scale;
+            out[i].u = in[i].u / 65535.0f;
+            out[i].v = in[i].v / 65535.0f;
+            out[i].color = in[i].color;
+        }
     }
+    list->vertex_count += count;
+}
 
-    renderer->pal_window = window;
-    renderer->gl_context = window->gl_context;
+static bool draw_list_reserve_indices(PAL_DrawList* list, size_t additional) {
+    size_t required = list->index_count + additional;
+    if (required <= list->index_capacity) return true;
 
-    // Initial GL setup (viewport, clear color etc.)
-    pal_window_get_size(window, &renderer->window_width, &renderer->window_height);
-    glViewport(0, 0, renderer->window_width, renderer->window_height);
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // Default clear color
+    size_t new_capacity = list->index_capacity ? list->index_capacity : PAL_DRAW_LIST_INITIAL_INDICES;
+    while (new_capacity < required) new_capacity *= 2;
 
-    // Make the context current
-    SDL_GL_MakeCurrent(window->sdl_window, renderer->gl_context);
+    uint32_t* indices = (uint32_t*)realloc(list->indices, new_capacity * sizeof(uint32_t));
+    if (!indices) return false;
+    list->indices = indices;
+    list->index_capacity = new_capacity;
+    return true;
+}
+
+static bool draw_list_reserve_rects(PAL_DrawList* list, size_t additional) {
+    size_t required = list->rect_count + additional;
+    if (required <= list->rect_capacity) return true;
+
+    size_t new_capacity = list->rect_capacity ? list->rect_capacity : PAL_DRAW_LIST_INITIAL_RECTS;
+    while (new_capacity < required) new_capacity *= 2;
+
+    PAL_RectInstance* rects = (PAL_RectInstance*)realloc(list->rects, new_capacity * sizeof(PAL_RectInstance));
+    if (!rects) return false;
+    list->rects = rects;
+    list->rect_capacity = new_capacity;
+    return true;
+}
 
-    // Enable VSync (optional, often desired)
-    if (SDL_GL_SetSwapInterval(1) < 0) {
-        fprintf(stderr, "Warning: Unable to set VSync: %s\n", SDL_GetError());
+static PAL_DrawCommand* draw_list_push_command(PAL_DrawList* list) {
+    if (list->command_count == list->command_capacity) {
+        size_t new_capacity = list->command_capacity ? list->command_capacity * 2 : PAL_DRAW_LIST_INITIAL_COMMANDS;
+        PAL_DrawCommand* commands = (PAL_DrawCommand*)realloc(list->commands, new_capacity * sizeof(PAL_DrawCommand));
+        if (!commands) return NULL;
+        list->commands = commands;
+        list->command_capacity = new_capacity;
     }
+    return &list->commands[list->command_count++];
+}
 
-    // --- Compile and Link Shaders --- //
-    GLuint vert_shader = compile_shader(GL_VERTEX_SHADER, vertex_shader_source);
-    GLuint frag_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_shader_source);
-    if (!vert_shader || !frag_shader) {
-        // Error message already printed in compile_shader
-        glDeleteShader(vert_shader); // In case one succeeded
-        glDeleteShader(frag_shader);
-        SDL_GL_DeleteContext(window->gl_context);
-        window->gl_context = NULL;
-        free(renderer);
-        return NULL;
+static bool scissor_state_equal(const PAL_ScissorState* a, const PAL_ScissorState* b) {
+    if (a->enabled != b->enabled) return false;
+    if (!a->enabled) return true; // Rect is irrelevant while disabled
+    return a->x == b->x && a->y == b->y && a->width == b->width && a->height == b->height;
+}
+
+// Returns the command new vertices should be appended to, merging with the
+// previous command when draw mode, texture and scissor state match.
+// added_vertices is only used to keep quad commands within PAL_QUAD_BATCH_MAX.
+static PAL_DrawCommand* draw_list_command_for(PAL_DrawList* list, PAL_DrawMode mode, GLuint texture,
+                                              const PAL_ScissorState* scissor, size_t added_vertices) {
+    if (list->command_count > 0) {
+        PAL_DrawCommand* last = &list->commands[list->command_count - 1];
+        if (last->mode == mode && last->texture == texture && scissor_state_equal(&last->scissor, scissor) &&
+            (mode != PAL_DRAW_MODE_QUADS || last->vertex_count + added_vertices <= PAL_QUAD_BATCH_MAX * 4)) {
+            return last;
+        }
     }
 
-    renderer->shader_program = link_program(vert_shader, frag_shader);
-    if (!renderer->shader_program) {
-        // Error message already printed in link_program
-        SDL_GL_DeleteContext(window->gl_context);
-        window->gl_context = NULL;
-        free(renderer);
-        return NULL;
+    PAL_DrawCommand* cmd = draw_list_push_command(list);
+    if (!cmd) return NULL;
+    cmd->mode = mode;
+    cmd->texture = texture;
+    cmd->scissor = *scissor;
+    cmd->vertex_offset = list->vertex_count;
+    cmd->vertex_count = 0;
+    cmd->index_offset = list->index_count;
+    cmd->index_count = 0;
+    cmd->rect_offset = list->rect_count;
+    cmd->rect_count = 0;
+    return cmd;
+}
+
+// Builds the static index buffer shared by all quad draws.
+static GLuint create_quad_index_buffer(void) {
+    uint16_t* indices = (uint16_t*)malloc(PAL_QUAD_BATCH_MAX * 6 * sizeof(uint16_t));
+    if (!indices) return 0;
+    for (uint32_t quad = 0; quad < PAL_QUAD_BATCH_MAX; ++quad) {
+        uint16_t base = (uint16_t)(quad * 4);
+        uint16_t* dst = indices + quad * 6;
+        dst[0] = base + 0; dst[1] = base + 1; dst[2] = base + 2;
+        dst[3] = base + 0; dst[4] = base + 2; dst[5] = base + 3;
     }
 
-    // Get uniform locations
-    renderer->proj_matrix_location = glGetUniformLocation(renderer->shader_program, "projection");
-    renderer->texture_sampler_location = glGetUniformLocation(renderer->shader_program, "textureSampler");
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, PAL_QUAD_BATCH_MAX * 6 * sizeof(uint16_t), indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    free(indices);
+    return buffer;
+}
 
-    // --- Create VAO and VBO --- //
-    glGenVertexArrays(1, &renderer->vao);
-    glGenBuffers(1, &renderer->vbo);
+// Applies a command's scissor intersected with the frame's damage clip.
+// Returns false if nothing of the command can be visible.
+static bool apply_scissor_state(PAL_GLStateCache* cache, const PAL_ScissorState* scissor, const PAL_ScissorState* clip) {
+    if (!clip->enabled) {
+        gl_state_set_scissor(cache, scissor->enabled, scissor->x, scissor->y, scissor->width, scissor->height);
+        return true;
+    }
+    if (!scissor->enabled) {
+        gl_state_set_scissor(cache, true, clip->x, clip->y, clip->width, clip->height);
+        return true;
+    }
 
-    glBindVertexArray(renderer->vao);
-    glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    int x0 = scissor->x > clip->x ? scissor->x : clip->x;
+    int y0 = scissor->y > clip->y ? scissor->y : clip->y;
+    int x1 = (scissor->x + scissor->width) < (clip->x + clip->width) ? (scissor->x + scissor->width) : (clip->x + clip->width);
+    int y1 = (scissor->y + scissor->height) < (clip->y + clip->height) ? (scissor->y + scissor->height) : (clip->y + clip->height);
+    if (x1 <= x0 || y1 <= y0) return false;
+    gl_state_set_scissor(cache, true, x0, y0, x1 - x0, y1 - y0);
+    return true;
+}
 
-    // --- Setup Vertex Attributes --- //
-    // Position attribute (vec2)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PAL_Vertex), (void*)offsetof(PAL_Vertex, x));
-    glEnableVertexAttribArray(0);
-    // Texture coordinate attribute (vec2)
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(PAL_Vertex), (void*)offsetof(PAL_Vertex, u));
-    glEnableVertexAttribArray(1);
-    // Color attribute (vec4 - interpreted from uint32_t ABGR)
-    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PAL_Vertex), (void*)offsetof(PAL_Vertex, color)); // GL_TRUE normalizes 0-255 to 0.0-1.0
-    glEnableVertexAttribArray(2);
+// --- Damage Tracking Helpers --- //
+static void damage_region_add(PAL_DamageRegion* damage, int x0, int y0, int x1, int y1) {
+    if (damage->x0 >= damage->x1 || damage->y0 >= damage->y1) {
+        damage->x0 = x0;
+        damage->y0 = y0;
+        damage->x1 = x1;
+        damage->y1 = y1;
+        return;
+    }
+    if (x0 < damage->x0) damage->x0 = x0;
+    if (y0 < damage->y0) damage->y0 = y0;
+    if (x1 > damage->x1) damage->x1 = x1;
+    if (y1 > damage->y1) damage->y1 = y1;
+}
 
-    // Unbind VBO and VAO (good practice)
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+// Consumes the accumulated damage, converting it to a GL-coordinate clip
+// (disabled when the whole window is redrawn). Returns false if nothing changed.
+static bool damage_region_take(PAL_DamageRegion* damage, int width, int height, PAL_ScissorState* clip) {
+    bool full = damage->full;
+    int x0 = damage->x0 > 0 ? damage->x0 : 0;
+    int y0 = damage->y0 > 0 ? damage->y0 : 0;
+    int x1 = damage->x1 < width ? damage->x1 : width;
+    int y1 = damage->y1 < height ? damage->y1 : height;
+    memset(damage, 0, sizeof(*damage));
+
+    clip->enabled = false;
+    if (full || (x0 == 0 && y0 == 0 && x1 == width && y1 == height)) return true;
+    if (x1 <= x0 || y1 <= y0) return false;
+
+    clip->enabled = true;
+    clip->x = x0;
+    clip->y = height - y1;
+    clip->width = x1 - x0;
+    clip->height = y1 - y0;
+    return true;
+}
 
-    // --- Create Default Texture (1x1 White Pixel) --- //
-    uint32_t white_pixel = 0xFFFFFFFF; // ABGR format (fully opaque white)
-    glGenTextures(1, &renderer->default_texture);
-    glBindTexture(GL_TEXTURE_2D, renderer->default_texture);
+// (Re)allocates the scene target to match the window size
+static bool scene_target_resize(PAL_Renderer* renderer, int width, int height) {
+    if (!renderer->scene_texture) glGenTextures(1, &renderer->scene_texture);
+    if (!renderer->scene_fbo) glGenFramebuffers(1, &renderer->scene_fbo);
+    if (!renderer->scene_texture || !renderer->scene_fbo) return false;
+
+    gl_state_bind_texture(&renderer->gl_state, renderer->scene_texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    // Use GL_BGRA because our white_pixel is ABGR and OpenGL on Windows often expects BGRA upload order
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_BGRA, GL_UNSIGNED_BYTE, &white_pixel);
-    glBindTexture(GL_TEXTURE_2D, 0); // Unbind
-
-    // --- Set Initial GL State --- //
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 
-    printf("PAL Renderer Initialized Successfully.\n");
-    return renderer;
+    glBindFramebuffer(GL_FRAMEBUFFER, renderer->scene_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->scene_texture, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
 }
 
-void pal_renderer_destroy(PAL_Renderer* renderer) {
-    if (!renderer) return;
+// --- Context Helpers --- //
+// A renderer draws either to a PAL_Window through its SDL GL context, or,
+// headless, into its scene target on an offscreen EGL context.
+
+static void frame_begin_gl(PAL_Renderer* renderer, const PAL_FrameState* frame);
+static void render_thread_run_frame(void* user_data);
+
+static void renderer_make_current(PAL_Renderer* renderer) {
+    if (renderer->threaded) {
+        // The render thread releases the context after each frame
+        render_thread_wait_idle(&renderer->render_thread);
+        if (!renderer->context_on_caller) {
+            SDL_GL_MakeCurrent(renderer->pal_window->sdl_window, renderer->gl_context);
+            renderer->context_on_caller = true;
+        }
+        // GL work mid-frame must land in the frame, so set it up here
+        if (renderer->frame_begin_pending) {
+            renderer->frame_begin_pending = false;
+            frame_begin_gl(renderer, &renderer->frame);
+        }
+        return;
+    }
+#ifdef PAL_HAS_HEADLESS
+    if (renderer->headless) {
+        headless_context_make_current(renderer->headless);
+        return;
+    }
+#endif
+    SDL_GL_MakeCurrent(renderer->pal_window->sdl_window, renderer->gl_context);
+}
 
-    // Delete OpenGL objects
-    glDeleteProgram(renderer->shader_program);
-    glDeleteVertexArrays(1, &renderer->vao);
-    glDeleteBuffers(1, &renderer->vbo);
-    glDeleteTextures(1, &renderer->default_texture);
-    // TODO: Need a way to track and delete user-created textures
+// For GL work between begin_frame and end_frame, where the context is
+// already current unless a render thread owns it
+static void renderer_acquire(PAL_Renderer* renderer) {
+    if (renderer->threaded) renderer_make_current(renderer);
+}
 
-    if(renderer->gl_context) { SDL_GL_DeleteContext(renderer->gl_context); }
+// Guards what the render thread publishes (statistics, timing, captures)
+static void renderer_lock(const PAL_Renderer* renderer) {
+    if (renderer->threaded) render_thread_lock(&renderer->render_thread);
+}
 
-    free(renderer);
+static void renderer_unlock(const PAL_Renderer* renderer) {
+    if (renderer->threaded) render_thread_unlock(&renderer->render_thread);
 }
 
-// --- Frame Operations --- //
-void pal_renderer_begin_frame(PAL_Renderer* renderer, Color clear_color) {
-    if (!renderer) return;
-    SDL_GL_MakeCurrent(renderer->pal_window->sdl_window, renderer->gl_context);
-    // TODO: Check if window size changed, update viewport if needed
-    float r = clear_color.r / 255.0f;
-    float g = clear_color.g / 255.0f;
-    float b = clear_color.b / 255.0f;
-    float a = clear_color.a / 255.0f; // Use alpha too
-    glClearColor(r, g, b, a);
-    glClear(GL_COLOR_BUFFER_BIT);
-    // Reset scissor for the frame
-    pal_renderer_reset_scissor(renderer);
+// Size of the render target: the window, or the fixed headless size
+static void renderer_get_target_size(PAL_Renderer* renderer, int* width, int* height) {
+    if (renderer->pal_window) {
+        pal_window_get_size(renderer->pal_window, width, height);
+    } else {
+        *width = renderer->window_width;
+        *height = renderer->window_height;
+    }
 }
 
-void pal_renderer_end_frame(PAL_Renderer* renderer) {
-    if (!renderer || !renderer->pal_window || !renderer->pal_window->sdl_window) return;
-    // TODO: Flush any batched draw calls here if implementing batching
-    SDL_GL_SwapWindow(renderer->pal_window->sdl_window);
+static void renderer_destroy_context(PAL_Renderer* renderer) {
+#ifdef PAL_HAS_HEADLESS
+    if (renderer->headless) {
+        headless_context_destroy(renderer->headless);
+        renderer->headless = NULL;
+    }
+#endif
+    if (renderer->gl_context) {
+        SDL_GL_DeleteContext(renderer->gl_context);
+        renderer->gl_context = NULL;
+    }
 }
 
-// --- Texture Management --- //
-PAL_TextureHandle pal_renderer_create_texture(PAL_Renderer* renderer, int width, int height, const void* data) {
-    if (!renderer || width <= 0 || height <= 0) return NULL;
+// Sets the swap interval for a present mode and restarts frame timing.
+// The renderer's context must be current.
+static void apply_present_mode(PAL_Renderer* renderer, PAL_PresentMode mode) {
+    if (!renderer->pal_window) {
+        // Nothing to present to: frames complete as fast as they render
+        frame_pacer_init(&renderer->pacer, PAL_PRESENT_MODE_IMMEDIATE, 0);
+        return;
+    }
+    if (mode == PAL_PRESENT_MODE_FRAME_PACED && renderer->threaded) {
+        // The pacer would delay the UI thread against swaps made on the render thread
+        fprintf(stderr, "Warning: Frame pacing is not available with a render thread, using VSync\n");
+        mode = PAL_PRESENT_MODE_VSYNC;
+    }
 
-    GLuint texture_id;
-    glGenTextures(1, &texture_id);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    int interval = 1; // Vsync, also used by frame pacing
+    if (mode == PAL_PRESENT_MODE_IMMEDIATE) interval = 0;
+    else if (mode == PAL_PRESENT_MODE_ADAPTIVE_VSYNC) interval = -1;
+
+    if (SDL_GL_SetSwapInterval(interval) < 0) {
+        if (interval == -1) {
+            fprintf(stderr, "Warning: Adaptive VSync not supported (%s), using VSync\n", SDL_GetError());
+            mode = PAL_PRESENT_MODE_VSYNC;
+            SDL_GL_SetSwapInterval(1);
+        } else {
+            fprintf(stderr, "Warning: Unable to set swap interval %d: %s\n", interval, SDL_GetError());
+        }
+    }
 
-    // Setup texture parameters (common settings)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    int refresh_rate = 0;
+    SDL_DisplayMode display_mode;
+    if (SDL_GetWindowDisplayMode(renderer->pal_window->sdl_window, &display_mode) == 0) {
+        refresh_rate = display_mode.refresh_rate;
+    }
+    frame_pacer_init(&renderer->pacer, mode, refresh_rate);
+}
 
-    // Upload texture data (assuming 32-bit RGBA input, uploaded as BGRA)
-    // Note: The format GL_BGRA is common for SDL surfaces / typical image loading on Windows.
-    // If your input 'data' is RGBA, use GL_RGBA here.
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, data);
+// Copies the scene target to the back buffer
+static void present_scene(PAL_Renderer* renderer) {
+    // Blits are subject to the scissor test as well
+    gl_state_set_scissor(&renderer->gl_state, false, 0, 0, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->scene_fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, renderer->window_width, renderer->window_height,
+                      0, 0, renderer->window_width, renderer->window_height,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-    glBindTexture(GL_TEXTURE_2D, 0); // Unbind
+// --- Streaming Buffer Helpers --- //
+static bool stream_buffer_init(PAL_StreamBuffer* stream, size_t region_size) {
+    memset(stream, 0, sizeof(*stream));
+    stream->region_size = region_size;
+
+    glGenBuffers(1, &stream->buffer);
+    if (!stream->buffer) return false;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, stream->buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(region_size * PAL_STREAM_FRAME_COUNT), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
 
-    // Use casting to store GLuint in the opaque handle
-    return (PAL_TextureHandle)(uintptr_t)texture_id;
+static void stream_buffer_wait_fence(PAL_StreamBuffer* stream, int region) {
+    GLsync fence = stream->fences[region];
+    if (!fence) return;
+
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        // GPU is still reading this region; wait in 1ms slices
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+    if (result == GL_WAIT_FAILED) {
+        fprintf(stderr, "PAL Renderer Warning: Stream buffer fence wait failed\n");
+    }
+    glDeleteSync(fence);
+    stream->fences[region] = NULL;
 }
 
-void pal_renderer_update_texture(PAL_Renderer* renderer, PAL_TextureHandle texture, int width, int height, const void* data) {
-    if (!renderer || !texture || !data || width <= 0 || height <= 0) return;
+static void stream_buffer_destroy(PAL_StreamBuffer* stream) {
+    for (int i = 0; i < PAL_STREAM_FRAME_COUNT; ++i) {
+        if (stream->fences[i]) {
+            glDeleteSync(stream->fences[i]);
+            stream->fences[i] = NULL;
+        }
+    }
+    if (stream->buffer) glDeleteBuffers(1, &stream->buffer);
+    stream->buffer = 0;
+}
 
-    GLuint texture_id = (GLuint)(uintptr_t)texture;
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    // Assuming the texture format doesn't change, just update sub-region or full texture
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+// Fences the current region once all of the frame's draws have been issued.
+static void stream_buffer_end_frame(PAL_StreamBuffer* stream) {
+    if (stream->fences[stream->region]) glDeleteSync(stream->fences[stream->region]);
+    stream->fences[stream->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    stream->fenced_offset = stream->offset;
 }
 
-void pal_renderer_destroy_texture(PAL_Renderer* renderer, PAL_TextureHandle texture) {
-    if (!renderer || !texture) return;
-    GLuint texture_id = (GLuint)(uintptr_t)texture;
-    glDeleteTextures(1, &texture_id);
+// Fences the current region again if anything was written to it since its
+// last fence, so those writes are waited for when the ring comes back around.
+static void stream_buffer_fence_writes(PAL_StreamBuffer* stream) {
+    if (stream->offset != stream->fenced_offset) stream_buffer_end_frame(stream);
 }
 
-// --- Drawing Operations --- //
-void pal_renderer_set_scissor(PAL_Renderer* renderer, int x, int y, int width, int height) {
-    if (!renderer) return;
-    // OpenGL scissor origin is bottom-left, UI coords often top-left.
-    // Need window height to convert.
-    int window_h = renderer->window_height; 
-    glEnable(GL_SCISSOR_TEST);
-    glScissor(x, window_h - (y + height), width, height);
+// Moves to the next frame region, waiting until the GPU has finished with it.
+static void stream_buffer_begin_frame(PAL_StreamBuffer* stream) {
+    // Writes made between frames (texture uploads after end_frame) land in the
+    // current region past its fence
+    stream_buffer_fence_writes(stream);
+
+    stream->region = (stream->region + 1) % PAL_STREAM_FRAME_COUNT;
+    stream->offset = 0;
+    stream->fenced_offset = 0;
+    stream_buffer_wait_fence(stream, stream->region);
 }
 
-void pal_renderer_reset_scissor(PAL_Renderer* renderer) {
-    if (!renderer) return;
-    glDisable(GL_SCISSOR_TEST);
-    // Technically redundant if viewport covers window, but good practice
-    // glScissor(0, 0, renderer->window_width, renderer->window_height); 
+// Reallocates storage so a region can hold at least min_region_size bytes.
+// Only happens when a frame outgrows its region. glBufferData orphans the old
+// storage, so draws already issued keep reading it and no fence wait is needed.
+static void stream_buffer_grow(PAL_StreamBuffer* stream, size_t min_region_size) {
+    size_t new_size = stream->region_size;
+    while (new_size < min_region_size) new_size *= 2;
+
+    for (int i = 0; i < PAL_STREAM_FRAME_COUNT; ++i) {
+        if (stream->fences[i]) {
+            glDeleteSync(stream->fences[i]);
+            stream->fences[i] = NULL;
+        }
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, stream->buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(new_size * PAL_STREAM_FRAME_COUNT), NULL, GL_STREAM_DRAW);
+    stream->region_size = new_size;
+    stream->offset = 0;
+    stream->fenced_offset = 0;
 }
 
-void pal_renderer_render_triangles(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_Vertex* vertices, size_t vertex_count) {
-    if (!renderer || !vertices || vertex_count == 0 || !renderer->shader_program || !renderer->vao || !renderer->vbo) return;
+// Grows the region first if size bytes would not fit after the current
+// offset. Writes that draws read together reserve their combined size, so a
+// grow between them cannot orphan the storage the earlier ones went to.
+static void stream_buffer_reserve(PAL_StreamBuffer* stream, size_t size) {
+    if (stream->offset + size > stream->region_size) stream_buffer_grow(stream, size);
+}
 
-    glUseProgram(renderer->shader_program);
-    glBindVertexArray(renderer->vao);
-    glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+// Copies rows of row_size bytes, src_stride bytes apart in data, into the
+// current frame region as one tightly packed block.
+// Returns the absolute byte offset of the block within the buffer.
+static size_t stream_buffer_write_rows(PAL_StreamBuffer* stream, const void* data, size_t row_size,
+                                       size_t rows, size_t src_stride, size_t alignment) {
+    // Absolute offsets are kept a multiple of the element size so they can be
+    // turned into first-vertex / base-vertex values
+    size_t size = row_size * rows;
+    size_t region_start = (size_t)stream->region * stream->region_size;
+    size_t absolute = (region_start + stream->offset + alignment - 1) / alignment * alignment;
+    if (absolute + size > region_start + stream->region_size) {
+        stream_buffer_grow(stream, size + alignment);
+        region_start = (size_t)stream->region * stream->region_size;
+        absolute = (region_start + alignment - 1) / alignment * alignment;
+    }
+
+    const unsigned char* src = (const unsigned char*)data;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, stream->buffer);
+    unsigned char* dst = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, (GLintptr)absolute, (GLsizeiptr)size,
+                                                          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    bool mapped = dst != NULL;
+    if (mapped) {
+        if (src_stride == row_size) {
+            memcpy(dst, src, size);
+        } else {
+            for (size_t row = 0; row < rows; ++row) memcpy(dst + row * row_size, src + row * src_stride, row_size);
+        }
+        // false means the storage contents were lost (e.g. display mode change); upload again
+        mapped = glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    if (!mapped) {
+        if (src_stride == row_size) {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)absolute, (GLsizeiptr)size, src);
+        } else {
+            for (size_t row = 0; row < rows; ++row) {
+                glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(absolute + row * row_size),
+                                (GLsizeiptr)row_size, src + row * src_stride);
+            }
+        }
+    }
+
+    stream->offset = absolute + size - region_start;
+    return absolute;
+}
+
+// Copies data into the current frame region.
+// Returns the absolute byte offset of the data within the buffer.
+static size_t stream_buffer_write(PAL_StreamBuffer* stream, const void* data, size_t size, size_t alignment) {
+    return stream_buffer_write_rows(stream, data, size, 1, size, alignment);
+}
 
-    // Upload vertex data (using GL_DYNAMIC_DRAW for frequent updates)
-    glBufferData(GL_ARRAY_BUFFER, vertex_count * sizeof(PAL_Vertex), vertices, GL_DYNAMIC_DRAW);
+// Points the rect VAO's per-instance attributes at instance data starting at
+// byte_offset in the vertex stream. The rect VAO must be bound.
+static void point_rect_attributes(PAL_Renderer* renderer, size_t byte_offset) {
+    const GLsizei stride = sizeof(PAL_RectInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->vertex_stream.buffer);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (void*)(byte_offset + offsetof(PAL_RectInstance, x)));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(byte_offset + offsetof(PAL_RectInstance, corner_radius)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(byte_offset + offsetof(PAL_RectInstance, fill_color)));
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(byte_offset + offsetof(PAL_RectInstance, border_color)));
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(byte_offset + offsetof(PAL_RectInstance, shadow_color)));
+    glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, stride, (void*)(byte_offset + offsetof(PAL_RectInstance, shadow_offset_x)));
+}
 
-    // Setup orthographic projection matrix
+// Uploads the pixel-space orthographic projection to the bound program.
+// scale converts vertex positions to pixels (fixed-point compact vertices).
+static void upload_projection(PAL_Renderer* renderer, GLint location, float scale) {
     // Maps rendering coordinates (typically pixel coordinates) to OpenGL clip space (-1 to 1)
     float L = 0.0f;
     float R = (float)renderer->window_width;
     float B = (float)renderer->window_height; // Bottom (adjust if Y-down needed)
     float T = 0.0f;                    // Top
-    // If Y should be down (common for UI): B=0, T=height
-    // B = 0.0f;
-    // T = (float)renderer->window_height;
+    if (renderer->layer) {
+        // Layers are drawn upside down so their top row ends up in texture
+        // row 0, the same as textures created from client pixels
+        R = (float)renderer->layer->width;
+        B = 0.0f;
+        T = (float)renderer->layer->height;
+    }
+    float S = scale;
     const float ortho_projection[4][4] = {
-        { 2.0f/(R-L),   0.0f,         0.0f,   0.0f },
-        { 0.0f,         2.0f/(T-B),   0.0f,   0.0f },
+        { S*2.0f/(R-L), 0.0f,         0.0f,   0.0f },
+        { 0.0f,         S*2.0f/(T-B), 0.0f,   0.0f },
         { 0.0f,         0.0f,        -1.0f,   0.0f },
         { (R+L)/(L-R),  (T+B)/(B-T),  0.0f,   1.0f },
     };
-    glUniformMatrix4fv(renderer->proj_matrix_location, 1, GL_FALSE, &ortho_projection[0][0]);
+    glUniformMatrix4fv(location, 1, GL_FALSE, &ortho_projection[0][0]);
+    gl_state_note_change(&renderer->gl_state);
+}
 
-    // Bind texture
-    glActiveTexture(GL_TEXTURE0); // Activate texture unit 0
-    GLuint texture_id = texture ? (GLuint)(uintptr_t)texture : renderer->default_texture;
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    glUniform1i(renderer->texture_sampler_location, 0); // Tell shader to use texture unit 0
+// --- Renderer Lifecycle --- //
 
-    // Draw the triangles
-    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertex_count);
+PAL_Renderer* pal_renderer_create(PAL_Window* window) {
+    return pal_renderer_create_with_config(window, NULL);
+}
 
-    // Unbind (good practice)
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+// Creates the objects a share group holds. A context of the group must be current.
+static PAL_ShareGroup* share_group_create(const PAL_RendererConfig* config) {
+    PAL_ShareGroup* share = (PAL_ShareGroup*)calloc(1, sizeof(PAL_ShareGroup));
+    if (!share) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate renderer share group\n");
+        return NULL;
+    }
+    share->ref_count = 1;
+    share->textures.budget_bytes = config->texture_budget_bytes;
+
+    // --- Compile and Link Shaders --- //
+    PAL_ProgramCache program_cache;
+    program_cache_init(&program_cache, config->program_cache_dir);
+    share->shader_program = build_program(&program_cache, vertex_shader_source, fragment_shader_source);
+    if (!share->shader_program) {
+        // Error message already printed in compile_shader / link_program
+        program_cache_destroy(&program_cache);
+        free(share);
+        return NULL;
+    }
+
+    // Get uniform locations
+    share->proj_matrix_location = glGetUniformLocation(share->shader_program, "projection");
+    share->texture_sampler_location = glGetUniformLocation(share->shader_program, "textureSampler");
+
+    // Sampler always reads texture unit 0; uniform values persist in the program
+    glUseProgram(share->shader_program);
+    glUniform1i(share->texture_sampler_location, 0);
     glUseProgram(0);
+
+    // --- SDF Rectangle Pipeline --- //
+    share->rect_program = build_program(&program_cache, rect_vertex_shader_source, rect_fragment_shader_source);
+    program_cache_destroy(&program_cache);
+    if (!share->rect_program) {
+        glDeleteProgram(share->shader_program);
+        free(share);
+        return NULL;
+    }
+    share->rect_proj_matrix_location = glGetUniformLocation(share->rect_program, "projection");
+
+    // --- Create static quad index buffer --- //
+    share->quad_index_buffer = create_quad_index_buffer();
+    if (!share->quad_index_buffer) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create index buffers\n");
+        glDeleteProgram(share->shader_program);
+        glDeleteProgram(share->rect_program);
+        free(share);
+        return NULL;
+    }
+
+    // --- Create Default Texture (1x1 White Pixel) --- //
+    uint32_t white_pixel = 0xFFFFFFFF; // ABGR format (fully opaque white)
+    glGenTextures(1, &share->default_texture);
+    glBindTexture(GL_TEXTURE_2D, share->default_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // Use GL_BGRA because our white_pixel is ABGR and OpenGL on Windows often expects BGRA upload order
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_BGRA, GL_UNSIGNED_BYTE, &white_pixel);
+    glBindTexture(GL_TEXTURE_2D, 0); // Unbind
+
+    return share;
 }
 
-void pal_renderer_render_textured_quad(PAL_Renderer* renderer, PAL_TextureHandle texture, 
-                                     float x, float y, float w, float h, 
-                                     float u0, float v0, float u1, float v1, 
-                                     Color color) {
-    if (!renderer) return;
+// Drops a renderer's reference; the last one deletes the objects.
+// A context of the group must be current.
+static void share_group_release(PAL_ShareGroup* share) {
+    if (!share || --share->ref_count > 0) return;
+
+    glDeleteProgram(share->shader_program);
+    glDeleteProgram(share->rect_program);
+    glDeleteBuffers(1, &share->quad_index_buffer);
+    glDeleteTextures(1, &share->default_texture);
+    texture_registry_destroy_all(&share->textures);
+    free(share);
+}
+
+// Shared GL setup once a context is current and GL functions are loaded.
+// share is the group to join, or NULL to start a new one.
+// On failure everything, including the context, is released.
+static PAL_Renderer* renderer_init(PAL_Renderer* renderer, const PAL_RendererConfig* config, PAL_PresentMode present_mode,
+                                   PAL_ShareGroup* share) {
+    printf("OpenGL Version: %s\n", glGetString(GL_VERSION));
+    printf("GLSL Version: %s\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
+    printf("Renderer: %s\n", glGetString(GL_RENDERER));
 
-    // Pack RGBA struct into ABGR uint32_t for vertex color attribute
-    uint32_t vert_color = ((uint32_t)color.a << 24) |
-                          ((uint32_t)color.b << 16) |
-                          ((uint32_t)color.g << 8)  |
-                          ((uint32_t)color.r);
+    renderer->vertex_format = config->vertex_format;
+    renderer->damage_tracking = config->damage_tracking;
+    renderer->use_scene_target = config->damage_tracking || renderer->headless;
+    renderer->damage.full = true; // Nothing has been drawn yet
+
+    if (config->render_thread) {
+        if (!renderer->pal_window) {
+            fprintf(stderr, "Warning: Headless renderers draw on the calling thread, ignoring render_thread\n");
+        } else if (share) {
+            fprintf(stderr, "Warning: Renderers sharing resources draw on the calling thread, ignoring render_thread\n");
+        } else if (render_thread_start(&renderer->render_thread, render_thread_run_frame, renderer)) {
+            renderer->threaded = true;
+            renderer->context_on_caller = true; // Until the first frame is handed over
+        } // Otherwise the error is printed and frames are drawn on the calling thread
+    }
 
-    PAL_Vertex vertices[6] = {
-        { x,     y,     u0, v0, vert_color },
-        { x + w, y,     u1, v0, vert_color },
-        { x,     y + h, u0, v1, vert_color },
+    size_t vertex_stride = (renderer->vertex_format == PAL_VERTEX_FORMAT_COMPACT) ? sizeof(PAL_VertexCompact) : sizeof(PAL_Vertex);
+    renderer->draw_list = &renderer->draw_lists[0];
+    if (!draw_list_init(&renderer->draw_lists[0], vertex_stride) ||
+        (renderer->threaded && !draw_list_init(&renderer->draw_lists[1], vertex_stride))) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate draw list\n");
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
 
-        { x + w, y,     u1, v0, vert_color },
-        { x + w, y + h, u1, v1, vert_color },
-        { x,     y + h, u0, v1, vert_color }
-    };
+    // Initial GL setup (viewport, clear color etc.)
+    renderer_get_target_size(renderer, &renderer->window_width, &renderer->window_height);
+    renderer->frame.width = renderer->window_width;
+    renderer->frame.height = renderer->window_height;
+    glViewport(0, 0, renderer->window_width, renderer->window_height);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // Default clear color
+
+    // Swap interval and frame pacing for the window's present mode
+    apply_present_mode(renderer, present_mode);
+    gpu_timer_init(&renderer->gpu_timer);
+    capture_queue_init(&renderer->capture);
+
+    // Programs, static buffers and textures
+    if (share) {
+        share->ref_count++;
+    } else {
+        share = share_group_create(config);
+        if (!share) {
+            pal_renderer_destroy(renderer);
+            return NULL;
+        }
+    }
+    renderer->share = share;
+    if (!texture_registry_attach_cache(&share->textures, &renderer->gl_state)) {
+        fprintf(stderr, "PAL Renderer Error: Share group is limited to %d renderers\n", PAL_TEXTURE_REGISTRY_MAX_CACHES);
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
+    // Evictions are decided on the UI thread, which does not hold the context
+    share->textures.defer_deletes = renderer->threaded;
+
+    // --- Create VAO and streaming VBO --- //
+    glGenVertexArrays(1, &renderer->vao);
+    if (!stream_buffer_init(&renderer->vertex_stream, PAL_STREAM_INITIAL_REGION_SIZE)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create streaming vertex buffer\n");
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    // --- Create streamed index buffer for meshes --- //
+    if (!stream_buffer_init(&renderer->index_stream, PAL_STREAM_INITIAL_INDEX_REGION_SIZE)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create index buffers\n");
+        pal_renderer_destroy(renderer); // Releases partially created objects and the context
+        return NULL;
+    }
+
+    // --- Create texture upload staging buffer --- //
+    if (!stream_buffer_init(&renderer->upload_stream, PAL_STREAM_INITIAL_UPLOAD_REGION_SIZE)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create texture upload buffer\n");
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    glBindVertexArray(renderer->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->vertex_stream.buffer);
+
+    // --- Setup Vertex Attributes --- //
+    if (renderer->vertex_format == PAL_VERTEX_FORMAT_COMPACT) {
+        // Position attribute (fixed-point int16 -> float, subpixel scale folded into the projection)
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, sizeof(PAL_VertexCompact), (void*)offsetof(PAL_VertexCompact, x));
+        glEnableVertexAttribArray(0);
+        // Texture coordinate attribute (uint16 normalized to 0.0-1.0)
+        glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PAL_VertexCompact), (void*)offsetof(PAL_VertexCompact, u));
+        glEnableVertexAttribArray(1);
+        // Color attribute (vec4 - interpreted from uint32_t ABGR)
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PAL_VertexCompact), (void*)offsetof(PAL_VertexCompact, color));
+        glEnableVertexAttribArray(2);
+    } else {
+        // Position attribute (vec2)
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PAL_Vertex), (void*)offsetof(PAL_Vertex, x));
+        glEnableVertexAttribArray(0);
+        // Texture coordinate attribute (vec2)
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(PAL_Vertex), (void*)offsetof(PAL_Vertex, u));
+        glEnableVertexAttribArray(1);
+        // Color attribute (vec4 - interpreted from uint32_t ABGR)
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PAL_Vertex), (void*)offsetof(PAL_Vertex, color)); // GL_TRUE normalizes 0-255 to 0.0-1.0
+        glEnableVertexAttribArray(2);
+    }
+
+    // Unbind VBO and VAO (good practice)
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    // No per-vertex data: corners come from gl_VertexID, everything else is per instance
+    glGenVertexArrays(1, &renderer->rect_vao);
+    glBindVertexArray(renderer->rect_vao);
+    for (GLuint attrib = 0; attrib <= 5; ++attrib) {
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribDivisor(attrib, 1);
+    }
+    point_rect_attributes(renderer, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    // --- Set Initial GL State --- //
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glActiveTexture(GL_TEXTURE0); // Only texture unit 0 is ever used
+
+    // From here on, bindings are changed through the state cache only
+    gl_state_invalidate(&renderer->gl_state);
+    renderer->projection_dirty = true;
+    renderer->rect_projection_dirty = true;
+
+    printf("PAL Renderer Initialized Successfully.\n");
+    return renderer;
+}
+
+PAL_Renderer* pal_renderer_create_with_config(PAL_Window* window, const PAL_RendererConfig* config) {
+    PAL_RendererConfig default_config = { PAL_VERTEX_FORMAT_STANDARD, 0, false, false, NULL };
+    if (!config) config = &default_config;
+
+    if (!window || !window->sdl_window) {
+        fprintf(stderr, "PAL Renderer Error: Invalid PAL_Window provided.\n");
+        return NULL;
+    }
+
+    // Create OpenGL context using SDL
+    window->gl_context = SDL_GL_CreateContext(window->sdl_window);
+    if (!window->gl_context) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create SDL GL context: %s\n", SDL_GetError());
+        return NULL;
+    }
+
+    // Initialize GLAD
+    if (!gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to initialize GLAD\n");
+        SDL_GL_DeleteContext(window->gl_context);
+        window->gl_context = NULL;
+        return NULL;
+    }
+
+    // Allocate renderer structure
+    PAL_Renderer* renderer = (PAL_Renderer*)calloc(1, sizeof(PAL_Renderer)); // Use calloc for zero-init
+    if (!renderer) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate PAL_Renderer structure\n");
+        SDL_GL_DeleteContext(window->gl_context);
+        window->gl_context = NULL;
+        return NULL;
+    }
+
+    renderer->pal_window = window;
+    renderer->gl_context = window->gl_context;
+    SDL_GL_MakeCurrent(window->sdl_window, renderer->gl_context);
+
+    renderer = renderer_init(renderer, config, window->present_mode, NULL);
+    if (!renderer) window->gl_context = NULL; // Deleted with the renderer
+    return renderer;
+}
+
+PAL_Renderer* pal_renderer_create_shared(PAL_Renderer* share_with, PAL_Window* window, const PAL_RendererConfig* config) {
+    PAL_RendererConfig default_config = { PAL_VERTEX_FORMAT_STANDARD, 0, false, false, NULL };
+    if (!config) config = &default_config;
+
+    if (!share_with || !window || !window->sdl_window) {
+        fprintf(stderr, "PAL Renderer Error: Invalid renderer or PAL_Window provided.\n");
+        return NULL;
+    }
+    if (!share_with->gl_context) {
+        // EGL and SDL contexts cannot share objects
+        fprintf(stderr, "PAL Renderer Error: Headless renderers cannot share resources\n");
+        return NULL;
+    }
+    if (share_with->threaded) {
+        // Its context moves between threads and cannot be borrowed here
+        fprintf(stderr, "PAL Renderer Error: Renderers with a render thread cannot share resources\n");
+        return NULL;
+    }
+
+    // The new context shares object names with the one current at creation.
+    // GL functions are already loaded: the contexts come from the same driver.
+    renderer_make_current(share_with);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    window->gl_context = SDL_GL_CreateContext(window->sdl_window);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+    if (!window->gl_context) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create shared SDL GL context: %s\n", SDL_GetError());
+        return NULL;
+    }
+
+    PAL_Renderer* renderer = (PAL_Renderer*)calloc(1, sizeof(PAL_Renderer));
+    if (!renderer) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate PAL_Renderer structure\n");
+        SDL_GL_DeleteContext(window->gl_context);
+        window->gl_context = NULL;
+        return NULL;
+    }
+
+    renderer->pal_window = window;
+    renderer->gl_context = window->gl_context;
+    SDL_GL_MakeCurrent(window->sdl_window, renderer->gl_context);
+
+    renderer = renderer_init(renderer, config, window->present_mode, share_with->share);
+    if (!renderer) window->gl_context = NULL; // Deleted with the renderer
+    return renderer;
+}
+
+PAL_Renderer* pal_renderer_create_headless(int width, int height, const PAL_RendererConfig* config) {
+#ifdef PAL_HAS_HEADLESS
+    PAL_RendererConfig default_config = { PAL_VERTEX_FORMAT_STANDARD, 0, false, false, NULL };
+    if (!config) config = &default_config;
+
+    if (width <= 0 || height <= 0) {
+        fprintf(stderr, "PAL Renderer Error: Invalid headless size %dx%d\n", width, height);
+        return NULL;
+    }
+
+    PAL_HeadlessContext* headless = headless_context_create();
+    if (!headless) return NULL; // Error already printed
+
+    if (!gladLoadGLLoader((GLADloadproc)headless_context_get_proc_address)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to initialize GLAD\n");
+        headless_context_destroy(headless);
+        return NULL;
+    }
+
+    PAL_Renderer* renderer = (PAL_Renderer*)calloc(1, sizeof(PAL_Renderer));
+    if (!renderer) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate PAL_Renderer structure\n");
+        headless_context_destroy(headless);
+        return NULL;
+    }
+
+    renderer->headless = headless;
+    renderer->window_width = width; // Target size; there is no window to query
+    renderer->window_height = height;
+
+    renderer = renderer_init(renderer, config, PAL_PRESENT_MODE_IMMEDIATE, NULL);
+    if (!renderer) return NULL;
+
+    // There is no default framebuffer to fall back to, so allocate the target now
+    if (!scene_target_resize(renderer, width, height)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create %dx%d offscreen target\n", width, height);
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, renderer->scene_fbo);
+    return renderer;
+#else
+    (void)width;
+    (void)height;
+    (void)config;
+    fprintf(stderr, "PAL Renderer Error: Headless rendering not built in (enable UI_FRAMEWORK_HEADLESS)\n");
+    return NULL;
+#endif
+}
+
+void pal_renderer_destroy(PAL_Renderer* renderer) {
+    if (!renderer) return;
+
+    if (renderer->threaded) {
+        // Lets the frame in flight finish; the context is free afterwards
+        render_thread_stop(&renderer->render_thread);
+        renderer->threaded = false;
+    }
+
+    // Vertex arrays and framebuffers only exist in this renderer's context
+    if (renderer->gl_context || renderer->headless) renderer_make_current(renderer);
+
+    // Delete OpenGL objects
+    glDeleteVertexArrays(1, &renderer->vao);
+    glDeleteVertexArrays(1, &renderer->rect_vao);
+    stream_buffer_destroy(&renderer->vertex_stream);
+    stream_buffer_destroy(&renderer->index_stream);
+    stream_buffer_destroy(&renderer->upload_stream);
+    glDeleteFramebuffers(1, &renderer->scene_fbo);
+    glDeleteTextures(1, &renderer->scene_texture);
+    glDeleteFramebuffers(1, &renderer->layer_fbo);
+    if (renderer->share) {
+        texture_registry_detach_cache(&renderer->share->textures, &renderer->gl_state);
+        share_group_release(renderer->share);
+    }
+    gpu_timer_destroy(&renderer->gpu_timer);
+    capture_queue_destroy(&renderer->capture); // Delivers captures still in flight
+
+    draw_list_free(&renderer->draw_lists[0]);
+    draw_list_free(&renderer->draw_lists[1]);
+
+    renderer_destroy_context(renderer);
+
+    free(renderer);
+}
+
+// --- Frame Operations --- //
+// A frame is recorded on the calling thread (begin_frame, submissions,
+// end_frame) and drawn by frame_begin_gl/frame_end_gl, which run wherever
+// the context is: right away on the calling thread, or, with a render
+// thread, there once end_frame hands the frame over.
+
+static void draw_list_execute(PAL_Renderer* renderer, PAL_DrawList* list);
+
+// Sets up the GL side for a frame: target size, framebuffer and clear
+static void frame_begin_gl(PAL_Renderer* renderer, const PAL_FrameState* frame) {
+    renderer_lock(renderer);
+    capture_queue_poll(&renderer->capture, false);
+    renderer_unlock(renderer);
+
+    // Projection only needs recomputing when the window size changes
+    if (frame->width != renderer->window_width || frame->height != renderer->window_height) {
+        renderer->window_width = frame->width;
+        renderer->window_height = frame->height;
+        glViewport(0, 0, frame->width, frame->height);
+        renderer->projection_dirty = true;
+        renderer->rect_projection_dirty = true;
+
+        if (renderer->damage_tracking && !scene_target_resize(renderer, frame->width, frame->height)) {
+            fprintf(stderr, "PAL Renderer Error: Failed to create scene target, disabling damage tracking\n");
+            renderer_lock(renderer);
+            renderer->damage_tracking = false;
+            renderer_unlock(renderer);
+            renderer->use_scene_target = false;
+        }
+    }
+
+    if (renderer->share->ref_count > 1) {
+        // Uniform values live in the shared programs, where another renderer
+        // may have left its own projection
+        renderer->projection_dirty = true;
+        renderer->rect_projection_dirty = true;
+    }
+
+    if (renderer->use_scene_target) {
+        glBindFramebuffer(GL_FRAMEBUFFER, renderer->scene_fbo);
+    }
+    renderer_lock(renderer);
+    gpu_timer_collect(&renderer->gpu_timer);
+    renderer_unlock(renderer);
+    gpu_timer_begin_frame(&renderer->gpu_timer, frame->frame_index);
+
+    float r = frame->clear_color.r / 255.0f;
+    float g = frame->clear_color.g / 255.0f;
+    float b = frame->clear_color.b / 255.0f;
+    float a = frame->clear_color.a / 255.0f; // Use alpha too
+    glClearColor(r, g, b, a);
+    // Clear only the damaged area, never a scissor left over from the last flush
+    renderer->frame_clip = frame->clip;
+    const PAL_ScissorState* clip = &renderer->frame_clip;
+    gl_state_set_scissor(&renderer->gl_state, clip->enabled, clip->x, clip->y, clip->width, clip->height);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (!renderer->threaded) {
+        // Nothing is referenced by the new frame yet, so any purgeable texture may go
+        // (end_frame does this with a render thread)
+        texture_registry_enforce_budget(&renderer->share->textures, renderer->share->frame_serial);
+    }
+    stream_buffer_begin_frame(&renderer->vertex_stream);
+    stream_buffer_begin_frame(&renderer->index_stream);
+    stream_buffer_begin_frame(&renderer->upload_stream);
+}
+
+// Draws a recorded frame and presents it
+static void frame_end_gl(PAL_Renderer* renderer, const PAL_FrameState* frame, PAL_DrawList* list) {
+    if (frame->skipped) {
+        // Nothing changed: drop anything recorded and leave the window alone,
+        // unless the system needs the contents presented again
+        draw_list_reset(list);
+        // Layers are still drawn in skipped frames, through the current
+        // regions; their writes need a fence like any frame's
+        stream_buffer_fence_writes(&renderer->vertex_stream);
+        stream_buffer_fence_writes(&renderer->index_stream);
+        stream_buffer_fence_writes(&renderer->upload_stream);
+        renderer_lock(renderer);
+        capture_queue_poll(&renderer->capture, false);
+        renderer_unlock(renderer);
+        if (frame->present) {
+            present_scene(renderer);
+            SDL_GL_SwapWindow(renderer->pal_window->sdl_window);
+            renderer_lock(renderer);
+            frame_pacer_presented(&renderer->pacer);
+            renderer_unlock(renderer);
+        }
+        return;
+    }
+
+    draw_list_execute(renderer, list);
+    stream_buffer_end_frame(&renderer->vertex_stream);
+    stream_buffer_end_frame(&renderer->index_stream);
+    stream_buffer_end_frame(&renderer->upload_stream);
+    if (renderer->use_scene_target && renderer->pal_window) {
+        present_scene(renderer);
+    }
+    gpu_timer_end_frame(&renderer->gpu_timer);
+    renderer_lock(renderer);
+    capture_queue_read_frame(&renderer->capture, renderer->use_scene_target ? renderer->scene_fbo : 0,
+                             renderer->window_width, renderer->window_height, frame->frame_index);
+    renderer_unlock(renderer);
+
+    // Headless renderers have nothing to swap: the frame stays in the scene
+    // target for pal_renderer_read_pixels
+    if (renderer->pal_window) {
+        if (renderer->pacer.mode == PAL_PRESENT_MODE_FRAME_PACED) {
+            // Finish before swapping to measure the real frame cost, and after it so
+            // nothing queues: the swap returns at the vertical blank the pacer aims for
+            glFinish();
+            frame_pacer_work_done(&renderer->pacer);
+            SDL_GL_SwapWindow(renderer->pal_window->sdl_window);
+            glFinish();
+        } else {
+            SDL_GL_SwapWindow(renderer->pal_window->sdl_window);
+        }
+    }
+
+    // Publish this frame's counters and start fresh
+    renderer_lock(renderer);
+    frame_pacer_presented(&renderer->pacer);
+    renderer->frame_stats.state_changes = renderer->gl_state.changes;
+    renderer->frame_stats.state_changes_skipped = renderer->gl_state.skipped;
+    renderer->last_frame_stats = renderer->frame_stats;
+    renderer_unlock(renderer);
+    memset(&renderer->frame_stats, 0, sizeof(renderer->frame_stats));
+    gl_state_reset_counters(&renderer->gl_state);
+}
+
+// Render thread job: draws the frame end_frame handed over
+static void render_thread_run_frame(void* user_data) {
+    PAL_Renderer* renderer = (PAL_Renderer*)user_data;
+    SDL_GL_MakeCurrent(renderer->pal_window->sdl_window, renderer->gl_context);
+    // Evicted while the UI thread recorded; the frame no longer uses them
+    texture_registry_delete_pending(&renderer->share->textures);
+
+    renderer_lock(renderer);
+    if (renderer->job_frame.skipped) frame_pacer_frame_skipped(&renderer->pacer);
+    else frame_pacer_frame_started(&renderer->pacer);
+    renderer_unlock(renderer);
+
+    if (renderer->job_begin) frame_begin_gl(renderer, &renderer->job_frame);
+    frame_end_gl(renderer, &renderer->job_frame, renderer->job_list);
+
+    // Free for the UI thread to take between frames
+    SDL_GL_MakeCurrent(renderer->pal_window->sdl_window, NULL);
+}
+
+bool pal_renderer_begin_frame(PAL_Renderer* renderer, Color clear_color) {
+    if (!renderer) return false;
+    PAL_FrameState* frame = &renderer->frame;
+
+    int width, height;
+    renderer_get_target_size(renderer, &width, &height);
+    bool resized = width != frame->width || height != frame->height;
+    frame->width = width;
+    frame->height = height;
+    frame->clear_color = clear_color;
+    frame->clip.enabled = false;
+    frame->skipped = false;
+    frame->present = false;
+
+    if (!renderer->threaded) {
+        renderer_make_current(renderer);
+        frame_pacer_frame_started(&renderer->pacer);
+    }
+
+    renderer_lock(renderer);
+    bool damage_tracking = renderer->damage_tracking; // Cleared by the GL side if the scene target fails
+    renderer_unlock(renderer);
+    if (damage_tracking) {
+        if (resized) renderer->damage.full = true; // The scene target is reallocated
+        if (renderer->pal_window && renderer->pal_window->exposed) {
+            renderer->pal_window->exposed = false;
+            renderer->present_pending = true;
+        }
+        if (!damage_region_take(&renderer->damage, width, height, &frame->clip)) {
+            frame->skipped = true;
+            frame->present = renderer->present_pending && renderer->pal_window;
+            if (!renderer->threaded) frame_pacer_frame_skipped(&renderer->pacer);
+            return false;
+        }
+    }
+
+    renderer->frame_index++;
+    renderer->share->frame_serial++;
+    frame->frame_index = renderer->frame_index;
+    // Start an empty draw list and reset scissor for the frame
+    draw_list_reset(renderer->draw_list);
+    pal_renderer_reset_scissor(renderer);
+
+    if (renderer->threaded) {
+        // Set up with the frame on the render thread, or as soon as
+        // something needs the context before that
+        renderer->frame_begin_pending = true;
+    } else {
+        frame_begin_gl(renderer, frame);
+    }
+    return true;
+}
+
+void pal_renderer_end_frame(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    pal_renderer_end_layer(renderer); // In case one was left open
+
+    PAL_FrameState* frame = &renderer->frame;
+    if (!frame->skipped || frame->present) renderer->present_pending = false;
+
+    if (!renderer->threaded) {
+        frame_end_gl(renderer, frame, renderer->draw_list);
+        frame->skipped = false;
+        return;
+    }
+
+    // Hand the frame over and record the next one into the other list
+    render_thread_wait_idle(&renderer->render_thread);
+    if (renderer->context_on_caller) {
+        SDL_GL_MakeCurrent(renderer->pal_window->sdl_window, NULL);
+        renderer->context_on_caller = false;
+    }
+    // Nothing is referenced by the next frame yet, so any purgeable texture may go
+    texture_registry_enforce_budget(&renderer->share->textures, renderer->share->frame_serial);
+
+    renderer->job_frame = *frame;
+    renderer->job_list = renderer->draw_list;
+    renderer->job_begin = renderer->frame_begin_pending;
+    renderer->frame_begin_pending = false;
+    renderer->draw_list = (renderer->draw_list == &renderer->draw_lists[0]) ? &renderer->draw_lists[1] : &renderer->draw_lists[0];
+    frame->skipped = false;
+    render_thread_submit(&renderer->render_thread);
+}
+
+void pal_renderer_wait_for_frame(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    frame_pacer_wait(&renderer->pacer);
+}
+
+void pal_renderer_set_present_mode(PAL_Renderer* renderer, PAL_PresentMode mode) {
+    if (!renderer) return;
+    renderer_make_current(renderer);
+    apply_present_mode(renderer, mode);
+}
+
+PAL_PresentMode pal_renderer_get_present_mode(const PAL_Renderer* renderer) {
+    if (!renderer) return PAL_PRESENT_MODE_VSYNC;
+    return renderer->pacer.mode;
+}
+
+void pal_renderer_get_frame_timing(const PAL_Renderer* renderer, PAL_FrameTiming* timing) {
+    if (!timing) return;
+    if (!renderer) {
+        memset(timing, 0, sizeof(*timing));
+        return;
+    }
+    renderer_lock(renderer);
+    frame_pacer_get_timing(&renderer->pacer, timing);
+    renderer_unlock(renderer);
+}
+
+void pal_renderer_begin_gpu_pass(PAL_Renderer* renderer, const char* label) {
+    if (!renderer || !renderer->gpu_timer.supported) return;
+    pal_renderer_flush(renderer); // Earlier draws belong to the enclosing pass
+    renderer_acquire(renderer);
+    gpu_timer_begin_pass(&renderer->gpu_timer, label);
+}
+
+void pal_renderer_end_gpu_pass(PAL_Renderer* renderer) {
+    if (!renderer || !renderer->gpu_timer.supported) return;
+    pal_renderer_flush(renderer);
+    renderer_acquire(renderer);
+    gpu_timer_end_pass(&renderer->gpu_timer);
+}
+
+void pal_renderer_get_gpu_timing(const PAL_Renderer* renderer, PAL_GpuTiming* timing) {
+    if (!timing) return;
+    if (!renderer) {
+        memset(timing, 0, sizeof(*timing));
+        return;
+    }
+    renderer_lock(renderer);
+    *timing = renderer->gpu_timer.latest;
+    renderer_unlock(renderer);
+}
+
+void pal_renderer_add_damage(PAL_Renderer* renderer, int x, int y, int width, int height) {
+    if (!renderer || width <= 0 || height <= 0) return;
+    damage_region_add(&renderer->damage, x, y, x + width, y + height);
+}
+
+void pal_renderer_damage_all(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    renderer->damage.full = true;
+}
+
+bool pal_renderer_has_damage(const PAL_Renderer* renderer) {
+    if (!renderer) return false;
+    renderer_lock(renderer);
+    bool damage_tracking = renderer->damage_tracking;
+    renderer_unlock(renderer);
+    if (!damage_tracking) return true; // Every frame is a full redraw
+    const PAL_DamageRegion* damage = &renderer->damage;
+    return damage->full || (damage->x0 < damage->x1 && damage->y0 < damage->y1) ||
+           renderer->present_pending || (renderer->pal_window && renderer->pal_window->exposed);
+}
+
+bool pal_renderer_read_pixels(PAL_Renderer* renderer, int x, int y, int width, int height,
+                              void* pixels, int stride_bytes) {
+    if (!renderer || !pixels || width <= 0 || height <= 0) return false;
+    if (stride_bytes < 0 || (stride_bytes % 4) != 0 || (stride_bytes && stride_bytes < width * 4)) {
+        fprintf(stderr, "PAL Renderer Error: Invalid read stride %d for width %d\n", stride_bytes, width);
+        return false;
+    }
+
+    // Everything recorded so far must be in the framebuffer. With a render
+    // thread this also waits for the last frame handed to it.
+    renderer_make_current(renderer);
+    if (x < 0 || y < 0 || x + width > renderer->window_width || y + height > renderer->window_height) {
+        fprintf(stderr, "PAL Renderer Error: Read area %d,%d %dx%d outside %dx%d target\n",
+                x, y, width, height, renderer->window_width, renderer->window_height);
+        return false;
+    }
+    pal_renderer_flush(renderer);
+
+    // The scene target keeps its contents after end_frame; the back buffer
+    // only holds the frame until it is swapped
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->use_scene_target ? renderer->scene_fbo : 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glPixelStorei(GL_PACK_ROW_LENGTH, stride_bytes / 4);
+    glReadPixels(x, renderer->window_height - y - height, width, height, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+    // GL rows run bottom-up; flip them so row 0 is the top edge
+    size_t row_size = (size_t)width * 4;
+    size_t stride = stride_bytes ? (size_t)stride_bytes : row_size;
+    unsigned char* row_copy = (unsigned char*)malloc(row_size);
+    if (!row_copy) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate readback row\n");
+        return false;
+    }
+    unsigned char* top = (unsigned char*)pixels;
+    unsigned char* bottom = top + stride * (size_t)(height - 1);
+    while (top < bottom) {
+        memcpy(row_copy, top, row_size);
+        memcpy(top, bottom, row_size);
+        memcpy(bottom, row_copy, row_size);
+        top += stride;
+        bottom -= stride;
+    }
+    free(row_copy);
+    return true;
+}
+
+bool pal_renderer_request_capture(PAL_Renderer* renderer, PAL_CaptureCallback callback, void* user_data) {
+    if (!renderer || !callback) return false;
+    renderer_lock(renderer);
+    bool accepted = !renderer->capture.request;
+    if (accepted) {
+        renderer->capture.request = callback;
+        renderer->capture.request_user_data = user_data;
+    }
+    renderer_unlock(renderer);
+    return accepted;
+}
+
+bool pal_renderer_start_capture_stream(PAL_Renderer* renderer, const char* path, PAL_CaptureFormat format) {
+    if (!renderer || !path) return false;
+    pal_renderer_stop_capture_stream(renderer);
+    renderer_make_current(renderer); // Keeps the render thread out of the queue
+
+    renderer->capture.stream = capture_stream_open(path, format);
+    if (!renderer->capture.stream) return false;
+    renderer->capture.stats.streaming = true;
+    renderer->capture.stats.stream_bytes = 0;
+    return true;
+}
+
+void pal_renderer_stop_capture_stream(PAL_Renderer* renderer) {
+    if (!renderer || !renderer->capture.stream) return;
+    // Frames already being copied still belong in the file
+    renderer_make_current(renderer);
+    capture_queue_poll(&renderer->capture, true);
+    renderer->capture.stats.stream_bytes = capture_stream_close(renderer->capture.stream);
+    renderer->capture.stream = NULL;
+    renderer->capture.stats.streaming = false;
+}
+
+void pal_renderer_get_capture_stats(const PAL_Renderer* renderer, PAL_CaptureStats* stats) {
+    if (!stats) return;
+    if (!renderer) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    renderer_lock(renderer);
+    *stats = renderer->capture.stats;
+    renderer_unlock(renderer);
+}
+
+void pal_renderer_get_stats(const PAL_Renderer* renderer, PAL_RendererStats* stats) {
+    if (!stats) return;
+    if (!renderer) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    renderer_lock(renderer);
+    *stats = renderer->last_frame_stats;
+    renderer_unlock(renderer);
+}
+
+void pal_renderer_flush(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    PAL_DrawList* list = renderer->draw_list;
+    if (list->command_count == 0 || (renderer->frame.skipped && !renderer->layer)) {
+        draw_list_reset(list);
+        return;
+    }
+    renderer_acquire(renderer);
+    draw_list_execute(renderer, list);
+}
+
+// Issues a recorded list's draw calls and empties it
+static void draw_list_execute(PAL_Renderer* renderer, PAL_DrawList* list) {
+    if (list->command_count == 0) {
+        draw_list_reset(list);
+        return;
+    }
+
+    PAL_GLStateCache* gl = &renderer->gl_state;
+    // Damage only limits drawing to the frame; layers are redrawn whole
+    PAL_ScissorState no_clip = { false, 0, 0, 0, 0 };
+    const PAL_ScissorState* clip = renderer->layer ? &no_clip : &renderer->frame_clip;
+
+    // Rect instances share the vertex stream, and nothing is drawn until both
+    // blocks are written; room for both (plus alignment) is made up front
+    size_t vertex_bytes = list->vertex_count * list->vertex_stride;
+    size_t rect_bytes = list->rect_count * sizeof(PAL_RectInstance);
+    if (vertex_bytes > 0 && rect_bytes > 0) {
+        stream_buffer_reserve(&renderer->vertex_stream,
+                              vertex_bytes + list->vertex_stride + rect_bytes + sizeof(PAL_RectInstance));
+    }
+
+    // Write the whole frame's vertices into the streaming buffer at once
+    GLint base_vertex = 0;
+    if (list->vertex_count > 0) {
+        size_t byte_offset = stream_buffer_write(&renderer->vertex_stream, list->vertices,
+                                                 vertex_bytes, list->vertex_stride);
+        base_vertex = (GLint)(byte_offset / list->vertex_stride);
+    }
+
+    // Same for mesh indices, if any indexed geometry was submitted
+    size_t index_byte_offset = 0;
+    if (list->index_count > 0) {
+        index_byte_offset = stream_buffer_write(&renderer->index_stream, list->indices,
+                                                list->index_count * sizeof(uint32_t), sizeof(uint32_t));
+    }
+
+    size_t rect_byte_offset = 0;
+    if (list->rect_count > 0) {
+        rect_byte_offset = stream_buffer_write(&renderer->vertex_stream, list->rects,
+                                               rect_bytes, sizeof(PAL_RectInstance));
+    }
+
+    // Replay commands; the state cache drops binds that match the previous command
+    for (size_t i = 0; i < list->command_count; ++i) {
+        const PAL_DrawCommand* cmd = &list->commands[i];
+        if (cmd->vertex_count == 0 && cmd->rect_count == 0) continue;
+
+        if (!apply_scissor_state(gl, &cmd->scissor, clip)) continue; // Outside the damage
+
+        if (cmd->mode == PAL_DRAW_MODE_RECTS) {
+            gl_state_use_program(gl, renderer->share->rect_program);
+            gl_state_bind_vertex_array(gl, renderer->rect_vao);
+            if (renderer->rect_projection_dirty) {
+                upload_projection(renderer, renderer->share->rect_proj_matrix_location, 1.0f);
+                renderer->rect_projection_dirty = false;
+            }
+            // No base-instance in GL 3.3: re-point the instance attributes per command
+            point_rect_attributes(renderer, rect_byte_offset + cmd->rect_offset * sizeof(PAL_RectInstance));
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)cmd->rect_count);
+            renderer->frame_stats.draw_calls++;
+            renderer->frame_stats.rect_instances += (uint32_t)cmd->rect_count;
+            continue;
+        }
+
+        gl_state_use_program(gl, renderer->share->shader_program);
+        gl_state_bind_vertex_array(gl, renderer->vao);
+        if (renderer->projection_dirty) {
+            // Compact vertices carry fixed-point positions; scale them back to pixels here
+            float scale = (renderer->vertex_format == PAL_VERTEX_FORMAT_COMPACT) ? 1.0f / (float)(1 << PAL_COMPACT_VERTEX_SUBPIXEL_BITS) : 1.0f;
+            upload_projection(renderer, renderer->share->proj_matrix_location, scale);
+            renderer->projection_dirty = false;
+        }
+        gl_state_bind_texture(gl, cmd->texture);
+
+        GLint first_vertex = base_vertex + (GLint)cmd->vertex_offset;
+        switch (cmd->mode) {
+            case PAL_DRAW_MODE_TRIANGLES:
+                glDrawArrays(GL_TRIANGLES, first_vertex, (GLsizei)cmd->vertex_count);
+                break;
+            case PAL_DRAW_MODE_QUADS:
+                gl_state_bind_element_buffer(gl, renderer->share->quad_index_buffer);
+                glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(cmd->vertex_count / 4 * 6), GL_UNSIGNED_SHORT,
+                                         NULL, first_vertex);
+                renderer->frame_stats.indices += (uint32_t)(cmd->vertex_count / 4 * 6);
+                break;
+            case PAL_DRAW_MODE_INDEXED:
+                gl_state_bind_element_buffer(gl, renderer->index_stream.buffer);
+                glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)cmd->index_count, GL_UNSIGNED_INT,
+                                         (void*)(index_byte_offset + cmd->index_offset * sizeof(uint32_t)),
+                                         first_vertex);
+                renderer->frame_stats.indices += (uint32_t)cmd->index_count;
+                break;
+            case PAL_DRAW_MODE_RECTS:
+                break; // Handled above
+        }
+        renderer->frame_stats.draw_calls++;
+        renderer->frame_stats.vertices += (uint32_t)cmd->vertex_count;
+    }
+
+    // Bindings are left in place for the next flush; the state cache knows about them
+    draw_list_reset(list);
+}
+
+// --- Texture Management --- //
+PAL_TextureHandle pal_renderer_create_texture(PAL_Renderer* renderer, int width, int height, const void* data) {
+    if (!renderer || width <= 0 || height <= 0) return NULL;
+    // Binds through this renderer's state cache, so its context must be the current one
+    renderer_make_current(renderer);
+
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    gl_state_bind_texture(&renderer->gl_state, texture_id);
+
+    // Setup texture parameters (common settings)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Upload texture data (assuming 32-bit RGBA input, uploaded as BGRA)
+    // Note: The format GL_BGRA is common for SDL surfaces / typical image loading on Windows.
+    // If your input 'data' is RGBA, use GL_RGBA here.
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, data);
+
+    PAL_GLTexture* texture = texture_registry_add(&renderer->share->textures, texture_id, width, height, GL_RGBA8, 4);
+    if (!texture) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory registering %dx%d texture\n", width, height);
+        glDeleteTextures(1, &texture_id);
+        gl_state_forget_texture(&renderer->gl_state, texture_id);
+        return NULL;
+    }
+    texture_registry_touch(&renderer->share->textures, texture, renderer->share->frame_serial);
+
+    // A new texture may push resident memory over budget
+    texture_registry_enforce_budget(&renderer->share->textures, renderer->share->frame_serial);
+    return (PAL_TextureHandle)texture;
+}
+
+void pal_renderer_update_texture(PAL_Renderer* renderer, PAL_TextureHandle texture, int width, int height, const void* data) {
+    if (!renderer || !texture || !data || width <= 0 || height <= 0) return;
+
+    // Pending commands may still sample the old contents
+    pal_renderer_flush(renderer);
+    pal_renderer_update_texture_region(renderer, texture, 0, 0, width, height, data, 0);
+}
+
+void pal_renderer_update_texture_region(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                                        int x, int y, int width, int height,
+                                        const void* data, int stride_bytes) {
+    if (!renderer || !texture || !data || x < 0 || y < 0 || width <= 0 || height <= 0) return;
+    if (stride_bytes < 0 || stride_bytes % 4 != 0) {
+        fprintf(stderr, "PAL Renderer Error: Texture region stride %d is not a multiple of 4\n", stride_bytes);
+        return;
+    }
+
+    renderer_make_current(renderer);
+    PAL_GLTexture* gl_texture = (PAL_GLTexture*)texture;
+    if (x + width > gl_texture->width || y + height > gl_texture->height) {
+        fprintf(stderr, "PAL Renderer Error: Texture region %d,%d %dx%d exceeds %dx%d texture\n",
+                x, y, width, height, gl_texture->width, gl_texture->height);
+        return;
+    }
+
+    // Stage the pixels in this frame's region of the upload ring. The copy
+    // happens now, so the caller may reuse data on return, and the texture
+    // upload itself is a GPU-side transfer that never stalls the CPU.
+    size_t row_size = (size_t)width * 4;
+    size_t src_stride = stride_bytes ? (size_t)stride_bytes : row_size;
+    size_t offset = stream_buffer_write_rows(&renderer->upload_stream, data, row_size,
+                                             (size_t)height, src_stride, 4);
+
+    // Writing to an evicted texture makes it resident again
+    if (!gl_texture->id) {
+        if (!texture_registry_restore(&renderer->share->textures, &renderer->gl_state, gl_texture)) {
+            fprintf(stderr, "PAL Renderer Error: Failed to restore evicted texture\n");
+            return;
+        }
+        texture_registry_touch(&renderer->share->textures, gl_texture, renderer->share->frame_serial);
+        texture_registry_enforce_budget(&renderer->share->textures, renderer->share->frame_serial);
+    }
+    gl_state_bind_texture(&renderer->gl_state, gl_texture->id);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, renderer->upload_stream.buffer);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_BGRA, GL_UNSIGNED_BYTE, (const void*)offset);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // Client-memory uploads (create_texture) must not see it
+    renderer->frame_stats.upload_bytes += (uint32_t)(row_size * (size_t)height);
+}
+
+// Binds the framebuffer submissions currently draw into
+static void renderer_bind_target(PAL_Renderer* renderer) {
+    if (renderer->layer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, renderer->layer_fbo);
+        glViewport(0, 0, renderer->layer->width, renderer->layer->height);
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, renderer->use_scene_target ? renderer->scene_fbo : 0);
+    glViewport(0, 0, renderer->window_width, renderer->window_height);
+}
+
+// Attaches a layer's (current) texture storage to the renderer's layer
+// framebuffer. Framebuffers are not shared between contexts, so layers keep
+// none of their own and any renderer of the group can draw into them.
+static bool layer_attach(PAL_Renderer* renderer, PAL_GLTexture* texture) {
+    if (!renderer->layer_fbo) glGenFramebuffers(1, &renderer->layer_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, renderer->layer_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->id, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    renderer_bind_target(renderer);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "PAL Renderer Error: Layer framebuffer incomplete (0x%x)\n", status);
+        return false;
+    }
+    return true;
+}
+
+PAL_TextureHandle pal_renderer_create_layer(PAL_Renderer* renderer, int width, int height) {
+    if (!renderer) return NULL;
+    renderer_make_current(renderer);
+
+    PAL_GLTexture* texture = (PAL_GLTexture*)pal_renderer_create_texture(renderer, width, height, NULL);
+    if (!texture) return NULL;
+    texture->is_layer = true;
+    // Checks the texture is renderable
+    if (!layer_attach(renderer, texture)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create %dx%d layer\n", width, height);
+        pal_renderer_destroy_texture(renderer, texture);
+        return NULL;
+    }
+    return texture;
+}
+
+bool pal_renderer_begin_layer(PAL_Renderer* renderer, PAL_TextureHandle layer, Color clear_color) {
+    if (!renderer || !layer) return false;
+    PAL_GLTexture* texture = (PAL_GLTexture*)layer;
+    if (!texture->is_layer) {
+        fprintf(stderr, "PAL Renderer Error: Texture is not a layer\n");
+        return false;
+    }
+
+    // Draws so far belong to the previous target
+    pal_renderer_flush(renderer);
+    renderer_acquire(renderer);
+    renderer->layer = NULL;
+
+    // An evicted layer gets fresh storage; its contents are redrawn anyway
+    if (!texture->id && !texture_registry_restore(&renderer->share->textures, &renderer->gl_state, texture)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to restore evicted layer\n");
+        return false;
+    }
+    if (!layer_attach(renderer, texture)) return false;
+    texture_registry_touch(&renderer->share->textures, texture, renderer->share->frame_serial);
+
+    renderer->layer = texture;
+    renderer_bind_target(renderer);
+    renderer->projection_dirty = true;
+    renderer->rect_projection_dirty = true;
+    pal_renderer_reset_scissor(renderer);
+
+    gl_state_set_scissor(&renderer->gl_state, false, 0, 0, 0, 0);
+    glClearColor(clear_color.r / 255.0f, clear_color.g / 255.0f, clear_color.b / 255.0f, clear_color.a / 255.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    return true;
+}
+
+void pal_renderer_end_layer(PAL_Renderer* renderer) {
+    if (!renderer || !renderer->layer) return;
+
+    pal_renderer_flush(renderer);
+    renderer_acquire(renderer);
+    renderer->layer = NULL;
+    renderer_bind_target(renderer);
+    renderer->projection_dirty = true;
+    renderer->rect_projection_dirty = true;
+    pal_renderer_reset_scissor(renderer);
+}
+
+void pal_renderer_destroy_texture(PAL_Renderer* renderer, PAL_TextureHandle texture) {
+    if (!renderer || !texture) return;
+    renderer_make_current(renderer);
+    if (renderer->layer == (PAL_GLTexture*)texture) pal_renderer_end_layer(renderer);
+    // Pending commands may still reference this texture
+    pal_renderer_flush(renderer);
+    texture_registry_remove(&renderer->share->textures, (PAL_GLTexture*)texture);
+}
+
+void pal_renderer_set_texture_purgeable(PAL_Renderer* renderer, PAL_TextureHandle texture, bool purgeable) {
+    if (!renderer || !texture) return;
+    renderer_make_current(renderer);
+    texture_registry_set_purgeable(&renderer->share->textures, (PAL_GLTexture*)texture, purgeable);
+    if (purgeable) texture_registry_enforce_budget(&renderer->share->textures, renderer->share->frame_serial);
+}
+
+bool pal_renderer_texture_is_resident(const PAL_Renderer* renderer, PAL_TextureHandle texture) {
+    if (!renderer || !texture) return false;
+    return ((const PAL_GLTexture*)texture)->id != 0;
+}
+
+void pal_renderer_set_texture_budget(PAL_Renderer* renderer, size_t budget_bytes) {
+    if (!renderer) return;
+    renderer_make_current(renderer);
+    renderer->share->textures.budget_bytes = budget_bytes;
+    texture_registry_enforce_budget(&renderer->share->textures, renderer->share->frame_serial);
+}
+
+void pal_renderer_get_texture_stats(const PAL_Renderer* renderer, PAL_TextureStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!renderer) return;
+
+    const PAL_TextureRegistry* registry = &renderer->share->textures;
+    stats->texture_count = registry->texture_count;
+    stats->resident_count = registry->resident_count;
+    stats->resident_bytes = registry->resident_bytes;
+    stats->budget_bytes = registry->budget_bytes;
+    stats->evictions = registry->evictions;
+    for (const PAL_GLTexture* texture = registry->head; texture; texture = texture->next) {
+        if (texture->id && texture->purgeable) stats->purgeable_bytes += texture->bytes;
+    }
+}
+
+// --- Drawing Operations --- //
+void pal_renderer_set_scissor(PAL_Renderer* renderer, int x, int y, int width, int height) {
+    if (!renderer) return;
+    // OpenGL scissor origin is bottom-left, UI coords often top-left.
+    // Need window height to convert. Applied when the draw list is flushed.
+    // Layers are drawn upside down, so their rows already match.
+    int window_h = renderer->frame.height;
+    renderer->scissor.enabled = true;
+    renderer->scissor.x = x;
+    renderer->scissor.y = renderer->layer ? y : window_h - (y + height);
+    renderer->scissor.width = width;
+    renderer->scissor.height = height;
+}
+
+void pal_renderer_reset_scissor(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    renderer->scissor.enabled = false;
+}
+
+// Resolves the GL texture a submission samples and stamps it as used this
+// frame. NULL and evicted textures draw with the white default texture.
+static GLuint texture_for_draw(PAL_Renderer* renderer, PAL_TextureHandle texture) {
+    PAL_GLTexture* gl_texture = (PAL_GLTexture*)texture;
+    if (!gl_texture || !gl_texture->id) return renderer->share->default_texture;
+    texture_registry_touch(&renderer->share->textures, gl_texture, renderer->share->frame_serial);
+    return gl_texture->id;
+}
+
+// Shared implementation of the vertex submission entry points; src holds
+// vertices in src_format and is converted to the renderer's layout if needed.
+static void submit_triangles(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                             const void* vertices, PAL_VertexFormat src_format, size_t vertex_count) {
+    if (!renderer || !vertices || vertex_count == 0 || !renderer->share->shader_program || !renderer->vao || !renderer->vertex_stream.buffer) return;
+
+    PAL_DrawList* list = renderer->draw_list;
+    if (!draw_list_reserve_vertices(list, vertex_count)) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw list (%zu vertices)\n", vertex_count);
+        return;
+    }
+
+    GLuint texture_id = texture_for_draw(renderer, texture);
+    PAL_DrawCommand* cmd = draw_list_command_for(list, PAL_DRAW_MODE_TRIANGLES, texture_id, &renderer->scissor, vertex_count);
+    if (!cmd) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw command list\n");
+        return;
+    }
+
+    draw_list_append_vertices(list, vertices, src_format, vertex_count);
+    cmd->vertex_count += vertex_count;
+}
+
+static void submit_quads(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                         const void* vertices, PAL_VertexFormat src_format, size_t quad_count) {
+    if (!renderer || !vertices || quad_count == 0 || !renderer->share->shader_program || !renderer->vao || !renderer->vertex_stream.buffer) return;
+
+    PAL_DrawList* list = renderer->draw_list;
+    size_t vertex_count = quad_count * 4;
+    if (!draw_list_reserve_vertices(list, vertex_count)) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw list (%zu vertices)\n", vertex_count);
+        return;
+    }
+
+    size_t src_stride = (src_format == PAL_VERTEX_FORMAT_COMPACT) ? sizeof(PAL_VertexCompact) : sizeof(PAL_Vertex);
+    const unsigned char* src = (const unsigned char*)vertices;
+    GLuint texture_id = texture_for_draw(renderer, texture);
+    // Split into runs that fit the static quad index pattern
+    while (quad_count > 0) {
+        size_t run = quad_count < PAL_QUAD_BATCH_MAX ? quad_count : PAL_QUAD_BATCH_MAX;
+        PAL_DrawCommand* cmd = draw_list_command_for(list, PAL_DRAW_MODE_QUADS, texture_id, &renderer->scissor, run * 4);
+        if (!cmd) {
+            fprintf(stderr, "PAL Renderer Error: Out of memory growing draw command list\n");
+            return;
+        }
+
+        draw_list_append_vertices(list, src, src_format, run * 4);
+        cmd->vertex_count += run * 4;
+        src += run * 4 * src_stride;
+        quad_count -= run;
+    }
+}
+
+static void submit_indexed(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                           const void* vertices, PAL_VertexFormat src_format, size_t vertex_count,
+                           const uint32_t* indices, size_t index_count) {
+    if (!renderer || !vertices || vertex_count == 0 || !indices || index_count == 0 ||
+        !renderer->share->shader_program || !renderer->vao || !renderer->vertex_stream.buffer) return;
+
+    PAL_DrawList* list = renderer->draw_list;
+    if (!draw_list_reserve_vertices(list, vertex_count) || !draw_list_reserve_indices(list, index_count)) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw list (%zu vertices, %zu indices)\n",
+                vertex_count, index_count);
+        return;
+    }
+
+    GLuint texture_id = texture_for_draw(renderer, texture);
+    PAL_DrawCommand* cmd = draw_list_command_for(list, PAL_DRAW_MODE_INDEXED, texture_id, &renderer->scissor, vertex_count);
+    if (!cmd) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw command list\n");
+        return;
+    }
+
+    // Indices are stored relative to the command's first vertex so merged meshes share one draw
+    uint32_t rebase = (uint32_t)(list->vertex_count - cmd->vertex_offset);
+    uint32_t* dst = list->indices + list->index_count;
+    for (size_t i = 0; i < index_count; ++i) {
+        dst[i] = indices[i] + rebase;
+    }
+    list->index_count += index_count;
+    cmd->index_count += index_count;
+
+    draw_list_append_vertices(list, vertices, src_format, vertex_count);
+    cmd->vertex_count += vertex_count;
+}
+
+void pal_renderer_render_triangles(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_Vertex* vertices, size_t vertex_count) {
+    submit_triangles(renderer, texture, vertices, PAL_VERTEX_FORMAT_STANDARD, vertex_count);
+}
+
+void pal_renderer_render_quads(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_Vertex* vertices, size_t quad_count) {
+    submit_quads(renderer, texture, vertices, PAL_VERTEX_FORMAT_STANDARD, quad_count);
+}
+
+void pal_renderer_render_indexed(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                                 const PAL_Vertex* vertices, size_t vertex_count,
+                                 const uint32_t* indices, size_t index_count) {
+    submit_indexed(renderer, texture, vertices, PAL_VERTEX_FORMAT_STANDARD, vertex_count, indices, index_count);
+}
+
+void pal_renderer_render_triangles_compact(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_VertexCompact* vertices, size_t vertex_count) {
+    submit_triangles(renderer, texture, vertices, PAL_VERTEX_FORMAT_COMPACT, vertex_count);
+}
+
+void pal_renderer_render_quads_compact(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_VertexCompact* vertices, size_t quad_count) {
+    submit_quads(renderer, texture, vertices, PAL_VERTEX_FORMAT_COMPACT, quad_count);
+}
+
+void pal_renderer_render_quad_batch(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_QuadRect* rects,
+                                    const PAL_QuadUV* uvs, const uint32_t* colors, size_t quad_count) {
+    if (!renderer || !rects || quad_count == 0 || !renderer->share->shader_program || !renderer->vao || !renderer->vertex_stream.buffer) return;
+
+    PAL_DrawList* list = renderer->draw_list;
+    if (!draw_list_reserve_vertices(list, quad_count * 4)) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw list (%zu vertices)\n", quad_count * 4);
+        return;
+    }
+
+    GLuint texture_id = texture_for_draw(renderer, texture);
+    while (quad_count > 0) {
+        size_t run = quad_count < PAL_QUAD_BATCH_MAX ? quad_count : PAL_QUAD_BATCH_MAX;
+        PAL_DrawCommand* cmd = draw_list_command_for(list, PAL_DRAW_MODE_QUADS, texture_id, &renderer->scissor, run * 4);
+        if (!cmd) {
+            fprintf(stderr, "PAL Renderer Error: Out of memory growing draw command list\n");
+            return;
+        }
+
+        // Vertices are built in place, already in the list's layout
+        unsigned char* dst = list->vertices + list->vertex_count * list->vertex_stride;
+        if (renderer->vertex_format == PAL_VERTEX_FORMAT_COMPACT) {
+            pal_quad_batch_write_quads_compact((PAL_VertexCompact*)dst, rects, uvs, colors, run);
+        } else {
+            pal_quad_batch_write_quads((PAL_Vertex*)dst, rects, uvs, colors, run);
+        }
+        list->vertex_count += run * 4;
+        cmd->vertex_count += run * 4;
+
+        rects += run;
+        if (uvs) uvs += run;
+        if (colors) colors += run;
+        quad_count -= run;
+    }
+}
+
+void pal_renderer_render_rects(PAL_Renderer* renderer, const PAL_RectInstance* rects, size_t rect_count) {
+    if (!renderer || !rects || rect_count == 0 || !renderer->share->rect_program) return;
+
+    PAL_DrawList* list = renderer->draw_list;
+    if (!draw_list_reserve_rects(list, rect_count)) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw list (%zu rects)\n", rect_count);
+        return;
+    }
+
+    // Rects are untextured; texture 0 keeps them from merging with anything but rects
+    PAL_DrawCommand* cmd = draw_list_command_for(list, PAL_DRAW_MODE_RECTS, 0, &renderer->scissor, 0);
+    if (!cmd) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory growing draw command list\n");
+        return;
+    }
+
+    memcpy(list->rects + list->rect_count, rects, rect_count * sizeof(PAL_RectInstance));
+    list->rect_count += rect_count;
+    cmd->rect_count += rect_count;
+}
+
+PAL_VertexFormat pal_renderer_get_vertex_format(const PAL_Renderer* renderer) {
+    return renderer ? renderer->vertex_format : PAL_VERTEX_FORMAT_STANDARD;
+}
+
+void pal_renderer_render_textured_quad(PAL_Renderer* renderer, PAL_TextureHandle texture, 
+                                     float x, float y, float w, float h, 
+                                     float u0, float v0, float u1, float v1, 
+                                     Color color) {
+    if (!renderer) return;
 
-    pal_renderer_render_triangles(renderer, texture, vertices, 6);
+    PAL_QuadRect rect = { x, y, w, h };
+    PAL_QuadUV uv = { u0, v0, u1, v1 };
+    uint32_t vert_color = color_to_uint32(color); // ABGR, as the vertex color attribute expects
+    pal_renderer_render_quad_batch(renderer, texture, &rect, &uv, &vert_color, 1);
 } 
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "pal_sdl_texture_registry.h"
+
+#include <stdlib.h>
+
+static void registry_unlink(PAL_TextureRegistry* registry, PAL_GLTexture* texture) {
+    if (texture->prev) texture->prev->next = texture->next;
+    else registry->head = texture->next;
+    if (texture->next) texture->next->prev = texture->prev;
+    texture->prev = texture->next = NULL;
+}
+
+static void lru_unlink(PAL_TextureRegistry* registry, PAL_GLTexture* texture) {
+    if (!texture->in_lru) return;
+    if (texture->lru_prev) texture->lru_prev->lru_next = texture->lru_next;
+    else registry->lru_head = texture->lru_next;
+    if (texture->lru_next) texture->lru_next->lru_prev = texture->lru_prev;
+    else registry->lru_tail = texture->lru_prev;
+    texture->lru_prev = texture->lru_next = NULL;
+    texture->in_lru = false;
+}
+
+// Keeps the list ordered by last_used_frame. Touched textures carry the
+// newest frame and go straight to the head; only a texture made purgeable
+// or restored with an older stamp walks further in.
+static void lru_insert(PAL_TextureRegistry* registry, PAL_GLTexture* texture) {
+    PAL_GLTexture* next = registry->lru_head;
+    while (next && next->last_used_frame > texture->last_used_frame) next = next->lru_next;
+
+    texture->lru_next = next;
+    texture->lru_prev = next ? next->lru_prev : registry->lru_tail;
+    if (texture->lru_prev) texture->lru_prev->lru_next = texture;
+    else registry->lru_head = texture;
+    if (next) next->lru_prev = texture;
+    else registry->lru_tail = texture;
+    texture->in_lru = true;
+}
+
+// Puts the texture on the LRU list exactly when it is an eviction candidate
+static void lru_update(PAL_TextureRegistry* registry, PAL_GLTexture* texture) {
+    bool candidate = texture->id && texture->purgeable;
+    if (candidate && !texture->in_lru) lru_insert(registry, texture);
+    else if (!candidate) lru_unlink(registry, texture);
+}
+
+static void registry_delete_texture(PAL_TextureRegistry* registry, GLuint id) {
+    glDeleteTextures(1, &id);
+    for (int i = 0; i < registry->cache_count; i++) {
+        gl_state_forget_texture(registry->caches[i], id);
+    }
+}
+
+// Returns false if a deferred delete could not be queued; the texture then stays resident
+static bool registry_release_storage(PAL_TextureRegistry* registry, PAL_GLTexture* texture, bool defer) {
+    if (!texture->id) return true;
+    if (defer) {
+        if (registry->pending_count == registry->pending_capacity) {
+            size_t capacity = registry->pending_capacity ? registry->pending_capacity * 2 : 16;
+            GLuint* pending = (GLuint*)realloc(registry->pending_deletes, capacity * sizeof(GLuint));
+            if (!pending) return false;
+            registry->pending_deletes = pending;
+            registry->pending_capacity = capacity;
+        }
+        registry->pending_deletes[registry->pending_count++] = texture->id;
+    } else {
+        registry_delete_texture(registry, texture->id);
+    }
+    texture->id = 0;
+    lru_unlink(registry, texture);
+    registry->resident_bytes -= texture->bytes;
+    registry->resident_count--;
+    return true;
+}
+
+bool texture_registry_attach_cache(PAL_TextureRegistry* registry, PAL_GLStateCache* cache) {
+    if (registry->cache_count == PAL_TEXTURE_REGISTRY_MAX_CACHES) return false;
+    registry->caches[registry->cache_count++] = cache;
+    return true;
+}
+
+void texture_registry_detach_cache(PAL_TextureRegistry* registry, PAL_GLStateCache* cache) {
+    for (int i = 0; i < registry->cache_count; i++) {
+        if (registry->caches[i] == cache) {
+            registry->caches[i] = registry->caches[--registry->cache_count];
+            return;
+        }
+    }
+}
+
+PAL_GLTexture* texture_registry_add(PAL_TextureRegistry* registry, GLuint id, int width, int height,
+                                    GLenum internal_format, size_t bytes_per_pixel) {
+    PAL_GLTexture* texture = (PAL_GLTexture*)calloc(1, sizeof(PAL_GLTexture));
+    if (!texture) return NULL;
+
+    texture->id = id;
+    texture->width = width;
+    texture->height = height;
+    texture->internal_format = internal_format;
+    texture->bytes = (size_t)width * (size_t)height * bytes_per_pixel;
+
+    texture->next = registry->head;
+    if (registry->head) registry->head->prev = texture;
+    registry->head = texture;
+
+    registry->texture_count++;
+    registry->resident_count++;
+    registry->resident_bytes += texture->bytes;
+    return texture;
+}
+
+void texture_registry_remove(PAL_TextureRegistry* registry, PAL_GLTexture* texture) {
+    registry_release_storage(registry, texture, false);
+    registry_unlink(registry, texture);
+    registry->texture_count--;
+    free(texture);
+}
+
+bool texture_registry_restore(PAL_TextureRegistry* registry, PAL_GLStateCache* cache, PAL_GLTexture* texture) {
+    if (texture->id) return true;
+
+    glGenTextures(1, &texture->id);
+    if (!texture->id) return false;
+    gl_state_bind_texture(cache, texture->id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)texture->internal_format, texture->width, texture->height, 0,
+                 GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+
+    registry->resident_bytes += texture->bytes;
+    registry->resident_count++;
+    lru_update(registry, texture);
+    return true;
+}
+
+void texture_registry_touch(PAL_TextureRegistry* registry, PAL_GLTexture* texture, uint64_t frame) {
+    texture->last_used_frame = frame;
+    if (texture->in_lru && registry->lru_head != texture) {
+        lru_unlink(registry, texture);
+        lru_insert(registry, texture);
+    }
+}
+
+void texture_registry_set_purgeable(PAL_TextureRegistry* registry, PAL_GLTexture* texture, bool purgeable) {
+    texture->purgeable = purgeable;
+    lru_update(registry, texture);
+}
+
+void texture_registry_enforce_budget(PAL_TextureRegistry* registry, uint64_t current_frame) {
+    if (registry->budget_bytes == 0) return;
+
+    while (registry->resident_bytes > registry->budget_bytes) {
+        // The tail is the least recently used candidate; if it was used this
+        // frame, so was everything else on the list
+        PAL_GLTexture* victim = registry->lru_tail;
+        if (!victim || victim->last_used_frame >= current_frame) return; // Remaining memory is pinned or in use this frame
+
+        if (!registry_release_storage(registry, victim, registry->defer_deletes)) return;
+        registry->evictions++;
+    }
+}
+
+void texture_registry_delete_pending(PAL_TextureRegistry* registry) {
+    for (size_t i = 0; i < registry->pending_count; i++) {
+        registry_delete_texture(registry, registry->pending_deletes[i]);
+    }
+    registry->pending_count = 0;
+}
+
+void texture_registry_destroy_all(PAL_TextureRegistry* registry) {
+    texture_registry_delete_pending(registry);
+    free(registry->pending_deletes);
+    registry->pending_deletes = NULL;
+    registry->pending_capacity = 0;
+
+    PAL_GLTexture* texture = registry->head;
+    while (texture) {
+        PAL_GLTexture* next = texture->next;
+        registry_release_storage(registry, texture, false);
+        free(texture);
+        texture = next;
+    }
+    registry->head = NULL;
+    registry->lru_head = registry->lru_tail = NULL;
+    registry->texture_count = 0;
+}
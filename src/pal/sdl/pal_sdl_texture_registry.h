@@ -0,0 +1,112 @@
+#ifndef PAL_SDL_TEXTURE_REGISTRY_H
+#define PAL_SDL_TEXTURE_REGISTRY_H
+
+// Internal to the SDL/OpenGL renderer backend - not part of the public API.
+
+#include "pal_sdl_gl_state.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Texture Registry --- //
+// Every texture the renderer hands out is a PAL_GLTexture record; the public
+// PAL_TextureHandle is a pointer to it. The registry links all records so
+// GPU memory can be accounted for, purgeable textures evicted least recently
+// used first when over budget, and everything released at renderer destroy.
+// Resident purgeable textures are also kept on an LRU list, most recently
+// used at its head, so an eviction takes the tail instead of scanning.
+// Renderers in a share group (pal_renderer_create_shared) use one registry, so
+// it keeps the state cache of every context that may have a texture bound.
+
+#define PAL_TEXTURE_REGISTRY_MAX_CACHES 8
+typedef struct PAL_GLTexture {
+    GLuint id;              // 0 while evicted
+    int width;
+    int height;
+    GLenum internal_format;
+    size_t bytes;           // GPU memory while resident
+    uint64_t last_used_frame;
+    bool purgeable;         // May be evicted to meet the budget
+    bool is_layer;          // Render target created by pal_renderer_create_layer
+    bool in_lru;            // Resident and purgeable, so on the LRU list
+    struct PAL_GLTexture* prev;
+    struct PAL_GLTexture* next;
+    struct PAL_GLTexture* lru_prev;
+    struct PAL_GLTexture* lru_next;
+} PAL_GLTexture;
+
+typedef struct {
+    PAL_GLTexture* head;
+    PAL_GLTexture* lru_head; // Most recently used eviction candidate
+    PAL_GLTexture* lru_tail; // Next texture to evict
+    size_t budget_bytes;   // 0 means unlimited
+    size_t resident_bytes;
+    uint32_t texture_count;
+    uint32_t resident_count;
+    uint32_t evictions;
+    PAL_GLStateCache* caches[PAL_TEXTURE_REGISTRY_MAX_CACHES]; // Told when a texture is deleted
+    int cache_count;
+
+    // With a render thread, evictions are decided on the UI thread while the
+    // GL context is on the render thread; the names wait here until
+    // texture_registry_delete_pending runs there
+    bool defer_deletes;
+    GLuint* pending_deletes;
+    size_t pending_count;
+    size_t pending_capacity;
+} PAL_TextureRegistry;
+
+/**
+ * @brief Registers the state cache of a context sharing the textures.
+ *        Returns false if PAL_TEXTURE_REGISTRY_MAX_CACHES are already attached.
+ */
+bool texture_registry_attach_cache(PAL_TextureRegistry* registry, PAL_GLStateCache* cache);
+void texture_registry_detach_cache(PAL_TextureRegistry* registry, PAL_GLStateCache* cache);
+
+/**
+ * @brief Records a freshly created GL texture. Returns NULL if out of memory
+ *        (the caller still owns the GL texture in that case).
+ */
+PAL_GLTexture* texture_registry_add(PAL_TextureRegistry* registry, GLuint id, int width, int height,
+                                    GLenum internal_format, size_t bytes_per_pixel);
+
+/**
+ * @brief Deletes a texture's GL storage (if resident), unlinks and frees the record.
+ *        Deletions are reported to every attached state cache.
+ */
+void texture_registry_remove(PAL_TextureRegistry* registry, PAL_GLTexture* texture);
+
+/**
+ * @brief Gives an evicted texture new (undefined) GL storage of its original size.
+ *        The new storage is left bound to the texture unit.
+ */
+bool texture_registry_restore(PAL_TextureRegistry* registry, PAL_GLStateCache* cache, PAL_GLTexture* texture);
+
+/**
+ * @brief Stamps a texture as used in frame, moving it to the head of the LRU list.
+ */
+void texture_registry_touch(PAL_TextureRegistry* registry, PAL_GLTexture* texture, uint64_t frame);
+
+/**
+ * @brief Marks a texture as purgeable or pinned. Does not enforce the budget.
+ */
+void texture_registry_set_purgeable(PAL_TextureRegistry* registry, PAL_GLTexture* texture, bool purgeable);
+
+/**
+ * @brief Evicts purgeable textures, least recently used first, until resident
+ *        memory fits the budget. Textures used in current_frame are never
+ *        evicted since recorded draws may still reference them.
+ */
+void texture_registry_enforce_budget(PAL_TextureRegistry* registry, uint64_t current_frame);
+
+/**
+ * @brief Deletes the textures evicted while defer_deletes was set. The GL context must be current.
+ */
+void texture_registry_delete_pending(PAL_TextureRegistry* registry);
+
+/**
+ * @brief Deletes every registered texture and frees all records.
+ */
+void texture_registry_destroy_all(PAL_TextureRegistry* registry);
+
+#endif // PAL_SDL_TEXTURE_REGISTRY_H
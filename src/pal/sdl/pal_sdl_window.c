@@ -1,21 +1,30 @@
 #include "ui_framework/pal/pal_window.h"
+#include "pal_sdl_window_internal.h"
 
 #include <SDL.h> // SDL main header
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 
-// Internal structure for the opaque PAL_Window handle
-struct PAL_Window {
-    SDL_Window* sdl_window;
-    SDL_GLContext gl_context; // Added for renderer association
-    bool should_close_flag; // Flag set by input polling on SDL_QUIT
-    // We might add SDL_GLContext here later if needed for rendering
-};
-
 // Helper to manage SDL subsystem initialization count
 static int sdl_init_count = 0;
 
+// Open windows, for routing events by window ID
+static PAL_Window* window_list = NULL;
+
+PAL_Window* pal_sdl_window_from_id(Uint32 window_id) {
+    for (PAL_Window* window = window_list; window; window = window->next) {
+        if (window->window_id == window_id) {
+            return window;
+        }
+    }
+    return NULL;
+}
+
+PAL_Window* pal_sdl_window_list(void) {
+    return window_list;
+}
+
 // --- Lifecycle Implementation ---
 
 PAL_Window* pal_window_create(const PAL_WindowConfig* config) {
@@ -34,11 +43,16 @@ PAL_Window* pal_window_create(const PAL_WindowConfig* config) {
     sdl_init_count++;
 
     // Determine window flags
+#ifdef PAL_SOFTWARE_RENDERER
+    Uint32 flags = SDL_WINDOW_SHOWN; // The software renderer presents through the window surface
+#else
     Uint32 flags = SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL; // Added SDL_WINDOW_OPENGL
+#endif
     if (config->resizable) {
         flags |= SDL_WINDOW_RESIZABLE;
     }
     
+#ifndef PAL_SOFTWARE_RENDERER
     // Set OpenGL context attributes BEFORE creating window
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
@@ -46,6 +60,7 @@ PAL_Window* pal_window_create(const PAL_WindowConfig* config) {
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
     SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
+#endif
 
     SDL_Window* sdl_win = SDL_CreateWindow(
         config->title ? config->title : "PAL Window",
@@ -67,7 +82,7 @@ PAL_Window* pal_window_create(const PAL_WindowConfig* config) {
     }
 
     // Allocate our PAL_Window structure
-    PAL_Window* pal_win = (PAL_Window*)malloc(sizeof(PAL_Window));
+    PAL_Window* pal_win = (PAL_Window*)calloc(1, sizeof(PAL_Window));
     if (!pal_win) {
         fprintf(stderr, "PAL Error: Failed to allocate PAL_Window structure\n");
         SDL_DestroyWindow(sdl_win);
@@ -80,8 +95,14 @@ PAL_Window* pal_window_create(const PAL_WindowConfig* config) {
 
     // Initialize the structure
     pal_win->sdl_window = sdl_win;
+    pal_win->window_id = SDL_GetWindowID(sdl_win);
     pal_win->should_close_flag = false; // Input system must set this on SDL_QUIT
     pal_win->gl_context = NULL; // Renderer will create and assign this
+    pal_win->exposed = false;
+    pal_win->present_mode = config->present_mode;
+
+    pal_win->next = window_list;
+    window_list = pal_win;
 
     return pal_win;
 }
@@ -91,6 +112,13 @@ void pal_window_destroy(PAL_Window* window) {
         return;
     }
 
+    for (PAL_Window** link = &window_list; *link; link = &(*link)->next) {
+        if (*link == window) {
+            *link = window->next;
+            break;
+        }
+    }
+
     if (window->sdl_window) {
         SDL_DestroyWindow(window->sdl_window);
     }
@@ -112,7 +140,7 @@ bool pal_window_should_close(PAL_Window* window) {
         return true; // Treat NULL window as implicitly closed
     }
     // This flag needs to be updated by the input polling system
-    // when an SDL_QUIT event is detected.
+    // when an SDL_QUIT event or a close request for this window is detected.
     return window->should_close_flag;
 }
 
@@ -0,0 +1,45 @@
+#ifndef PAL_SDL_WINDOW_INTERNAL_H
+#define PAL_SDL_WINDOW_INTERNAL_H
+
+// Internal to the SDL backend - not part of the public API.
+
+#include "ui_framework/pal/pal_window.h"
+#include <SDL.h>
+#include <stdbool.h>
+
+#define PAL_WINDOW_TEXT_INPUT_SIZE 32
+
+// The single definition of the opaque PAL_Window, shared by the SDL backend
+// files so they all agree on its layout.
+struct PAL_Window {
+    SDL_Window* sdl_window;
+    Uint32 window_id;         // SDL window ID that events are routed by
+    SDL_GLContext gl_context; // Created and owned by the renderer
+    bool should_close_flag;   // Set by input polling on SDL_QUIT or a close request for this window
+    bool exposed;             // Set by input when the OS needs the contents presented again
+    PAL_PresentMode present_mode; // From the config; applied by the renderer
+
+    // Input routed to this window by pal_input_poll_events
+    int mouse_x;               // Last pointer position over the window
+    int mouse_y;
+    Uint32 mouse_buttons;      // SDL_BUTTON() mask of buttons pressed in the window
+    Uint32 mouse_buttons_prev; // Mask at the previous poll
+    float wheel_x;             // Scrolled since the last poll
+    float wheel_y;
+    char text_input[PAL_WINDOW_TEXT_INPUT_SIZE]; // Typed since the last poll
+
+    struct PAL_Window* next;   // Open windows, most recently created first
+};
+
+/**
+ * @brief Finds an open window by its SDL window ID, or NULL if none matches
+ *        (e.g. events still queued for a destroyed window).
+ */
+PAL_Window* pal_sdl_window_from_id(Uint32 window_id);
+
+/**
+ * @brief First window of the list of open windows (iterate with ->next).
+ */
+PAL_Window* pal_sdl_window_list(void);
+
+#endif // PAL_SDL_WINDOW_INTERNAL_H
@@ -0,0 +1,516 @@
+#include "pal_sw_raster.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PAL_SW_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// --- Pixel Helpers --- //
+
+static inline float pixel_channel(uint32_t pixel, int shift) {
+    return (float)((pixel >> shift) & 0xFF);
+}
+
+// Channels are in [0, 255]
+static inline uint32_t pack_rgba(float r, float g, float b, float a) {
+    return ((uint32_t)(a + 0.5f) << 24) | ((uint32_t)(b + 0.5f) << 16) |
+           ((uint32_t)(g + 0.5f) << 8) | (uint32_t)(r + 0.5f);
+}
+
+// Straight-alpha "over", as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+static inline uint32_t blend_pixel(uint32_t dst, float r, float g, float b, float a) {
+    float sa = a * (1.0f / 255.0f);
+    float dr = pixel_channel(dst, 0);
+    float dg = pixel_channel(dst, 8);
+    float db = pixel_channel(dst, 16);
+    float da = pixel_channel(dst, 24);
+    return pack_rgba(dr + (r - dr) * sa, dg + (g - dg) * sa, db + (b - db) * sa, da + (a - da) * sa);
+}
+
+#ifdef PAL_SW_SSE2
+static inline __m128i pack_rgba4(__m128 r, __m128 g, __m128 b, __m128 a) {
+    __m128i ir = _mm_cvtps_epi32(r);
+    __m128i ig = _mm_slli_epi32(_mm_cvtps_epi32(g), 8);
+    __m128i ib = _mm_slli_epi32(_mm_cvtps_epi32(b), 16);
+    __m128i ia = _mm_slli_epi32(_mm_cvtps_epi32(a), 24);
+    return _mm_or_si128(_mm_or_si128(ir, ig), _mm_or_si128(ib, ia));
+}
+
+// Four pixels of blend_pixel
+static inline __m128i blend_pixel4(__m128i dst, __m128 r, __m128 g, __m128 b, __m128 a) {
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    __m128 sa = _mm_mul_ps(a, _mm_set1_ps(1.0f / 255.0f));
+    __m128 dr = _mm_cvtepi32_ps(_mm_and_si128(dst, byte_mask));
+    __m128 dg = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(dst, 8), byte_mask));
+    __m128 db = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(dst, 16), byte_mask));
+    __m128 da = _mm_cvtepi32_ps(_mm_srli_epi32(dst, 24));
+    r = _mm_add_ps(dr, _mm_mul_ps(_mm_sub_ps(r, dr), sa));
+    g = _mm_add_ps(dg, _mm_mul_ps(_mm_sub_ps(g, dg), sa));
+    b = _mm_add_ps(db, _mm_mul_ps(_mm_sub_ps(b, db), sa));
+    a = _mm_add_ps(da, _mm_mul_ps(_mm_sub_ps(a, da), sa));
+    return pack_rgba4(r, g, b, a);
+}
+
+static inline __m128 pixel_channel4(__m128i pixels, int shift) {
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xFF)));
+}
+#endif
+
+static bool clip_rect(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip,
+                      int* x0, int* y0, int* x1, int* y1) {
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 > target->width) *x1 = target->width;
+    if (*y1 > target->height) *y1 = target->height;
+    if (clip) {
+        if (*x0 < clip->x0) *x0 = clip->x0;
+        if (*y0 < clip->y0) *y0 = clip->y0;
+        if (*x1 > clip->x1) *x1 = clip->x1;
+        if (*y1 > clip->y1) *y1 = clip->y1;
+    }
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+// --- Spans --- //
+
+static void fill_span(uint32_t* row, int count, uint32_t color) {
+    int x = 0;
+#ifdef PAL_SW_SSE2
+    __m128i value = _mm_set1_epi32((int)color);
+    for (; x + 4 <= count; x += 4) {
+        _mm_storeu_si128((__m128i*)(row + x), value);
+    }
+#endif
+    for (; x < count; x++) {
+        row[x] = color;
+    }
+}
+
+static void blend_span(uint32_t* row, int count, uint32_t color) {
+    float r = pixel_channel(color, 0);
+    float g = pixel_channel(color, 8);
+    float b = pixel_channel(color, 16);
+    float a = pixel_channel(color, 24);
+    int x = 0;
+#ifdef PAL_SW_SSE2
+    __m128 vr = _mm_set1_ps(r), vg = _mm_set1_ps(g), vb = _mm_set1_ps(b), va = _mm_set1_ps(a);
+    for (; x + 4 <= count; x += 4) {
+        __m128i dst = _mm_loadu_si128((const __m128i*)(row + x));
+        _mm_storeu_si128((__m128i*)(row + x), blend_pixel4(dst, vr, vg, vb, va));
+    }
+#endif
+    for (; x < count; x++) {
+        row[x] = blend_pixel(row[x], r, g, b, a);
+    }
+}
+
+void sw_raster_fill(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip,
+                    int x0, int y0, int x1, int y1, uint32_t color) {
+    if (!target || (color >> 24) == 0) return;
+    if (!clip_rect(target, clip, &x0, &y0, &x1, &y1)) return;
+
+    bool opaque = (color >> 24) == 0xFF;
+    for (int y = y0; y < y1; y++) {
+        uint32_t* row = target->pixels + (size_t)y * (size_t)target->stride + x0;
+        if (opaque) {
+            fill_span(row, x1 - x0, color);
+        } else {
+            blend_span(row, x1 - x0, color);
+        }
+    }
+}
+
+void sw_raster_clear(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip, uint32_t color) {
+    if (!target) return;
+    int x0 = 0, y0 = 0, x1 = target->width, y1 = target->height;
+    if (!clip_rect(target, clip, &x0, &y0, &x1, &y1)) return;
+    for (int y = y0; y < y1; y++) {
+        fill_span(target->pixels + (size_t)y * (size_t)target->stride + x0, x1 - x0, color);
+    }
+}
+
+// --- Triangles --- //
+// Edge-function rasterization: each edge is a plane E(x, y) = dx*x + dy*y + c
+// that is positive inside the triangle, and every interpolated attribute is a
+// plane over the same coordinates, so a pixel needs no per-triangle state
+// beyond its center. Rows are trimmed to the span the edges allow, and the
+// interior is shaded four pixels at a time where SSE2 is available.
+
+typedef struct {
+    float dx, dy, c; // value(x, y) = dx * x + dy * y + c
+} RasterPlane;
+
+enum { ATTR_R, ATTR_G, ATTR_B, ATTR_A, ATTR_U, ATTR_V, ATTR_COUNT };
+
+typedef struct {
+    RasterPlane edges[3];  // edges[i] is opposite vertex i
+    bool top_left[3];      // Pixels exactly on a top or left edge are inside
+    RasterPlane attrs[ATTR_COUNT];
+    bool flat;             // One color for the whole triangle (attrs R..A unused)
+    float flat_rgba[4];
+    uint32_t flat_color;
+    const PAL_SoftwareSurface* texture; // NULL for untextured
+} TriangleSetup;
+
+static void edge_setup(RasterPlane* edge, bool* top_left, const PAL_Vertex* a, const PAL_Vertex* b) {
+    float dx = b->x - a->x;
+    float dy = b->y - a->y;
+    edge->dx = -dy;
+    edge->dy = dx;
+    edge->c = dy * a->x - dx * a->y;
+    // Clockwise on screen (y down): top edges run rightwards, left edges upwards
+    *top_left = dy < 0.0f || (dy == 0.0f && dx > 0.0f);
+}
+
+static inline bool edge_inside(float e, bool top_left) {
+    return e > 0.0f || (e == 0.0f && top_left);
+}
+
+static inline uint32_t sample_texture(const PAL_SoftwareSurface* texture, float u, float v) {
+    // Nearest texel, clamped to the edge (NaN clamps to 0)
+    float fx = u * (float)texture->width;
+    float fy = v * (float)texture->height;
+    int tx = (fx > 0.0f) ? ((fx < (float)(texture->width - 1)) ? (int)fx : texture->width - 1) : 0;
+    int ty = (fy > 0.0f) ? ((fy < (float)(texture->height - 1)) ? (int)fy : texture->height - 1) : 0;
+    return texture->pixels[(size_t)ty * (size_t)texture->stride + tx];
+}
+
+// Shades the pixel at px on a row whose attribute values at x = 0 are attr_row
+static inline void shade_pixel(const TriangleSetup* t, uint32_t* dst, float px, const float* attr_row) {
+    float r, g, b, a;
+    if (t->flat) {
+        r = t->flat_rgba[0];
+        g = t->flat_rgba[1];
+        b = t->flat_rgba[2];
+        a = t->flat_rgba[3];
+    } else {
+        r = t->attrs[ATTR_R].dx * px + attr_row[ATTR_R];
+        g = t->attrs[ATTR_G].dx * px + attr_row[ATTR_G];
+        b = t->attrs[ATTR_B].dx * px + attr_row[ATTR_B];
+        a = t->attrs[ATTR_A].dx * px + attr_row[ATTR_A];
+    }
+    if (t->texture) {
+        uint32_t texel = sample_texture(t->texture, t->attrs[ATTR_U].dx * px + attr_row[ATTR_U],
+                                        t->attrs[ATTR_V].dx * px + attr_row[ATTR_V]);
+        const float scale = 1.0f / 255.0f;
+        r *= pixel_channel(texel, 0) * scale;
+        g *= pixel_channel(texel, 8) * scale;
+        b *= pixel_channel(texel, 16) * scale;
+        a *= pixel_channel(texel, 24) * scale;
+    } else if (t->flat && t->flat_rgba[3] >= 255.0f) {
+        *dst = t->flat_color;
+        return;
+    }
+    // Interpolation may overshoot slightly outside [0, 255] near vertices
+    r = fminf(fmaxf(r, 0.0f), 255.0f);
+    g = fminf(fmaxf(g, 0.0f), 255.0f);
+    b = fminf(fmaxf(b, 0.0f), 255.0f);
+    a = fminf(fmaxf(a, 0.0f), 255.0f);
+    *dst = blend_pixel(*dst, r, g, b, a);
+}
+
+#ifdef PAL_SW_SSE2
+// Shades the four pixels starting at x on row py; lanes outside the triangle are left alone
+static inline void shade_block4(const TriangleSetup* t, uint32_t* dst, int x, const float* edge_row,
+                                const float* attr_row) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 px = _mm_add_ps(_mm_set1_ps((float)x), _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f));
+
+    __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int i = 0; i < 3; i++) {
+        __m128 e = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(t->edges[i].dx)), _mm_set1_ps(edge_row[i]));
+        mask = _mm_and_ps(mask, t->top_left[i] ? _mm_cmpge_ps(e, zero) : _mm_cmpgt_ps(e, zero));
+    }
+    int bits = _mm_movemask_ps(mask);
+    if (bits == 0) return;
+
+    __m128i old = _mm_loadu_si128((const __m128i*)dst);
+    __m128i result;
+    if (!t->texture && t->flat && t->flat_rgba[3] >= 255.0f) {
+        result = _mm_set1_epi32((int)t->flat_color);
+    } else {
+        __m128 r, g, b, a;
+        if (t->flat) {
+            r = _mm_set1_ps(t->flat_rgba[0]);
+            g = _mm_set1_ps(t->flat_rgba[1]);
+            b = _mm_set1_ps(t->flat_rgba[2]);
+            a = _mm_set1_ps(t->flat_rgba[3]);
+        } else {
+            r = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(t->attrs[ATTR_R].dx)), _mm_set1_ps(attr_row[ATTR_R]));
+            g = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(t->attrs[ATTR_G].dx)), _mm_set1_ps(attr_row[ATTR_G]));
+            b = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(t->attrs[ATTR_B].dx)), _mm_set1_ps(attr_row[ATTR_B]));
+            a = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(t->attrs[ATTR_A].dx)), _mm_set1_ps(attr_row[ATTR_A]));
+        }
+        if (t->texture) {
+            const PAL_SoftwareSurface* texture = t->texture;
+            __m128 u = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(t->attrs[ATTR_U].dx)), _mm_set1_ps(attr_row[ATTR_U]));
+            __m128 v = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(t->attrs[ATTR_V].dx)), _mm_set1_ps(attr_row[ATTR_V]));
+            // max_ps returns the second operand for NaN, so NaN clamps to 0
+            u = _mm_min_ps(_mm_max_ps(_mm_mul_ps(u, _mm_set1_ps((float)texture->width)), zero),
+                           _mm_set1_ps((float)(texture->width - 1)));
+            v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(v, _mm_set1_ps((float)texture->height)), zero),
+                           _mm_set1_ps((float)(texture->height - 1)));
+            int32_t tx[4], ty[4];
+            _mm_storeu_si128((__m128i*)tx, _mm_cvttps_epi32(u));
+            _mm_storeu_si128((__m128i*)ty, _mm_cvttps_epi32(v));
+            size_t stride = (size_t)texture->stride;
+            __m128i texels = _mm_set_epi32((int)texture->pixels[(size_t)ty[3] * stride + tx[3]],
+                                           (int)texture->pixels[(size_t)ty[2] * stride + tx[2]],
+                                           (int)texture->pixels[(size_t)ty[1] * stride + tx[1]],
+                                           (int)texture->pixels[(size_t)ty[0] * stride + tx[0]]);
+            const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+            r = _mm_mul_ps(r, _mm_mul_ps(pixel_channel4(texels, 0), scale));
+            g = _mm_mul_ps(g, _mm_mul_ps(pixel_channel4(texels, 8), scale));
+            b = _mm_mul_ps(b, _mm_mul_ps(pixel_channel4(texels, 16), scale));
+            a = _mm_mul_ps(a, _mm_mul_ps(pixel_channel4(texels, 24), scale));
+        }
+        const __m128 max_channel = _mm_set1_ps(255.0f);
+        r = _mm_min_ps(_mm_max_ps(r, zero), max_channel);
+        g = _mm_min_ps(_mm_max_ps(g, zero), max_channel);
+        b = _mm_min_ps(_mm_max_ps(b, zero), max_channel);
+        a = _mm_min_ps(_mm_max_ps(a, zero), max_channel);
+        result = blend_pixel4(old, r, g, b, a);
+    }
+
+    __m128i keep = _mm_castps_si128(mask);
+    result = _mm_or_si128(_mm_and_si128(keep, result), _mm_andnot_si128(keep, old));
+    _mm_storeu_si128((__m128i*)dst, result);
+}
+#endif
+
+void sw_raster_triangle(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip,
+                        const PAL_Vertex* v0, const PAL_Vertex* v1, const PAL_Vertex* v2,
+                        const PAL_SoftwareSurface* texture) {
+    if (!target || !v0 || !v1 || !v2) return;
+
+    float area = (v1->x - v0->x) * (v2->y - v0->y) - (v1->y - v0->y) * (v2->x - v0->x);
+    if (!(fabsf(area) > 0.0f) || !isfinite(area)) return; // Degenerate (or NaN)
+    if (area < 0.0f) {
+        // Counter-clockwise: swap to clockwise so inside is positive for every edge
+        const PAL_Vertex* swap = v1;
+        v1 = v2;
+        v2 = swap;
+        area = -area;
+    }
+
+    // Bounding box, clipped in float first so huge coordinates never reach int
+    float min_x = fminf(v0->x, fminf(v1->x, v2->x));
+    float max_x = fmaxf(v0->x, fmaxf(v1->x, v2->x));
+    float min_y = fminf(v0->y, fminf(v1->y, v2->y));
+    float max_y = fmaxf(v0->y, fmaxf(v1->y, v2->y));
+    int x0 = 0, y0 = 0, x1 = target->width, y1 = target->height;
+    if (!clip_rect(target, clip, &x0, &y0, &x1, &y1)) return;
+    if (min_x >= (float)x1 || max_x <= (float)x0 || min_y >= (float)y1 || max_y <= (float)y0) return;
+    if (min_y > (float)y0) y0 = (int)min_y;
+    if (max_y < (float)y1) y1 = (int)ceilf(max_y);
+
+    TriangleSetup t;
+    edge_setup(&t.edges[0], &t.top_left[0], v1, v2);
+    edge_setup(&t.edges[1], &t.top_left[1], v2, v0);
+    edge_setup(&t.edges[2], &t.top_left[2], v0, v1);
+    t.texture = (texture && texture->pixels && texture->width > 0 && texture->height > 0) ? texture : NULL;
+
+    // attr = attr0 + w1 * (attr1 - attr0) + w2 * (attr2 - attr0), with w1 = E1 / area and w2 = E2 / area
+    float values[3][ATTR_COUNT];
+    const PAL_Vertex* vertices[3] = { v0, v1, v2 };
+    for (int i = 0; i < 3; i++) {
+        uint32_t color = vertices[i]->color;
+        values[i][ATTR_R] = pixel_channel(color, 0);
+        values[i][ATTR_G] = pixel_channel(color, 8);
+        values[i][ATTR_B] = pixel_channel(color, 16);
+        values[i][ATTR_A] = pixel_channel(color, 24);
+        values[i][ATTR_U] = vertices[i]->u;
+        values[i][ATTR_V] = vertices[i]->v;
+    }
+    float inv_area = 1.0f / area;
+    for (int a = 0; a < ATTR_COUNT; a++) {
+        float d1 = (values[1][a] - values[0][a]) * inv_area;
+        float d2 = (values[2][a] - values[0][a]) * inv_area;
+        t.attrs[a].dx = d1 * t.edges[1].dx + d2 * t.edges[2].dx;
+        t.attrs[a].dy = d1 * t.edges[1].dy + d2 * t.edges[2].dy;
+        t.attrs[a].c = values[0][a] + d1 * t.edges[1].c + d2 * t.edges[2].c;
+    }
+    t.flat = v0->color == v1->color && v0->color == v2->color;
+    t.flat_color = v0->color;
+    for (int c = 0; c < 4; c++) {
+        t.flat_rgba[c] = values[0][ATTR_R + c];
+    }
+    if (t.flat && (t.flat_color >> 24) == 0) return; // Fully transparent
+
+    for (int y = y0; y < y1; y++) {
+        float py = (float)y + 0.5f;
+        float edge_row[3];
+        for (int i = 0; i < 3; i++) {
+            edge_row[i] = t.edges[i].dy * py + t.edges[i].c;
+        }
+
+        // Trim the row to the pixel centers every edge allows (conservatively;
+        // the per-pixel test decides exactly)
+        float lo = (float)x0 + 0.5f;
+        float hi = (float)x1 - 0.5f;
+        bool empty = false;
+        for (int i = 0; i < 3; i++) {
+            float dx = t.edges[i].dx;
+            if (dx > 0.0f) {
+                lo = fmaxf(lo, -edge_row[i] / dx);
+            } else if (dx < 0.0f) {
+                hi = fminf(hi, -edge_row[i] / dx);
+            } else if (edge_row[i] < 0.0f) {
+                empty = true;
+            }
+        }
+        if (empty || lo > hi + 1.0f) continue;
+        int span_x0 = (int)floorf(fminf(lo, (float)x1) - 0.5f) - 1;
+        int span_x1 = (int)floorf(fmaxf(hi, (float)x0) - 0.5f) + 2;
+        if (span_x0 < x0) span_x0 = x0;
+        if (span_x1 > x1) span_x1 = x1;
+
+        float attr_row[ATTR_COUNT];
+        for (int a = 0; a < ATTR_COUNT; a++) {
+            attr_row[a] = t.attrs[a].dy * py + t.attrs[a].c;
+        }
+
+        uint32_t* row = target->pixels + (size_t)y * (size_t)target->stride;
+        int x = span_x0;
+#ifdef PAL_SW_SSE2
+        for (; x + 4 <= span_x1; x += 4) {
+            shade_block4(&t, row + x, x, edge_row, attr_row);
+        }
+#endif
+        for (; x < span_x1; x++) {
+            float px = (float)x + 0.5f;
+            if (edge_inside(t.edges[0].dx * px + edge_row[0], t.top_left[0]) &&
+                edge_inside(t.edges[1].dx * px + edge_row[1], t.top_left[1]) &&
+                edge_inside(t.edges[2].dx * px + edge_row[2], t.top_left[2])) {
+                shade_pixel(&t, row + x, px, attr_row);
+            }
+        }
+    }
+}
+
+// --- Styled Rectangles --- //
+// A per-pixel port of the GL rectangle fragment shader. Screen-space distance
+// gradients are 1, so the anti-aliasing width is one pixel.
+
+static float sd_round_rect(float px, float py, float half_w, float half_h, float radius) {
+    float qx = fabsf(px) - half_w + radius;
+    float qy = fabsf(py) - half_h + radius;
+    float ox = fmaxf(qx, 0.0f);
+    float oy = fmaxf(qy, 0.0f);
+    return sqrtf(ox * ox + oy * oy) + fminf(fmaxf(qx, qy), 0.0f) - radius;
+}
+
+static inline float clamp01(float value) {
+    return fminf(fmaxf(value, 0.0f), 1.0f);
+}
+
+void sw_raster_rect(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip,
+                    const PAL_RectInstance* rect) {
+    if (!target || !rect || !(rect->width > 0.0f) || !(rect->height > 0.0f)) return;
+
+    float half_w = rect->width * 0.5f;
+    float half_h = rect->height * 0.5f;
+    float center_x = rect->x + half_w;
+    float center_y = rect->y + half_h;
+    float radius = fmaxf(fminf(rect->corner_radius, fminf(half_w, half_h)), 0.0f);
+    float border = fmaxf(rect->border_width, 0.0f);
+    float blur = fmaxf(rect->shadow_blur, 0.0f);
+    bool has_shadow = (rect->shadow_color >> 24) != 0;
+
+    float pad = 1.0f;
+    if (has_shadow) {
+        pad += blur + fmaxf(fabsf(rect->shadow_offset_x), fabsf(rect->shadow_offset_y));
+    }
+    float bx0 = center_x - half_w - pad, bx1 = center_x + half_w + pad;
+    float by0 = center_y - half_h - pad, by1 = center_y + half_h + pad;
+    int x0 = 0, y0 = 0, x1 = target->width, y1 = target->height;
+    if (!clip_rect(target, clip, &x0, &y0, &x1, &y1)) return;
+    if (bx0 >= (float)x1 || bx1 <= (float)x0 || by0 >= (float)y1 || by1 <= (float)y0) return;
+    if (bx0 > (float)x0) x0 = (int)bx0;
+    if (by0 > (float)y0) y0 = (int)by0;
+    if (bx1 < (float)x1) x1 = (int)ceilf(bx1);
+    if (by1 < (float)y1) y1 = (int)ceilf(by1);
+
+    const float scale = 1.0f / 255.0f;
+    float fill[4], border_rgba[4], shadow[4];
+    for (int c = 0; c < 4; c++) {
+        fill[c] = pixel_channel(rect->fill_color, c * 8) * scale;
+        border_rgba[c] = pixel_channel(rect->border_color, c * 8) * scale;
+        shadow[c] = pixel_channel(rect->shadow_color, c * 8) * scale;
+    }
+
+    // Straight edges of an opaque fill are solid one pixel in: fill those
+    // spans directly instead of evaluating the distance field
+    bool solid_interior = (rect->fill_color >> 24) == 0xFF;
+    float solid_inset = fmaxf(radius, border) + 1.0f;
+
+    float inner_w = fmaxf(half_w - border, 0.0f);
+    float inner_h = fmaxf(half_h - border, 0.0f);
+    float inner_radius = fmaxf(radius - border, 0.0f);
+
+    for (int y = y0; y < y1; y++) {
+        float ly = (float)y + 0.5f - center_y;
+        uint32_t* row = target->pixels + (size_t)y * (size_t)target->stride;
+
+        int solid_x0 = x1, solid_x1 = x1;
+        if (solid_interior && fabsf(ly) <= half_h - solid_inset) {
+            float reach = half_w - border - 1.0f;
+            if (reach > 0.0f) {
+                solid_x0 = (int)ceilf(center_x - reach - 0.5f);
+                solid_x1 = (int)floorf(center_x + reach - 0.5f) + 1;
+                if (solid_x0 < x0) solid_x0 = x0;
+                if (solid_x1 > x1) solid_x1 = x1;
+                if (solid_x0 >= solid_x1) solid_x0 = solid_x1 = x1;
+            }
+        }
+
+        for (int x = x0; x < x1; x++) {
+            if (x == solid_x0) {
+                fill_span(row + x, solid_x1 - solid_x0, rect->fill_color);
+                x = solid_x1 - 1;
+                continue;
+            }
+            float lx = (float)x + 0.5f - center_x;
+
+            float d = sd_round_rect(lx, ly, half_w, half_h, radius);
+            float coverage = clamp01(0.5f - d);
+
+            float shape[4] = { fill[0], fill[1], fill[2], fill[3] };
+            if (border > 0.0f) {
+                float inner = sd_round_rect(lx, ly, inner_w, inner_h, inner_radius);
+                float t = clamp01(0.5f - inner);
+                for (int c = 0; c < 4; c++) {
+                    shape[c] = border_rgba[c] + (fill[c] - border_rgba[c]) * t;
+                }
+            }
+            // Premultiplied from here on
+            float alpha = shape[3] * coverage;
+            float result[4] = { shape[0] * alpha, shape[1] * alpha, shape[2] * alpha, alpha };
+
+            if (has_shadow) {
+                float ds = sd_round_rect(lx - rect->shadow_offset_x, ly - rect->shadow_offset_y, half_w, half_h, radius);
+                float amount;
+                if (blur > 0.0f) {
+                    float t = clamp01((ds + blur) / (2.0f * blur));
+                    amount = 1.0f - t * t * (3.0f - 2.0f * t);
+                } else {
+                    amount = clamp01(0.5f - ds);
+                }
+                float shadow_alpha = shadow[3] * amount * (1.0f - result[3]); // Shape over shadow
+                result[0] += shadow[0] * shadow_alpha;
+                result[1] += shadow[1] * shadow_alpha;
+                result[2] += shadow[2] * shadow_alpha;
+                result[3] += shadow_alpha;
+            }
+
+            if (result[3] <= 0.0f) continue;
+            float unpremultiply = 255.0f / result[3];
+            row[x] = blend_pixel(row[x], fminf(result[0] * unpremultiply, 255.0f),
+                                 fminf(result[1] * unpremultiply, 255.0f),
+                                 fminf(result[2] * unpremultiply, 255.0f), result[3] * 255.0f);
+        }
+    }
+}
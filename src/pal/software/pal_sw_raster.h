@@ -0,0 +1,58 @@
+#ifndef PAL_SW_RASTER_H
+#define PAL_SW_RASTER_H
+
+// Internal to the software renderer backend - not part of the public API.
+
+#include "ui_framework/pal/pal_renderer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Every pixel in this backend - render target and textures alike - uses the
+// Canvas packing (color_to_uint32, 0xAABBGGRR) with straight alpha, so the
+// vertex colors, texels and target can be combined without swizzling.
+// Blending matches the GL backend: src * src_alpha + dst * (1 - src_alpha)
+// on all four channels.
+
+typedef struct {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int stride; // Pixels between rows
+} PAL_SoftwareSurface;
+
+// Half-open pixel bounds [x0, x1) x [y0, y1), top-left origin
+typedef struct {
+    int x0, y0, x1, y1;
+} PAL_SoftwareClip;
+
+/**
+ * @brief Rasterizes one triangle with per-vertex colors, optionally textured.
+ *        Pixels whose centers lie inside the triangle are covered, using the
+ *        top-left fill rule so triangles sharing an edge never overlap.
+ *        Either winding is accepted. Texture coordinates are clamped to the
+ *        edge and sampled nearest-neighbour.
+ * @param texture Texture to modulate with, or NULL for plain vertex colors.
+ */
+void sw_raster_triangle(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip,
+                        const PAL_Vertex* v0, const PAL_Vertex* v1, const PAL_Vertex* v2,
+                        const PAL_SoftwareSurface* texture);
+
+/**
+ * @brief Overwrites every pixel inside the clip with color (no blending).
+ */
+void sw_raster_clear(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip, uint32_t color);
+
+/**
+ * @brief Fills (or blends, if color is translucent) an axis-aligned pixel rectangle.
+ */
+void sw_raster_fill(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip,
+                    int x0, int y0, int x1, int y1, uint32_t color);
+
+/**
+ * @brief Draws one styled rectangle (rounded corners, border, shadow) with the
+ *        same coverage rules as the GL SDF rectangle pipeline.
+ */
+void sw_raster_rect(const PAL_SoftwareSurface* target, const PAL_SoftwareClip* clip,
+                    const PAL_RectInstance* rect);
+
+#endif // PAL_SW_RASTER_H
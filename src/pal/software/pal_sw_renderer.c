@@ -0,0 +1,1018 @@
+#include "ui_framework/pal/pal_renderer.h"
+#include "ui_framework/pal/pal_window.h"
+#include "ui_framework/pal/pal_quad_batch.h"
+#include "ui_framework/drawing/canvas.h"
+#include "../sdl/pal_sdl_window_internal.h"
+#include "../sdl/pal_sdl_frame_pacer.h"
+#include "../pal_capture_stream.h"
+#include "pal_sw_raster.h"
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Software Renderer --- //
+// Implements the PAL renderer API on the CPU: every submission is rasterized
+// straight into a Canvas that persists between frames, and end_frame copies
+// the canvas to the window surface. Needs no GPU or GL driver, so it serves
+// thin clients and VMs without acceleration, and renders headless for free.
+//
+// Differences from the OpenGL backend:
+// - Draws execute immediately, so flush is a no-op and nothing is batched.
+// - Textures are sampled nearest-neighbour rather than bilinear.
+// - Window surfaces have no vsync: PAL_PRESENT_MODE_VSYNC and ADAPTIVE_VSYNC
+//   fall back to PAL_PRESENT_MODE_FRAME_PACED, which paces frames to the
+//   display refresh rate with a timer (see pal_renderer_wait_for_frame).
+// - Textures live in system memory; the budget still evicts purgeable ones.
+
+typedef struct PAL_SoftwareTexture {
+    PAL_SoftwareSurface surface; // Canvas packing; pixels is NULL while evicted
+    size_t bytes;
+    uint64_t last_used_frame;
+    bool purgeable;
+    bool is_layer;               // Created by pal_renderer_create_layer
+    bool in_lru;                 // Resident and purgeable, so on the LRU list
+    struct PAL_SoftwareTexture* prev;
+    struct PAL_SoftwareTexture* next;
+    struct PAL_SoftwareTexture* lru_prev;
+    struct PAL_SoftwareTexture* lru_next;
+} PAL_SoftwareTexture;
+
+// Texture memory. Renderers created with pal_renderer_create_shared use the
+// same set, so their textures can be drawn and destroyed through any of them.
+typedef struct {
+    int ref_count; // Renderers using the set; the last one frees the textures
+    PAL_SoftwareTexture* head;
+    PAL_SoftwareTexture* lru_head; // Most recently drawn eviction candidate
+    PAL_SoftwareTexture* lru_tail; // Next texture to evict
+    size_t budget_bytes;
+    size_t resident_bytes;
+    uint32_t texture_count;
+    uint32_t resident_count;
+    uint32_t evictions;
+    uint64_t frame_serial; // Frames begun by any renderer using the set; stamps texture use for LRU eviction
+} PAL_TextureSet;
+
+typedef struct {
+    bool full;          // Whole window damaged
+    int x0, y0, x1, y1; // Bounding box (top-left origin); empty if x0 >= x1
+} PAL_DamageRegion;
+
+struct PAL_Renderer {
+    PAL_Window* pal_window;       // NULL for headless renderers
+    Canvas* canvas;               // Render target, kept between frames
+    PAL_SoftwareSurface target;   // The canvas pixels
+    SDL_Surface* canvas_surface;  // Canvas pixels wrapped for blitting to the window
+    int window_width;
+    int window_height;
+
+    PAL_VertexFormat vertex_format;
+    PAL_Vertex* scratch;          // Compact submissions and quad batches converted for the rasterizer
+    size_t scratch_capacity;
+
+    bool scissor_enabled;
+    PAL_SoftwareClip scissor;     // Scissor set by the application
+    PAL_SoftwareClip frame_clip;  // Area redrawn this frame (damage box or whole canvas)
+    PAL_SoftwareClip clip;        // Intersection of both, applied to submissions
+
+    // While a layer is being drawn, target and frame_clip point at the layer
+    // and the frame's are kept here
+    struct PAL_SoftwareTexture* layer;
+    PAL_SoftwareSurface frame_target;
+    PAL_SoftwareClip layer_saved_frame_clip;
+
+    PAL_TextureSet* textures; // Possibly shared with other renderers
+    uint64_t frame_index;     // Incremented by begin_frame
+
+    PAL_RendererStats frame_stats;      // Accumulating for the frame in progress
+    PAL_RendererStats last_frame_stats; // Snapshot of the last completed frame
+
+    // Damage tracking (only used when enabled in the config)
+    bool damage_tracking;
+    PAL_DamageRegion damage; // Accumulated for the next frame
+    bool frame_skipped;      // begin_frame found no damage; submissions are discarded
+    bool present_pending;    // Window was exposed; present the canvas even without damage
+
+    PAL_FramePacer pacer; // Present mode, frame pacing and interval measurement
+
+    // Frame capture. The canvas is already in memory, so frames are captured
+    // synchronously at end_frame.
+    PAL_CaptureCallback capture_request; // Waiting for the next frame, NULL if none
+    void* capture_user_data;
+    PAL_CaptureStream* capture_stream;
+    uint8_t* capture_pixels;             // BGRA copy of the canvas
+    size_t capture_capacity;
+    PAL_CaptureStats capture_stats;
+};
+
+// --- Pixel Format Helpers --- //
+// Texture data and read_pixels use bytes B, G, R, A (as the GL backend's
+// GL_BGRA uploads); the canvas stores color_to_uint32 values.
+
+static inline uint32_t bgra_to_canvas(const uint8_t* bgra) {
+    return ((uint32_t)bgra[3] << 24) | ((uint32_t)bgra[0] << 16) | ((uint32_t)bgra[1] << 8) | (uint32_t)bgra[2];
+}
+
+static inline void canvas_to_bgra(uint32_t pixel, uint8_t* bgra) {
+    bgra[0] = (uint8_t)(pixel >> 16);
+    bgra[1] = (uint8_t)(pixel >> 8);
+    bgra[2] = (uint8_t)pixel;
+    bgra[3] = (uint8_t)(pixel >> 24);
+}
+
+static void copy_bgra_region(PAL_SoftwareSurface* surface, int x, int y, int width, int height,
+                             const void* data, int stride_bytes) {
+    size_t src_stride = stride_bytes ? (size_t)stride_bytes : (size_t)width * 4;
+    for (int row = 0; row < height; row++) {
+        const uint8_t* src = (const uint8_t*)data + src_stride * (size_t)row;
+        uint32_t* dst = surface->pixels + (size_t)(y + row) * (size_t)surface->stride + x;
+        for (int col = 0; col < width; col++) {
+            dst[col] = bgra_to_canvas(src + col * 4);
+        }
+    }
+}
+
+// --- Render Target --- //
+
+static void update_clip(PAL_Renderer* renderer) {
+    renderer->clip = renderer->frame_clip;
+    if (!renderer->scissor_enabled) return;
+    const PAL_SoftwareClip* s = &renderer->scissor;
+    if (s->x0 > renderer->clip.x0) renderer->clip.x0 = s->x0;
+    if (s->y0 > renderer->clip.y0) renderer->clip.y0 = s->y0;
+    if (s->x1 < renderer->clip.x1) renderer->clip.x1 = s->x1;
+    if (s->y1 < renderer->clip.y1) renderer->clip.y1 = s->y1;
+}
+
+// (Re)creates the canvas at a new size. The old contents are discarded.
+static bool target_resize(PAL_Renderer* renderer, int width, int height) {
+    if (width <= 0 || height <= 0) return false;
+    Canvas* canvas = canvas_create(width, height);
+    if (!canvas) return false;
+
+    SDL_Surface* surface = NULL;
+    if (renderer->pal_window) {
+        surface = SDL_CreateRGBSurfaceWithFormatFrom(canvas_get_mutable_data(canvas), width, height, 32,
+                                                     width * 4, SDL_PIXELFORMAT_ABGR8888);
+        if (!surface) {
+            fprintf(stderr, "PAL Renderer Error: Failed to wrap canvas in a surface: %s\n", SDL_GetError());
+            canvas_destroy(canvas);
+            return false;
+        }
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE); // Copy, don't blend, onto the window
+    }
+
+    if (renderer->canvas_surface) SDL_FreeSurface(renderer->canvas_surface);
+    canvas_destroy(renderer->canvas);
+    renderer->canvas = canvas;
+    renderer->canvas_surface = surface;
+    renderer->target.pixels = canvas_get_mutable_data(canvas);
+    renderer->target.width = width;
+    renderer->target.height = height;
+    renderer->target.stride = width;
+    renderer->window_width = width;
+    renderer->window_height = height;
+    return true;
+}
+
+// Copies part of the canvas to the window
+static void present_canvas(PAL_Renderer* renderer, const PAL_SoftwareClip* area) {
+    SDL_Window* window = renderer->pal_window->sdl_window;
+    SDL_Surface* window_surface = SDL_GetWindowSurface(window);
+    if (!window_surface) {
+        fprintf(stderr, "PAL Renderer Error: Failed to get window surface: %s\n", SDL_GetError());
+        return;
+    }
+    SDL_Rect rect = { area->x0, area->y0, area->x1 - area->x0, area->y1 - area->y0 };
+    if (rect.w <= 0 || rect.h <= 0) return;
+    SDL_Rect dest = rect; // Blitting may clip the destination rect
+    SDL_BlitSurface(renderer->canvas_surface, &rect, window_surface, &dest);
+    SDL_UpdateWindowSurfaceRects(window, &rect, 1);
+}
+
+// --- Damage Tracking --- //
+
+static void damage_region_add(PAL_DamageRegion* damage, int x0, int y0, int x1, int y1) {
+    if (damage->x0 >= damage->x1 || damage->y0 >= damage->y1) {
+        damage->x0 = x0;
+        damage->y0 = y0;
+        damage->x1 = x1;
+        damage->y1 = y1;
+        return;
+    }
+    if (x0 < damage->x0) damage->x0 = x0;
+    if (y0 < damage->y0) damage->y0 = y0;
+    if (x1 > damage->x1) damage->x1 = x1;
+    if (y1 > damage->y1) damage->y1 = y1;
+}
+
+// Consumes the accumulated damage into a clip. Returns false if nothing changed.
+static bool damage_region_take(PAL_DamageRegion* damage, int width, int height, PAL_SoftwareClip* clip) {
+    bool full = damage->full;
+    int x0 = damage->x0 > 0 ? damage->x0 : 0;
+    int y0 = damage->y0 > 0 ? damage->y0 : 0;
+    int x1 = damage->x1 < width ? damage->x1 : width;
+    int y1 = damage->y1 < height ? damage->y1 : height;
+    memset(damage, 0, sizeof(*damage));
+
+    if (full) {
+        clip->x0 = 0;
+        clip->y0 = 0;
+        clip->x1 = width;
+        clip->y1 = height;
+        return true;
+    }
+    if (x1 <= x0 || y1 <= y0) return false;
+    clip->x0 = x0;
+    clip->y0 = y0;
+    clip->x1 = x1;
+    clip->y1 = y1;
+    return true;
+}
+
+// --- Texture Memory --- //
+
+static void lru_unlink(PAL_TextureSet* textures, PAL_SoftwareTexture* texture) {
+    if (!texture->in_lru) return;
+    if (texture->lru_prev) texture->lru_prev->lru_next = texture->lru_next;
+    else textures->lru_head = texture->lru_next;
+    if (texture->lru_next) texture->lru_next->lru_prev = texture->lru_prev;
+    else textures->lru_tail = texture->lru_prev;
+    texture->lru_prev = texture->lru_next = NULL;
+    texture->in_lru = false;
+}
+
+// Keeps the list ordered by last_used_frame, newest at the head. Drawn
+// textures carry the current frame and go straight to the head.
+static void lru_insert(PAL_TextureSet* textures, PAL_SoftwareTexture* texture) {
+    PAL_SoftwareTexture* next = textures->lru_head;
+    while (next && next->last_used_frame > texture->last_used_frame) next = next->lru_next;
+
+    texture->lru_next = next;
+    texture->lru_prev = next ? next->lru_prev : textures->lru_tail;
+    if (texture->lru_prev) texture->lru_prev->lru_next = texture;
+    else textures->lru_head = texture;
+    if (next) next->lru_prev = texture;
+    else textures->lru_tail = texture;
+    texture->in_lru = true;
+}
+
+// Puts the texture on the LRU list exactly when it is an eviction candidate
+static void lru_update(PAL_TextureSet* textures, PAL_SoftwareTexture* texture) {
+    bool candidate = texture->surface.pixels && texture->purgeable;
+    if (candidate && !texture->in_lru) lru_insert(textures, texture);
+    else if (!candidate) lru_unlink(textures, texture);
+}
+
+static void texture_touch(PAL_TextureSet* textures, PAL_SoftwareTexture* texture) {
+    texture->last_used_frame = textures->frame_serial;
+    if (texture->in_lru && textures->lru_head != texture) {
+        lru_unlink(textures, texture);
+        lru_insert(textures, texture);
+    }
+}
+
+static void texture_evict(PAL_Renderer* renderer, PAL_SoftwareTexture* texture) {
+    lru_unlink(renderer->textures, texture);
+    free(texture->surface.pixels);
+    texture->surface.pixels = NULL;
+    renderer->textures->resident_bytes -= texture->bytes;
+    renderer->textures->resident_count--;
+    renderer->textures->evictions++;
+}
+
+// Evicts least recently drawn purgeable textures until resident memory fits
+// the budget. Textures drawn in the current frame are kept.
+static void enforce_texture_budget(PAL_Renderer* renderer) {
+    while (renderer->textures->budget_bytes && renderer->textures->resident_bytes > renderer->textures->budget_bytes) {
+        // Everything ahead of the tail was drawn at least as recently
+        PAL_SoftwareTexture* victim = renderer->textures->lru_tail;
+        if (!victim || victim->last_used_frame >= renderer->textures->frame_serial) return;
+        texture_evict(renderer, victim);
+    }
+}
+
+// Gives an evicted texture new (cleared) pixels
+static bool texture_restore(PAL_Renderer* renderer, PAL_SoftwareTexture* texture) {
+    if (texture->surface.pixels) return true;
+    texture->surface.pixels = (uint32_t*)calloc(1, texture->bytes);
+    if (!texture->surface.pixels) return false;
+    renderer->textures->resident_bytes += texture->bytes;
+    renderer->textures->resident_count++;
+    lru_update(renderer->textures, texture);
+    texture_touch(renderer->textures, texture);
+    enforce_texture_budget(renderer);
+    return true;
+}
+
+// The surface a submission samples, or NULL (plain vertex colors) for NULL
+// and evicted textures, matching the GL backend's white default texture.
+static const PAL_SoftwareSurface* texture_for_draw(PAL_Renderer* renderer, PAL_TextureHandle handle) {
+    PAL_SoftwareTexture* texture = (PAL_SoftwareTexture*)handle;
+    if (!texture || !texture->surface.pixels) return NULL;
+    texture_touch(renderer->textures, texture);
+    return &texture->surface;
+}
+
+// --- Lifecycle --- //
+
+// textures is the set to share, or NULL for a new one
+static PAL_Renderer* renderer_alloc(const PAL_RendererConfig* config, PAL_TextureSet* textures) {
+    PAL_Renderer* renderer = (PAL_Renderer*)calloc(1, sizeof(PAL_Renderer));
+    if (!renderer) {
+        fprintf(stderr, "PAL Renderer Error: Failed to allocate PAL_Renderer structure\n");
+        return NULL;
+    }
+    if (!textures) {
+        textures = (PAL_TextureSet*)calloc(1, sizeof(PAL_TextureSet));
+        if (!textures) {
+            fprintf(stderr, "PAL Renderer Error: Failed to allocate texture set\n");
+            free(renderer);
+            return NULL;
+        }
+        textures->budget_bytes = config->texture_budget_bytes;
+    }
+    textures->ref_count++;
+    renderer->textures = textures;
+    renderer->vertex_format = config->vertex_format;
+    renderer->damage_tracking = config->damage_tracking;
+    renderer->damage.full = true; // Nothing has been drawn yet
+    return renderer;
+}
+
+static void apply_present_mode(PAL_Renderer* renderer, PAL_PresentMode mode) {
+    if (!renderer->pal_window) {
+        frame_pacer_init(&renderer->pacer, PAL_PRESENT_MODE_IMMEDIATE, 0);
+        return;
+    }
+    // No vsync on window surfaces: pace to the refresh rate instead
+    if (mode == PAL_PRESENT_MODE_VSYNC || mode == PAL_PRESENT_MODE_ADAPTIVE_VSYNC) {
+        mode = PAL_PRESENT_MODE_FRAME_PACED;
+    }
+    int refresh_rate = 0;
+    SDL_DisplayMode display_mode;
+    if (SDL_GetWindowDisplayMode(renderer->pal_window->sdl_window, &display_mode) == 0) {
+        refresh_rate = display_mode.refresh_rate;
+    }
+    frame_pacer_init(&renderer->pacer, mode, refresh_rate);
+}
+
+PAL_Renderer* pal_renderer_create(PAL_Window* window) {
+    return pal_renderer_create_with_config(window, NULL);
+}
+
+PAL_Renderer* pal_renderer_create_with_config(PAL_Window* window, const PAL_RendererConfig* config) {
+    PAL_RendererConfig default_config = { PAL_VERTEX_FORMAT_STANDARD, 0, false, false, NULL };
+    if (!config) config = &default_config;
+
+    if (!window || !window->sdl_window) {
+        fprintf(stderr, "PAL Renderer Error: Invalid PAL_Window provided.\n");
+        return NULL;
+    }
+
+    PAL_Renderer* renderer = renderer_alloc(config, NULL);
+    if (!renderer) return NULL;
+    renderer->pal_window = window;
+
+    int width, height;
+    pal_window_get_size(window, &width, &height);
+    if (!target_resize(renderer, width, height)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create %dx%d canvas\n", width, height);
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
+    apply_present_mode(renderer, window->present_mode);
+    printf("Renderer: software (%dx%d canvas)\n", width, height);
+    return renderer;
+}
+
+PAL_Renderer* pal_renderer_create_shared(PAL_Renderer* share_with, PAL_Window* window, const PAL_RendererConfig* config) {
+    PAL_RendererConfig default_config = { PAL_VERTEX_FORMAT_STANDARD, 0, false, false, NULL };
+    if (!config) config = &default_config;
+
+    if (!share_with || !window || !window->sdl_window) {
+        fprintf(stderr, "PAL Renderer Error: Invalid renderer or PAL_Window provided.\n");
+        return NULL;
+    }
+
+    PAL_Renderer* renderer = renderer_alloc(config, share_with->textures);
+    if (!renderer) return NULL;
+    renderer->pal_window = window;
+
+    int width, height;
+    pal_window_get_size(window, &width, &height);
+    if (!target_resize(renderer, width, height)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create %dx%d canvas\n", width, height);
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
+    apply_present_mode(renderer, window->present_mode);
+    return renderer;
+}
+
+PAL_Renderer* pal_renderer_create_headless(int width, int height, const PAL_RendererConfig* config) {
+    PAL_RendererConfig default_config = { PAL_VERTEX_FORMAT_STANDARD, 0, false, false, NULL };
+    if (!config) config = &default_config;
+
+    PAL_Renderer* renderer = renderer_alloc(config, NULL);
+    if (!renderer) return NULL;
+    if (!target_resize(renderer, width, height)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to create %dx%d canvas\n", width, height);
+        pal_renderer_destroy(renderer);
+        return NULL;
+    }
+    apply_present_mode(renderer, PAL_PRESENT_MODE_IMMEDIATE);
+    return renderer;
+}
+
+PAL_VertexFormat pal_renderer_get_vertex_format(const PAL_Renderer* renderer) {
+    if (!renderer) return PAL_VERTEX_FORMAT_STANDARD;
+    return renderer->vertex_format;
+}
+
+void pal_renderer_destroy(PAL_Renderer* renderer) {
+    if (!renderer) return;
+
+    if (--renderer->textures->ref_count == 0) {
+        PAL_SoftwareTexture* texture = renderer->textures->head;
+        while (texture) {
+            PAL_SoftwareTexture* next = texture->next;
+            free(texture->surface.pixels);
+            free(texture);
+            texture = next;
+        }
+        free(renderer->textures);
+    }
+    capture_stream_close(renderer->capture_stream);
+    free(renderer->capture_pixels);
+    if (renderer->canvas_surface) SDL_FreeSurface(renderer->canvas_surface);
+    canvas_destroy(renderer->canvas);
+    free(renderer->scratch);
+    free(renderer);
+}
+
+// --- Frame Operations --- //
+bool pal_renderer_begin_frame(PAL_Renderer* renderer, Color clear_color) {
+    if (!renderer) return false;
+    frame_pacer_frame_started(&renderer->pacer);
+
+    if (renderer->pal_window) {
+        int width, height;
+        pal_window_get_size(renderer->pal_window, &width, &height);
+        if (width != renderer->window_width || height != renderer->window_height) {
+            if (target_resize(renderer, width, height)) {
+                renderer->damage.full = true;
+            } else {
+                fprintf(stderr, "PAL Renderer Error: Failed to resize canvas to %dx%d\n", width, height);
+            }
+        }
+        if (renderer->pal_window->exposed) {
+            renderer->pal_window->exposed = false;
+            renderer->present_pending = true;
+        }
+    }
+
+    int width = renderer->window_width;
+    int height = renderer->window_height;
+    if (renderer->damage_tracking) {
+        if (!damage_region_take(&renderer->damage, width, height, &renderer->frame_clip)) {
+            renderer->frame_skipped = true;
+            frame_pacer_frame_skipped(&renderer->pacer);
+            return false;
+        }
+    } else {
+        renderer->frame_clip = (PAL_SoftwareClip){ 0, 0, width, height };
+    }
+
+    // Clear only the area being redrawn, never a scissor left over from the last frame
+    sw_raster_clear(&renderer->target, &renderer->frame_clip, color_to_uint32(clear_color));
+
+    // Nothing is referenced by the new frame yet, so any purgeable texture may go
+    renderer->frame_index++;
+    renderer->textures->frame_serial++;
+    enforce_texture_budget(renderer);
+    pal_renderer_reset_scissor(renderer);
+    return true;
+}
+
+// Hands the finished canvas to a pending capture request and the stream
+static void capture_frame(PAL_Renderer* renderer) {
+    if (!renderer->capture_request && !renderer->capture_stream) return;
+
+    int width = renderer->window_width;
+    int height = renderer->window_height;
+    size_t size = (size_t)width * (size_t)height * 4;
+    if (size > renderer->capture_capacity) {
+        uint8_t* pixels = (uint8_t*)realloc(renderer->capture_pixels, size);
+        if (!pixels) {
+            fprintf(stderr, "PAL Renderer Error: Failed to allocate capture pixels\n");
+            return;
+        }
+        renderer->capture_pixels = pixels;
+        renderer->capture_capacity = size;
+    }
+    if (!pal_renderer_read_pixels(renderer, 0, 0, width, height, renderer->capture_pixels, 0)) return;
+
+    if (renderer->capture_stream) {
+        if (!capture_stream_submit(renderer->capture_stream, renderer->capture_pixels, (ptrdiff_t)width * 4,
+                                   width, height, renderer->frame_index, SDL_GetPerformanceCounter())) {
+            renderer->capture_stats.dropped_frames++;
+        }
+        if (!capture_stream_poll(renderer->capture_stream, &renderer->capture_stats.stream_bytes)) {
+            // The file is unusable (e.g. disk full); stop rather than fail every frame
+            capture_stream_close(renderer->capture_stream);
+            renderer->capture_stream = NULL;
+            renderer->capture_stats.streaming = false;
+        }
+    }
+    renderer->capture_stats.captured_frames++;
+
+    PAL_CaptureCallback callback = renderer->capture_request;
+    renderer->capture_request = NULL; // The callback may request another capture
+    if (callback) callback(renderer->capture_pixels, width, height, renderer->frame_index, renderer->capture_user_data);
+}
+
+void pal_renderer_end_frame(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    pal_renderer_end_layer(renderer); // In case one was left open
+
+    if (renderer->frame_skipped) {
+        // Nothing changed: leave the window alone unless the system needs the
+        // contents presented again
+        renderer->frame_skipped = false;
+        if (renderer->present_pending && renderer->pal_window) {
+            PAL_SoftwareClip all = { 0, 0, renderer->window_width, renderer->window_height };
+            present_canvas(renderer, &all);
+            frame_pacer_presented(&renderer->pacer);
+            renderer->present_pending = false;
+        }
+        return;
+    }
+
+    // Rasterization finished as the draws were submitted
+    frame_pacer_work_done(&renderer->pacer);
+    if (renderer->pal_window) {
+        PAL_SoftwareClip all = { 0, 0, renderer->window_width, renderer->window_height };
+        present_canvas(renderer, renderer->present_pending ? &all : &renderer->frame_clip);
+        renderer->present_pending = false;
+    }
+    frame_pacer_presented(&renderer->pacer);
+    capture_frame(renderer);
+
+    // Publish this frame's counters and start fresh
+    renderer->last_frame_stats = renderer->frame_stats;
+    memset(&renderer->frame_stats, 0, sizeof(renderer->frame_stats));
+}
+
+// --- Presentation --- //
+
+void pal_renderer_wait_for_frame(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    frame_pacer_wait(&renderer->pacer);
+}
+
+void pal_renderer_set_present_mode(PAL_Renderer* renderer, PAL_PresentMode mode) {
+    if (!renderer) return;
+    apply_present_mode(renderer, mode);
+}
+
+PAL_PresentMode pal_renderer_get_present_mode(const PAL_Renderer* renderer) {
+    if (!renderer) return PAL_PRESENT_MODE_VSYNC;
+    return renderer->pacer.mode;
+}
+
+void pal_renderer_get_frame_timing(const PAL_Renderer* renderer, PAL_FrameTiming* timing) {
+    if (!timing) return;
+    if (!renderer) {
+        memset(timing, 0, sizeof(*timing));
+        return;
+    }
+    frame_pacer_get_timing(&renderer->pacer, timing);
+}
+
+// --- GPU Profiling --- //
+// There is no GPU: passes are accepted and ignored, and timing is never available.
+
+void pal_renderer_begin_gpu_pass(PAL_Renderer* renderer, const char* label) {
+    (void)renderer;
+    (void)label;
+}
+
+void pal_renderer_end_gpu_pass(PAL_Renderer* renderer) {
+    (void)renderer;
+}
+
+void pal_renderer_get_gpu_timing(const PAL_Renderer* renderer, PAL_GpuTiming* timing) {
+    (void)renderer;
+    if (timing) memset(timing, 0, sizeof(*timing));
+}
+
+// --- Damage Tracking --- //
+
+void pal_renderer_add_damage(PAL_Renderer* renderer, int x, int y, int width, int height) {
+    if (!renderer || width <= 0 || height <= 0) return;
+    damage_region_add(&renderer->damage, x, y, x + width, y + height);
+}
+
+void pal_renderer_damage_all(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    renderer->damage.full = true;
+}
+
+bool pal_renderer_has_damage(const PAL_Renderer* renderer) {
+    if (!renderer) return false;
+    if (!renderer->damage_tracking) return true; // Every frame is a full redraw
+    const PAL_DamageRegion* damage = &renderer->damage;
+    return damage->full || (damage->x0 < damage->x1 && damage->y0 < damage->y1) ||
+           renderer->present_pending || (renderer->pal_window && renderer->pal_window->exposed);
+}
+
+void pal_renderer_flush(PAL_Renderer* renderer) {
+    (void)renderer; // Submissions are rasterized immediately
+}
+
+bool pal_renderer_read_pixels(PAL_Renderer* renderer, int x, int y, int width, int height,
+                              void* pixels, int stride_bytes) {
+    if (!renderer || !pixels || width <= 0 || height <= 0) return false;
+    if (stride_bytes < 0 || (stride_bytes % 4) != 0 || (stride_bytes && stride_bytes < width * 4)) {
+        fprintf(stderr, "PAL Renderer Error: Invalid read stride %d for width %d\n", stride_bytes, width);
+        return false;
+    }
+    if (x < 0 || y < 0 || x + width > renderer->window_width || y + height > renderer->window_height) {
+        fprintf(stderr, "PAL Renderer Error: Read area %d,%d %dx%d outside %dx%d target\n",
+                x, y, width, height, renderer->window_width, renderer->window_height);
+        return false;
+    }
+
+    size_t stride = stride_bytes ? (size_t)stride_bytes : (size_t)width * 4;
+    for (int row = 0; row < height; row++) {
+        const uint32_t* src = renderer->target.pixels + (size_t)(y + row) * (size_t)renderer->target.stride + x;
+        uint8_t* dst = (uint8_t*)pixels + stride * (size_t)row;
+        for (int col = 0; col < width; col++) {
+            canvas_to_bgra(src[col], dst + col * 4);
+        }
+    }
+    return true;
+}
+
+bool pal_renderer_request_capture(PAL_Renderer* renderer, PAL_CaptureCallback callback, void* user_data) {
+    if (!renderer || !callback) return false;
+    if (renderer->capture_request) return false;
+    renderer->capture_request = callback;
+    renderer->capture_user_data = user_data;
+    return true;
+}
+
+bool pal_renderer_start_capture_stream(PAL_Renderer* renderer, const char* path, PAL_CaptureFormat format) {
+    if (!renderer || !path) return false;
+    pal_renderer_stop_capture_stream(renderer);
+
+    renderer->capture_stream = capture_stream_open(path, format);
+    if (!renderer->capture_stream) return false;
+    renderer->capture_stats.streaming = true;
+    renderer->capture_stats.stream_bytes = 0;
+    return true;
+}
+
+void pal_renderer_stop_capture_stream(PAL_Renderer* renderer) {
+    if (!renderer || !renderer->capture_stream) return;
+    renderer->capture_stats.stream_bytes = capture_stream_close(renderer->capture_stream);
+    renderer->capture_stream = NULL;
+    renderer->capture_stats.streaming = false;
+}
+
+void pal_renderer_get_capture_stats(const PAL_Renderer* renderer, PAL_CaptureStats* stats) {
+    if (!stats) return;
+    if (!renderer) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = renderer->capture_stats;
+}
+
+void pal_renderer_get_stats(const PAL_Renderer* renderer, PAL_RendererStats* stats) {
+    if (!stats) return;
+    if (!renderer) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = renderer->last_frame_stats;
+}
+
+// --- Texture Management --- //
+
+PAL_TextureHandle pal_renderer_create_texture(PAL_Renderer* renderer, int width, int height, const void* data) {
+    if (!renderer || width <= 0 || height <= 0) return NULL;
+
+    PAL_SoftwareTexture* texture = (PAL_SoftwareTexture*)calloc(1, sizeof(PAL_SoftwareTexture));
+    size_t bytes = (size_t)width * (size_t)height * 4;
+    uint32_t* pixels = (uint32_t*)calloc(1, bytes);
+    if (!texture || !pixels) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory creating %dx%d texture\n", width, height);
+        free(texture);
+        free(pixels);
+        return NULL;
+    }
+    texture->surface.pixels = pixels;
+    texture->surface.width = width;
+    texture->surface.height = height;
+    texture->surface.stride = width;
+    texture->bytes = bytes;
+    texture->last_used_frame = renderer->textures->frame_serial;
+
+    texture->next = renderer->textures->head;
+    if (renderer->textures->head) renderer->textures->head->prev = texture;
+    renderer->textures->head = texture;
+    renderer->textures->texture_count++;
+    renderer->textures->resident_count++;
+    renderer->textures->resident_bytes += bytes;
+
+    if (data) copy_bgra_region(&texture->surface, 0, 0, width, height, data, 0);
+
+    // A new texture may push resident memory over budget
+    enforce_texture_budget(renderer);
+    return (PAL_TextureHandle)texture;
+}
+
+void pal_renderer_update_texture(PAL_Renderer* renderer, PAL_TextureHandle texture, int width, int height, const void* data) {
+    if (!renderer || !texture || !data || width <= 0 || height <= 0) return;
+    pal_renderer_update_texture_region(renderer, texture, 0, 0, width, height, data, 0);
+}
+
+void pal_renderer_update_texture_region(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                                        int x, int y, int width, int height,
+                                        const void* data, int stride_bytes) {
+    if (!renderer || !texture || !data || x < 0 || y < 0 || width <= 0 || height <= 0) return;
+    if (stride_bytes < 0 || stride_bytes % 4 != 0) {
+        fprintf(stderr, "PAL Renderer Error: Texture region stride %d is not a multiple of 4\n", stride_bytes);
+        return;
+    }
+    PAL_SoftwareTexture* sw_texture = (PAL_SoftwareTexture*)texture;
+    PAL_SoftwareSurface* surface = &sw_texture->surface;
+    if (x + width > surface->width || y + height > surface->height) {
+        fprintf(stderr, "PAL Renderer Error: Texture region %d,%d %dx%d outside %dx%d texture\n",
+                x, y, width, height, surface->width, surface->height);
+        return;
+    }
+
+    // Writing to an evicted texture makes it resident again
+    if (!texture_restore(renderer, sw_texture)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to restore evicted texture\n");
+        return;
+    }
+
+    copy_bgra_region(surface, x, y, width, height, data, stride_bytes);
+    renderer->frame_stats.upload_bytes += (uint32_t)((size_t)width * (size_t)height * 4);
+}
+
+void pal_renderer_destroy_texture(PAL_Renderer* renderer, PAL_TextureHandle texture) {
+    if (!renderer || !texture) return;
+    PAL_SoftwareTexture* sw_texture = (PAL_SoftwareTexture*)texture;
+    if (renderer->layer == sw_texture) pal_renderer_end_layer(renderer);
+
+    if (sw_texture->prev) sw_texture->prev->next = sw_texture->next;
+    else renderer->textures->head = sw_texture->next;
+    if (sw_texture->next) sw_texture->next->prev = sw_texture->prev;
+    lru_unlink(renderer->textures, sw_texture);
+
+    if (sw_texture->surface.pixels) {
+        renderer->textures->resident_bytes -= sw_texture->bytes;
+        renderer->textures->resident_count--;
+    }
+    renderer->textures->texture_count--;
+    free(sw_texture->surface.pixels);
+    free(sw_texture);
+}
+
+PAL_TextureHandle pal_renderer_create_layer(PAL_Renderer* renderer, int width, int height) {
+    PAL_SoftwareTexture* texture = (PAL_SoftwareTexture*)pal_renderer_create_texture(renderer, width, height, NULL);
+    if (!texture) return NULL;
+    texture->is_layer = true;
+    return texture;
+}
+
+bool pal_renderer_begin_layer(PAL_Renderer* renderer, PAL_TextureHandle layer, Color clear_color) {
+    if (!renderer || !layer) return false;
+    PAL_SoftwareTexture* texture = (PAL_SoftwareTexture*)layer;
+    if (!texture->is_layer) {
+        fprintf(stderr, "PAL Renderer Error: Texture is not a layer\n");
+        return false;
+    }
+
+    pal_renderer_end_layer(renderer);
+    // An evicted layer gets fresh pixels; its contents are redrawn anyway
+    if (!texture_restore(renderer, texture)) {
+        fprintf(stderr, "PAL Renderer Error: Failed to restore evicted layer\n");
+        return false;
+    }
+    texture_touch(renderer->textures, texture);
+
+    renderer->frame_target = renderer->target;
+    renderer->layer_saved_frame_clip = renderer->frame_clip;
+    renderer->target = texture->surface;
+    renderer->frame_clip = (PAL_SoftwareClip){ 0, 0, texture->surface.width, texture->surface.height };
+    renderer->layer = texture;
+    pal_renderer_reset_scissor(renderer);
+
+    sw_raster_clear(&renderer->target, &renderer->frame_clip, color_to_uint32(clear_color));
+    return true;
+}
+
+void pal_renderer_end_layer(PAL_Renderer* renderer) {
+    if (!renderer || !renderer->layer) return;
+
+    renderer->target = renderer->frame_target;
+    renderer->frame_clip = renderer->layer_saved_frame_clip;
+    renderer->layer = NULL;
+    pal_renderer_reset_scissor(renderer);
+}
+
+void pal_renderer_set_texture_purgeable(PAL_Renderer* renderer, PAL_TextureHandle texture, bool purgeable) {
+    if (!renderer || !texture) return;
+    PAL_SoftwareTexture* sw_texture = (PAL_SoftwareTexture*)texture;
+    sw_texture->purgeable = purgeable;
+    lru_update(renderer->textures, sw_texture);
+    if (purgeable) enforce_texture_budget(renderer);
+}
+
+bool pal_renderer_texture_is_resident(const PAL_Renderer* renderer, PAL_TextureHandle texture) {
+    if (!renderer || !texture) return false;
+    return ((const PAL_SoftwareTexture*)texture)->surface.pixels != NULL;
+}
+
+void pal_renderer_set_texture_budget(PAL_Renderer* renderer, size_t budget_bytes) {
+    if (!renderer) return;
+    renderer->textures->budget_bytes = budget_bytes;
+    enforce_texture_budget(renderer);
+}
+
+void pal_renderer_get_texture_stats(const PAL_Renderer* renderer, PAL_TextureStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!renderer) return;
+
+    stats->texture_count = renderer->textures->texture_count;
+    stats->resident_count = renderer->textures->resident_count;
+    stats->resident_bytes = renderer->textures->resident_bytes;
+    stats->budget_bytes = renderer->textures->budget_bytes;
+    stats->evictions = renderer->textures->evictions;
+    for (const PAL_SoftwareTexture* texture = renderer->textures->head; texture; texture = texture->next) {
+        if (texture->purgeable && texture->surface.pixels) stats->purgeable_bytes += texture->bytes;
+    }
+}
+
+// --- Drawing Operations --- //
+
+void pal_renderer_set_scissor(PAL_Renderer* renderer, int x, int y, int width, int height) {
+    if (!renderer) return;
+    renderer->scissor_enabled = true;
+    renderer->scissor.x0 = x;
+    renderer->scissor.y0 = y;
+    renderer->scissor.x1 = x + width;
+    renderer->scissor.y1 = y + height;
+    update_clip(renderer);
+}
+
+void pal_renderer_reset_scissor(PAL_Renderer* renderer) {
+    if (!renderer) return;
+    renderer->scissor_enabled = false;
+    update_clip(renderer);
+}
+
+// Submissions are drawn immediately unless the frame was skipped (layers are
+// always drawn)
+static bool can_draw(const PAL_Renderer* renderer) {
+    return (!renderer->frame_skipped || renderer->layer) && renderer->target.pixels;
+}
+
+void pal_renderer_render_triangles(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_Vertex* vertices, size_t vertex_count) {
+    if (!renderer || !vertices || vertex_count < 3 || !can_draw(renderer)) return;
+
+    const PAL_SoftwareSurface* surface = texture_for_draw(renderer, texture);
+    for (size_t i = 0; i + 2 < vertex_count; i += 3) {
+        sw_raster_triangle(&renderer->target, &renderer->clip, &vertices[i], &vertices[i + 1], &vertices[i + 2], surface);
+    }
+    renderer->frame_stats.draw_calls++;
+    renderer->frame_stats.vertices += (uint32_t)vertex_count;
+}
+
+static inline bool is_whole_pixel(float value) {
+    return value >= -16777216.0f && value <= 16777216.0f && value == (float)(int)value;
+}
+
+// Untextured quads of a single color covering whole pixels are plain fills
+static bool quad_is_pixel_rect(const PAL_Vertex* q) {
+    return q[0].color == q[1].color && q[0].color == q[2].color && q[0].color == q[3].color &&
+           q[0].y == q[1].y && q[1].x == q[2].x && q[2].y == q[3].y && q[3].x == q[0].x &&
+           is_whole_pixel(q[0].x) && is_whole_pixel(q[0].y) && is_whole_pixel(q[2].x) && is_whole_pixel(q[2].y) &&
+           q[0].x <= q[2].x && q[0].y <= q[2].y;
+}
+
+void pal_renderer_render_quads(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_Vertex* vertices, size_t quad_count) {
+    if (!renderer || !vertices || quad_count == 0 || !can_draw(renderer)) return;
+
+    const PAL_SoftwareSurface* surface = texture_for_draw(renderer, texture);
+    for (size_t i = 0; i < quad_count; i++) {
+        const PAL_Vertex* q = &vertices[i * 4];
+        if (!surface && quad_is_pixel_rect(q)) {
+            sw_raster_fill(&renderer->target, &renderer->clip, (int)q[0].x, (int)q[0].y, (int)q[2].x, (int)q[2].y, q[0].color);
+            continue;
+        }
+        sw_raster_triangle(&renderer->target, &renderer->clip, &q[0], &q[1], &q[2], surface);
+        sw_raster_triangle(&renderer->target, &renderer->clip, &q[0], &q[2], &q[3], surface);
+    }
+    renderer->frame_stats.draw_calls++;
+    renderer->frame_stats.vertices += (uint32_t)(quad_count * 4);
+    renderer->frame_stats.indices += (uint32_t)(quad_count * 6);
+}
+
+void pal_renderer_render_indexed(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                                 const PAL_Vertex* vertices, size_t vertex_count,
+                                 const uint32_t* indices, size_t index_count) {
+    if (!renderer || !vertices || !indices || vertex_count == 0 || index_count < 3 || !can_draw(renderer)) return;
+
+    const PAL_SoftwareSurface* surface = texture_for_draw(renderer, texture);
+    for (size_t i = 0; i + 2 < index_count; i += 3) {
+        if (indices[i] >= vertex_count || indices[i + 1] >= vertex_count || indices[i + 2] >= vertex_count) {
+            fprintf(stderr, "PAL Renderer Error: Index out of range in indexed draw (%zu vertices)\n", vertex_count);
+            return;
+        }
+        sw_raster_triangle(&renderer->target, &renderer->clip, &vertices[indices[i]], &vertices[indices[i + 1]],
+                           &vertices[indices[i + 2]], surface);
+    }
+    renderer->frame_stats.draw_calls++;
+    renderer->frame_stats.vertices += (uint32_t)vertex_count;
+    renderer->frame_stats.indices += (uint32_t)index_count;
+}
+
+// Grows the scratch buffer to hold count vertices
+static bool scratch_reserve(PAL_Renderer* renderer, size_t count) {
+    if (count <= renderer->scratch_capacity) return true;
+    size_t capacity = renderer->scratch_capacity ? renderer->scratch_capacity : 256;
+    while (capacity < count) capacity *= 2;
+    PAL_Vertex* scratch = (PAL_Vertex*)realloc(renderer->scratch, capacity * sizeof(PAL_Vertex));
+    if (!scratch) {
+        fprintf(stderr, "PAL Renderer Error: Out of memory converting %zu vertices\n", count);
+        return false;
+    }
+    renderer->scratch = scratch;
+    renderer->scratch_capacity = capacity;
+    return true;
+}
+
+// Converts compact vertices into the renderer's scratch buffer
+static const PAL_Vertex* expand_compact(PAL_Renderer* renderer, const PAL_VertexCompact* in, size_t count) {
+    if (!scratch_reserve(renderer, count)) return NULL;
+    const float pos_scale = 1.0f / (float)(1 << PAL_COMPACT_VERTEX_SUBPIXEL_BITS);
+    for (size_t i = 0; i < count; i++) {
+        renderer->scratch[i].x = in[i].x * pos_scale;
+        renderer->scratch[i].y = in[i].y * pos_scale;
+        renderer->scratch[i].u = in[i].u / 65535.0f;
+        renderer->scratch[i].v = in[i].v / 65535.0f;
+        renderer->scratch[i].color = in[i].color;
+    }
+    return renderer->scratch;
+}
+
+void pal_renderer_render_triangles_compact(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_VertexCompact* vertices, size_t vertex_count) {
+    if (!renderer || !vertices || vertex_count < 3 || !can_draw(renderer)) return;
+    const PAL_Vertex* expanded = expand_compact(renderer, vertices, vertex_count);
+    if (expanded) pal_renderer_render_triangles(renderer, texture, expanded, vertex_count);
+}
+
+void pal_renderer_render_quads_compact(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_VertexCompact* vertices, size_t quad_count) {
+    if (!renderer || !vertices || quad_count == 0 || !can_draw(renderer)) return;
+    const PAL_Vertex* expanded = expand_compact(renderer, vertices, quad_count * 4);
+    if (expanded) pal_renderer_render_quads(renderer, texture, expanded, quad_count);
+}
+
+void pal_renderer_render_quad_batch(PAL_Renderer* renderer, PAL_TextureHandle texture, const PAL_QuadRect* rects,
+                                    const PAL_QuadUV* uvs, const uint32_t* colors, size_t quad_count) {
+    if (!renderer || !rects || quad_count == 0 || !can_draw(renderer)) return;
+    if (!scratch_reserve(renderer, quad_count * 4)) return;
+    pal_quad_batch_write_quads(renderer->scratch, rects, uvs, colors, quad_count);
+    pal_renderer_render_quads(renderer, texture, renderer->scratch, quad_count);
+}
+
+void pal_renderer_render_rects(PAL_Renderer* renderer, const PAL_RectInstance* rects, size_t rect_count) {
+    if (!renderer || !rects || rect_count == 0 || !can_draw(renderer)) return;
+
+    for (size_t i = 0; i < rect_count; i++) {
+        sw_raster_rect(&renderer->target, &renderer->clip, &rects[i]);
+    }
+    renderer->frame_stats.draw_calls++;
+    renderer->frame_stats.rect_instances += (uint32_t)rect_count;
+}
+
+void pal_renderer_render_textured_quad(PAL_Renderer* renderer, PAL_TextureHandle texture,
+                                     float x, float y, float w, float h,
+                                     float u0, float v0, float u1, float v1,
+                                     Color color) {
+    if (!renderer) return;
+
+    PAL_QuadRect rect = { x, y, w, h };
+    PAL_QuadUV uv = { u0, v0, u1, v1 };
+    uint32_t vert_color = color_to_uint32(color); // ABGR, as the vertex color attribute expects
+    pal_renderer_render_quad_batch(renderer, texture, &rect, &uv, &vert_color, 1);
+}
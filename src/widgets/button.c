@@ -148,6 +148,7 @@ void button_set_text(Widget* button, const char* text) {
     
     // Copy new text
     data->text = PLATFORM_STRDUP(text);
+    widget_invalidate(button);
 }
 
 const char* button_get_text(const Widget* button) {
@@ -187,7 +188,10 @@ void button_set_background_color(Widget* button, Color color) {
         return;
     }
     
-    data->background_color = color;
+    if (color_to_uint32(data->background_color) != color_to_uint32(color)) {
+        data->background_color = color;
+        widget_invalidate(button);
+    }
 }
 
 void button_set_text_color(Widget* button, Color color) {
@@ -200,5 +204,8 @@ void button_set_text_color(Widget* button, Color color) {
         return;
     }
     
-    data->text_color = color;
+    if (color_to_uint32(data->text_color) != color_to_uint32(color)) {
+        data->text_color = color;
+        widget_invalidate(button);
+    }
 }
@@ -0,0 +1,303 @@
+/**
+ * @file container.c
+ * @brief Container widget implementation for the UI Framework
+ */
+
+#include "../../include/ui_framework/widgets/container.h"
+#include "../../include/ui_framework/drawing/primitives.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/**
+ * @brief Container data structure
+ */
+typedef struct {
+    Widget** children;
+    int child_count;
+    int child_capacity;
+    Color background_color;
+    bool layer_enabled;
+    Canvas* layer;           /* Cached drawing of the subtree, NULL until first needed */
+    bool layer_valid;
+    uint32_t layer_revision; /* Container revision the layer was drawn at */
+    uint32_t layer_version;  /* Bumped every time the layer is redrawn */
+} ContainerData;
+
+/**
+ * @brief Draw the container's background and children
+ */
+static void container_draw_contents(Widget* container, ContainerData* data, Canvas* canvas) {
+    if (data->background_color.a > 0) {
+        draw_filled_rectangle(canvas, widget_get_x(container), widget_get_y(container),
+                              widget_get_width(container), widget_get_height(container),
+                              data->background_color);
+    }
+
+    for (int i = 0; i < data->child_count; i++) {
+        widget_draw(data->children[i], canvas);
+    }
+}
+
+/**
+ * @brief Redraw the layer if the subtree changed since it was drawn
+ *
+ * @return true if the layer holds the current subtree, false if it could not be created
+ */
+static bool container_update_layer(Widget* container, ContainerData* data) {
+    int width = widget_get_width(container);
+    int height = widget_get_height(container);
+
+    if (data->layer && (canvas_get_width(data->layer) != width || canvas_get_height(data->layer) != height)) {
+        canvas_destroy(data->layer);
+        data->layer = NULL;
+    }
+    if (!data->layer) {
+        data->layer = canvas_create(width, height);
+        if (!data->layer) {
+            fprintf(stderr, "Failed to create %dx%d container layer\n", width, height);
+            return false;
+        }
+        /* Premultiplied pixels keep translucent children intact against the
+         * transparent background and composite like the children drawn directly */
+        canvas_set_blend_mode(data->layer, CANVAS_BLEND_PREMULTIPLIED);
+        data->layer_valid = false;
+    }
+
+    uint32_t revision = widget_get_revision(container);
+    if (data->layer_valid && data->layer_revision == revision) {
+        return true;
+    }
+
+    /* Children draw in window coordinates; the origin maps them into the layer */
+    canvas_clear(data->layer, COLOR_TRANSPARENT);
+    canvas_set_origin(data->layer, widget_get_x(container), widget_get_y(container));
+    container_draw_contents(container, data, data->layer);
+
+    data->layer_valid = true;
+    data->layer_revision = revision;
+    data->layer_version++;
+    return true;
+}
+
+/**
+ * @brief Container draw function
+ */
+static void container_draw_function(Widget* container, Canvas* canvas) {
+    if (!container || !canvas) {
+        return;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return;
+    }
+
+    if (data->layer_enabled && container_update_layer(container, data)) {
+        canvas_draw_canvas_premultiplied(canvas, data->layer, widget_get_x(container), widget_get_y(container));
+        return;
+    }
+
+    container_draw_contents(container, data, canvas);
+}
+
+/**
+ * @brief Container event handler
+ *
+ * Offers the event to the children, topmost (last added) first.
+ */
+static bool container_event_handler(Widget* container, const Event* event) {
+    if (!container || !event) {
+        return false;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return false;
+    }
+
+    for (int i = data->child_count - 1; i >= 0; i--) {
+        if (widget_is_visible(data->children[i]) && widget_handle_event(data->children[i], event)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Container destroy function: detaches the children and frees the data
+ */
+static void container_release(Widget* container) {
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return;
+    }
+
+    for (int i = 0; i < data->child_count; i++) {
+        widget_set_parent(data->children[i], NULL);
+    }
+    free(data->children);
+    canvas_destroy(data->layer);
+    free(data);
+    widget_set_user_data(container, NULL);
+}
+
+Widget* container_create(int x, int y, int width, int height) {
+    ContainerData* data = (ContainerData*)malloc(sizeof(ContainerData));
+    if (!data) {
+        return NULL;
+    }
+
+    memset(data, 0, sizeof(ContainerData));
+    data->background_color = COLOR_TRANSPARENT;
+
+    Widget* container = widget_create(x, y, width, height, data, container_draw_function, container_event_handler);
+    if (!container) {
+        free(data);
+        return NULL;
+    }
+    widget_set_destroy_function(container, container_release);
+
+    return container;
+}
+
+void container_destroy(Widget* container) {
+    widget_destroy(container);
+}
+
+int container_add_child(Widget* container, Widget* child) {
+    if (!container || !child || child == container || widget_get_parent(child)) {
+        return -1;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return -1;
+    }
+
+    if (data->child_count == data->child_capacity) {
+        int new_capacity = data->child_capacity ? data->child_capacity * 2 : 8;
+        Widget** children = (Widget**)realloc(data->children, (size_t)new_capacity * sizeof(Widget*));
+        if (!children) {
+            return -1;
+        }
+        data->children = children;
+        data->child_capacity = new_capacity;
+    }
+
+    data->children[data->child_count++] = child;
+    widget_set_parent(child, container);
+
+    return 0;
+}
+
+int container_remove_child(Widget* container, Widget* child) {
+    if (!container || !child) {
+        return -1;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return -1;
+    }
+
+    for (int i = 0; i < data->child_count; i++) {
+        if (data->children[i] == child) {
+            memmove(&data->children[i], &data->children[i + 1],
+                    (size_t)(data->child_count - i - 1) * sizeof(Widget*));
+            data->child_count--;
+            widget_set_parent(child, NULL);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int container_get_child_count(const Widget* container) {
+    if (!container) {
+        return 0;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return 0;
+    }
+
+    return data->child_count;
+}
+
+Widget* container_get_child(const Widget* container, int index) {
+    if (!container) {
+        return NULL;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data || index < 0 || index >= data->child_count) {
+        return NULL;
+    }
+
+    return data->children[index];
+}
+
+void container_set_background_color(Widget* container, Color color) {
+    if (!container) {
+        return;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return;
+    }
+
+    if (color_to_uint32(data->background_color) != color_to_uint32(color)) {
+        data->background_color = color;
+        widget_invalidate(container);
+    }
+}
+
+void container_set_layer_enabled(Widget* container, bool enabled) {
+    if (!container) {
+        return;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data || data->layer_enabled == enabled) {
+        return;
+    }
+
+    data->layer_enabled = enabled;
+    if (!enabled) {
+        canvas_destroy(data->layer);
+        data->layer = NULL;
+        data->layer_valid = false;
+    }
+}
+
+bool container_is_layer_enabled(const Widget* container) {
+    if (!container) {
+        return false;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data) {
+        return false;
+    }
+
+    return data->layer_enabled;
+}
+
+const Canvas* container_get_layer(Widget* container, uint32_t* version) {
+    if (!container) {
+        return NULL;
+    }
+
+    ContainerData* data = (ContainerData*)widget_get_user_data(container);
+    if (!data || !data->layer_enabled || !container_update_layer(container, data)) {
+        return NULL;
+    }
+
+    if (version) *version = data->layer_version;
+    return data->layer;
+}
@@ -4,6 +4,7 @@
  */
 
 #include "../../include/ui_framework/widgets/widget.h"
+#include "../../include/ui_framework/widgets/container.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -21,8 +22,70 @@ struct Widget {
     void* user_data;
     WidgetDrawFunction draw_fn;
     WidgetEventHandler event_handler;
+    WidgetDestroyFunction destroy_fn;
+    bool dirty;
+    int damage_x0, damage_y0, damage_x1, damage_y1; /* Area to redraw, valid while dirty */
+    uint64_t damage_since; /* Damage clock when the area was started */
+    uint64_t taken_at;     /* Damage clock when damage was last taken here */
+    Widget* parent;
+    uint32_t revision; /* Bumped on every change to the widget or a descendant */
 };
 
+/* Orders damage against takes: ticks on every take and on every new damage area */
+static uint64_t damage_clock = 0;
+
+/**
+ * @brief Check if a widget has damage that neither it nor an ancestor has taken
+ *
+ * Taking an ancestor's damage takes what its descendants reported to it as
+ * well, and the widget has no list of children to clear, so a descendant's
+ * area counts as taken once an ancestor was taken after the area was started.
+ */
+static bool widget_has_damage(const Widget* widget) {
+    if (!widget->dirty) {
+        return false;
+    }
+
+    for (const Widget* ancestor = widget->parent; ancestor; ancestor = ancestor->parent) {
+        if (ancestor->taken_at > widget->damage_since) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Add an area to the pending damage of a widget and its ancestors
+ */
+static void widget_add_damage_area(Widget* widget, int x0, int y0, int x1, int y1) {
+    for (; widget; widget = widget->parent) {
+        widget->revision++;
+
+        if (!widget_has_damage(widget)) {
+            widget->damage_x0 = x0;
+            widget->damage_y0 = y0;
+            widget->damage_x1 = x1;
+            widget->damage_y1 = y1;
+            widget->damage_since = ++damage_clock;
+            widget->dirty = true;
+            continue;
+        }
+
+        if (x0 < widget->damage_x0) widget->damage_x0 = x0;
+        if (y0 < widget->damage_y0) widget->damage_y0 = y0;
+        if (x1 > widget->damage_x1) widget->damage_x1 = x1;
+        if (y1 > widget->damage_y1) widget->damage_y1 = y1;
+    }
+}
+
+/**
+ * @brief Add the widget's current bounds to its pending damage
+ */
+static void widget_add_damage(Widget* widget) {
+    widget_add_damage_area(widget, widget->x, widget->y,
+                           widget->x + widget->width, widget->y + widget->height);
+}
+
 Widget* widget_create(int x, int y, int width, int height, 
                      void* user_data, 
                      WidgetDrawFunction draw_fn, 
@@ -45,6 +108,15 @@ Widget* widget_create(int x, int y, int width, int height,
     widget->user_data = user_data;
     widget->draw_fn = draw_fn;
     widget->event_handler = event_handler;
+    widget->destroy_fn = NULL;
+    widget->dirty = false;
+    widget->damage_since = 0;
+    widget->taken_at = 0;
+    widget->parent = NULL;
+    widget->revision = 0;
+
+    /* A new widget has never been drawn */
+    widget_add_damage(widget);
 
     return widget;
 }
@@ -54,9 +126,27 @@ void widget_destroy(Widget* widget) {
         return;
     }
 
+    if (widget->destroy_fn) {
+        widget->destroy_fn(widget);
+    }
+
+    /* Removing the widget damages the area it covered in its ancestors and
+     * leaves no pointer to it in the parent's children */
+    if (widget->parent) {
+        container_remove_child(widget->parent, widget);
+    }
+
     free(widget);
 }
 
+void widget_set_destroy_function(Widget* widget, WidgetDestroyFunction destroy_fn) {
+    if (!widget) {
+        return;
+    }
+
+    widget->destroy_fn = destroy_fn;
+}
+
 void widget_draw(Widget* widget, Canvas* canvas) {
     if (!widget || !canvas || !widget->visible || !widget->draw_fn) {
         return;
@@ -78,8 +168,15 @@ void widget_set_position(Widget* widget, int x, int y) {
         return;
     }
 
+    if (widget->x == x && widget->y == y) {
+        return;
+    }
+
+    /* Both the old and the new location need redrawing */
+    widget_add_damage(widget);
     widget->x = x;
     widget->y = y;
+    widget_add_damage(widget);
 }
 
 void widget_set_size(Widget* widget, int width, int height) {
@@ -87,8 +184,14 @@ void widget_set_size(Widget* widget, int width, int height) {
         return;
     }
 
+    if (widget->width == width && widget->height == height) {
+        return;
+    }
+
+    widget_add_damage(widget);
     widget->width = width;
     widget->height = height;
+    widget_add_damage(widget);
 }
 
 int widget_get_x(const Widget* widget) {
@@ -128,7 +231,10 @@ void widget_set_visible(Widget* widget, bool visible) {
         return;
     }
     
-    widget->visible = visible;
+    if (widget->visible != visible) {
+        widget->visible = visible;
+        widget_add_damage(widget);
+    }
 }
 
 bool widget_is_visible(const Widget* widget) {
@@ -144,7 +250,10 @@ void widget_set_enabled(Widget* widget, bool enabled) {
         return;
     }
     
-    widget->enabled = enabled;
+    if (widget->enabled != enabled) {
+        widget->enabled = enabled;
+        widget_add_damage(widget);
+    }
 }
 
 bool widget_is_enabled(const Widget* widget) {
@@ -179,3 +288,62 @@ bool widget_contains_point(const Widget* widget, int x, int y) {
     return (x >= widget->x && x < widget->x + widget->width &&
             y >= widget->y && y < widget->y + widget->height);
 }
+
+void widget_invalidate(Widget* widget) {
+    if (!widget) {
+        return;
+    }
+
+    widget_add_damage(widget);
+}
+
+bool widget_is_dirty(const Widget* widget) {
+    if (!widget) {
+        return false;
+    }
+
+    return widget_has_damage(widget);
+}
+
+bool widget_take_damage(Widget* widget, int* x, int* y, int* width, int* height) {
+    if (!widget || !widget_has_damage(widget)) {
+        return false;
+    }
+
+    if (x) *x = widget->damage_x0;
+    if (y) *y = widget->damage_y0;
+    if (width) *width = widget->damage_x1 - widget->damage_x0;
+    if (height) *height = widget->damage_y1 - widget->damage_y0;
+    widget->dirty = false;
+    /* Takes the damage of every descendant along with it */
+    widget->taken_at = ++damage_clock;
+
+    return true;
+}
+
+void widget_set_parent(Widget* widget, Widget* parent) {
+    if (!widget || widget->parent == parent) {
+        return;
+    }
+
+    /* The area the widget covered changes in the old parent and the new one */
+    widget_add_damage(widget);
+    widget->parent = parent;
+    widget_add_damage(widget);
+}
+
+Widget* widget_get_parent(const Widget* widget) {
+    if (!widget) {
+        return NULL;
+    }
+
+    return widget->parent;
+}
+
+uint32_t widget_get_revision(const Widget* widget) {
+    if (!widget) {
+        return 0;
+    }
+
+    return widget->revision;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file container_layer_test.c
+ * @brief Checks that a container drawn through its layer matches drawing it directly
+ */
+
+#include "../include/ui_framework/widgets/container.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_WIDTH 64
+#define TEST_HEIGHT 48
+
+/* Builds a scene, draws it with its layers disabled and then enabled, and compares */
+typedef Widget* (*SceneBuilder)(Widget** layered, int* layered_count);
+
+static Widget* fill(int x, int y, int width, int height, Color color) {
+    Widget* widget = container_create(x, y, width, height);
+    container_set_background_color(widget, color);
+    return widget;
+}
+
+/* An opaque container with a translucent child */
+static Widget* scene_opaque_background(Widget** layered, int* layered_count) {
+    Widget* root = fill(8, 8, 40, 30, color_rgba(255, 0, 0, 255));
+    container_add_child(root, fill(12, 12, 20, 10, color_rgba(255, 255, 255, 128)));
+    layered[(*layered_count)++] = root;
+    return root;
+}
+
+/* Translucent children over a transparent container background */
+static Widget* scene_translucent_children(Widget** layered, int* layered_count) {
+    Widget* root = fill(4, 4, 50, 36, COLOR_TRANSPARENT);
+    container_add_child(root, fill(6, 6, 30, 20, color_rgba(255, 255, 255, 128)));
+    container_add_child(root, fill(20, 14, 30, 20, color_rgba(0, 200, 40, 77)));
+    layered[(*layered_count)++] = root;
+    return root;
+}
+
+/* A layered container inside another, both with translucent backgrounds */
+static Widget* scene_nested_layers(Widget** layered, int* layered_count) {
+    Widget* root = fill(2, 2, 56, 40, color_rgba(200, 30, 30, 102));
+    Widget* inner = fill(10, 10, 30, 24, color_rgba(20, 60, 220, 153));
+    container_add_child(inner, fill(14, 14, 20, 12, color_rgba(250, 250, 0, 90)));
+    container_add_child(root, inner);
+    container_add_child(root, fill(30, 20, 20, 16, color_rgba(0, 0, 0, 64)));
+    layered[(*layered_count)++] = root;
+    layered[(*layered_count)++] = inner;
+    return root;
+}
+
+static void destroy_tree(Widget* widget) {
+    while (container_get_child_count(widget) > 0) {
+        Widget* child = container_get_child(widget, 0);
+        container_remove_child(widget, child);
+        destroy_tree(child);
+    }
+    container_destroy(widget);
+}
+
+static Canvas* render(Widget* root) {
+    Canvas* canvas = canvas_create(TEST_WIDTH, TEST_HEIGHT);
+    canvas_clear(canvas, color_rgba(0, 0, 255, 255));
+    widget_draw(root, canvas);
+    return canvas;
+}
+
+/* Straight and premultiplied rounding may differ by one step per channel */
+static int compare(const char* name, const Canvas* direct, const Canvas* cached) {
+    const uint32_t* a = canvas_get_data(direct);
+    const uint32_t* b = canvas_get_data(cached);
+    for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++) {
+        for (int c = 0; c < 4; c++) {
+            int diff = (int)((a[i] >> (c * 8)) & 0xFF) - (int)((b[i] >> (c * 8)) & 0xFF);
+            if (diff < -1 || diff > 1) {
+                fprintf(stderr, "%s: pixel %d,%d is %08x directly but %08x through the layer\n",
+                        name, i % TEST_WIDTH, i / TEST_WIDTH, (unsigned)a[i], (unsigned)b[i]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int run_scene(const char* name, SceneBuilder build) {
+    Widget* layered[8];
+    int layered_count = 0;
+    Widget* root = build(layered, &layered_count);
+
+    Canvas* direct = render(root);
+    for (int i = 0; i < layered_count; i++) {
+        container_set_layer_enabled(layered[i], true);
+    }
+    Canvas* cached = render(root);
+    int failed = compare(name, direct, cached);
+
+    canvas_destroy(direct);
+    canvas_destroy(cached);
+    destroy_tree(root);
+    return failed;
+}
+
+int main(void) {
+    int failed = 0;
+    failed += run_scene("opaque background", scene_opaque_background);
+    failed += run_scene("translucent children", scene_translucent_children);
+    failed += run_scene("nested layers", scene_nested_layers);
+
+    /* Drawn directly this pixel is (255, 128, 128); the layer must not darken it */
+    Widget* layered[8];
+    int layered_count = 0;
+    Widget* root = scene_opaque_background(layered, &layered_count);
+    container_set_layer_enabled(root, true);
+    Canvas* canvas = render(root);
+    Color pixel = canvas_get_pixel(canvas, 15, 15);
+    if (pixel.r != 255 || pixel.g != 128 || pixel.b != 128 || pixel.a != 255) {
+        fprintf(stderr, "layered pixel is (%d, %d, %d, %d), expected (255, 128, 128, 255)\n",
+                pixel.r, pixel.g, pixel.b, pixel.a);
+        failed++;
+    }
+    canvas_destroy(canvas);
+    destroy_tree(root);
+
+    if (failed) {
+        return EXIT_FAILURE;
+    }
+    printf("container layers match direct drawing\n");
+    return EXIT_SUCCESS;
+}